@@ -40,6 +40,10 @@ struct ModelMetadata {
     QVariantMap customFields;
     QString thumbnailPath;
     QVariantMap meshStats;
+    QByteArray shapeDescriptor;  // ShapeDescriptor::toByteArray(); empty when the mesh was not read
+    QByteArray contentHash;      // ContentHash of the stored file; empty when not yet computed
+    QByteArray meshFingerprint;  // MeshFingerprint::toByteArray(); empty when the mesh was not read
+    quint64 thumbnailHash = 0;   // DuplicateClusterer::thumbnailHash(); 0 until a thumbnail is hashed
 
     ModelMetadata() = default;
     ModelMetadata(const QUuid& uuid) : id(uuid) {}
@@ -62,8 +66,11 @@ struct SearchResult {
     QString name;
     QString type; // "model" or "project"
     QStringList tags;
-    qreal relevance;
+    qreal relevance = 0.0;
     QString snippet;
+    qint64 fileSize = 0;   // models only
+    QString date;          // import date for models, creation date for projects
+    QString thumbnailPath;
 
     SearchResult() = default;
     SearchResult(const QUuid& uuid, const QString& name, const QString& type)
@@ -75,6 +82,7 @@ struct PerformanceMetrics {
     qint64 memoryUsageBytes;
     qint64 cpuUsagePercent;
     QString operationType;
+    QVariantMap details;  // Service-specific counters
 
     PerformanceMetrics() = default;
 };
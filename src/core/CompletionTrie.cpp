@@ -0,0 +1,365 @@
+#include "CompletionTrie.h"
+#include <QSet>
+#include <QStringView>
+#include <algorithm>
+#include <queue>
+
+CompletionTrie::CompletionTrie()
+{
+    m_nodes.append(Node());
+}
+
+void CompletionTrie::insert(const QString& value, int weight)
+{
+    if (value.isEmpty()) {
+        return;
+    }
+
+    weight = qMax(0, weight);
+
+    auto it = m_entryIds.constFind(value);
+    if (it != m_entryIds.constEnd()) {
+        // Only the cached subtree maxima along each key need refreshing
+        m_entries[it.value()].weight = weight;
+        for (const QString& key : keysFor(value)) {
+            QVector<int> path;
+            if (findPath(key, path)) {
+                m_nodes[path.last()].entriesSorted = false;
+                refreshPath(path);
+            }
+        }
+        return;
+    }
+
+    int entry;
+    if (!m_freeEntries.isEmpty()) {
+        entry = m_freeEntries.takeLast();
+        m_entries[entry] = {value, weight};
+    } else {
+        entry = m_entries.size();
+        m_entries.append({value, weight});
+    }
+    m_entryIds.insert(value, entry);
+
+    for (const QString& key : keysFor(value)) {
+        insertKey(key, entry);
+    }
+}
+
+void CompletionTrie::addWeight(const QString& value, int delta)
+{
+    int updated = weight(value) + delta;
+    if (updated <= 0) {
+        remove(value);
+    } else {
+        insert(value, updated);
+    }
+}
+
+void CompletionTrie::remove(const QString& value)
+{
+    auto it = m_entryIds.find(value);
+    if (it == m_entryIds.end()) {
+        return;
+    }
+
+    int entry = it.value();
+    m_entryIds.erase(it);
+
+    for (const QString& key : keysFor(value)) {
+        removeKey(key, entry);
+    }
+
+    m_entries[entry] = {QString(), 0};
+    m_freeEntries.append(entry);
+}
+
+void CompletionTrie::clear()
+{
+    m_nodes.clear();
+    m_nodes.append(Node());
+    m_entries.clear();
+    m_entryIds.clear();
+    m_freeEntries.clear();
+    m_freeNodes.clear();
+}
+
+bool CompletionTrie::contains(const QString& value) const
+{
+    return m_entryIds.contains(value);
+}
+
+int CompletionTrie::weight(const QString& value) const
+{
+    auto it = m_entryIds.constFind(value);
+    return it != m_entryIds.constEnd() ? m_entries[it.value()].weight : 0;
+}
+
+int CompletionTrie::size() const
+{
+    return m_entryIds.size();
+}
+
+qint64 CompletionTrie::memoryUsage() const
+{
+    qint64 usage = m_nodes.capacity() * static_cast<qint64>(sizeof(Node))
+                 + m_entries.capacity() * static_cast<qint64>(sizeof(Entry));
+
+    for (const Node& node : m_nodes) {
+        usage += node.label.size() * static_cast<qint64>(sizeof(QChar))
+               + (node.children.capacity() + node.entries.capacity()) * static_cast<qint64>(sizeof(int));
+    }
+    for (const Entry& entry : m_entries) {
+        usage += entry.value.size() * static_cast<qint64>(sizeof(QChar)) * 2;  // entry and id map
+    }
+
+    return usage;
+}
+
+QStringList CompletionTrie::complete(const QString& prefix, int maxCompletions) const
+{
+    QStringList completions;
+    if (maxCompletions <= 0) {
+        return completions;
+    }
+
+    // Walk down to the node whose subtree holds every key starting with prefix;
+    // the prefix may end part way along an edge
+    QString key = prefix.toLower();
+    int node = 0;
+    int position = 0;
+    while (position < key.size()) {
+        int next = -1;
+        for (int child : m_nodes[node].children) {
+            if (m_nodes[child].label.at(0) == key.at(position)) {
+                next = child;
+                break;
+            }
+        }
+        if (next < 0) {
+            return completions;
+        }
+
+        const QString& label = m_nodes[next].label;
+        int length = qMin(static_cast<int>(label.size()), static_cast<int>(key.size()) - position);
+        if (QStringView(label).left(length) != QStringView(key).mid(position, length)) {
+            return completions;
+        }
+
+        position += length;
+        node = next;
+    }
+
+    if (m_nodes[node].maxWeight < 0) {
+        return completions;
+    }
+
+    // Best-first over subtree maxima. A queued node with index -1 still has
+    // to be expanded; otherwise the item is that node's index-th heaviest
+    // value, and only its successor is queued when it is taken
+    struct Item {
+        int weight;
+        int node;
+        int index;
+        bool operator<(const Item& other) const { return weight < other.weight; }
+    };
+
+    std::priority_queue<Item> queue;
+    queue.push({m_nodes[node].maxWeight, node, -1});
+
+    QSet<int> emitted;
+    while (!queue.empty() && completions.size() < maxCompletions) {
+        Item item = queue.top();
+        queue.pop();
+
+        const Node& current = m_nodes[item.node];
+
+        if (item.index >= 0) {
+            int entry = current.entries[item.index];
+            if (!emitted.contains(entry)) {
+                emitted.insert(entry);
+                completions.append(m_entries[entry].value);
+            }
+            if (item.index + 1 < current.entries.size()) {
+                int next = current.entries[item.index + 1];
+                queue.push({m_entries[next].weight, item.node, item.index + 1});
+            }
+            continue;
+        }
+
+        if (!current.entries.isEmpty()) {
+            if (!current.entriesSorted) {
+                std::sort(current.entries.begin(), current.entries.end(), [this](int a, int b) {
+                    return m_entries[a].weight > m_entries[b].weight;
+                });
+                current.entriesSorted = true;
+            }
+            queue.push({m_entries[current.entries.first()].weight, item.node, 0});
+        }
+        for (int child : current.children) {
+            if (m_nodes[child].maxWeight >= 0) {
+                queue.push({m_nodes[child].maxWeight, child, -1});
+            }
+        }
+    }
+
+    return completions;
+}
+
+QStringList CompletionTrie::keysFor(const QString& value)
+{
+    QString lower = value.toLower();
+    QStringList keys = {lower};
+
+    for (int i = 1; i < lower.size(); ++i) {
+        if (!lower.at(i - 1).isLetterOrNumber() && lower.at(i).isLetterOrNumber()) {
+            keys.append(lower.mid(i));
+        }
+    }
+
+    keys.removeDuplicates();
+    return keys;
+}
+
+void CompletionTrie::insertKey(const QString& key, int entry)
+{
+    QVector<int> path = {0};
+    int node = 0;
+    int position = 0;
+
+    while (position < key.size()) {
+        int next = -1;
+        for (int child : m_nodes[node].children) {
+            if (m_nodes[child].label.at(0) == key.at(position)) {
+                next = child;
+                break;
+            }
+        }
+
+        if (next < 0) {
+            Node leaf;
+            leaf.label = key.mid(position);
+            next = allocateNode(leaf);
+            m_nodes[node].children.append(next);
+            path.append(next);
+            node = next;
+            break;
+        }
+
+        QString label = m_nodes[next].label;
+        int common = 0;
+        while (common < label.size() && position + common < key.size()
+               && label.at(common) == key.at(position + common)) {
+            ++common;
+        }
+
+        if (common < label.size()) {
+            // Split the edge where the key leaves it
+            Node middle;
+            middle.label = label.left(common);
+            middle.children = {next};
+            middle.maxWeight = m_nodes[next].maxWeight;
+            int split = allocateNode(middle);
+
+            m_nodes[next].label = label.mid(common);
+            QVector<int>& siblings = m_nodes[node].children;
+            siblings[siblings.indexOf(next)] = split;
+            next = split;
+        }
+
+        path.append(next);
+        node = next;
+        position += common;
+    }
+
+    if (!m_nodes[node].entries.contains(entry)) {
+        m_nodes[node].entries.append(entry);
+        m_nodes[node].entriesSorted = false;
+    }
+
+    refreshPath(path);
+}
+
+void CompletionTrie::removeKey(const QString& key, int entry)
+{
+    QVector<int> path;
+    if (!findPath(key, path)) {
+        return;
+    }
+
+    m_nodes[path.last()].entries.removeAll(entry);
+
+    // Detach nodes left with nothing below them; their arena slots are reused,
+    // so weights moving in and out of zero do not grow the arena
+    for (int i = path.size() - 1; i > 0; --i) {
+        const Node& node = m_nodes[path[i]];
+        if (!node.entries.isEmpty() || !node.children.isEmpty()) {
+            break;
+        }
+        m_nodes[path[i - 1]].children.removeAll(path[i]);
+        m_nodes[path[i]] = Node();
+        m_freeNodes.append(path[i]);
+        path.removeLast();
+    }
+
+    refreshPath(path);
+}
+
+bool CompletionTrie::findPath(const QString& key, QVector<int>& path) const
+{
+    path = {0};
+    int node = 0;
+    int position = 0;
+
+    while (position < key.size()) {
+        int next = -1;
+        for (int child : m_nodes[node].children) {
+            if (m_nodes[child].label.at(0) == key.at(position)) {
+                next = child;
+                break;
+            }
+        }
+        if (next < 0) {
+            return false;
+        }
+
+        const QString& label = m_nodes[next].label;
+        if (QStringView(key).mid(position, label.size()) != label) {
+            return false;
+        }
+
+        position += label.size();
+        node = next;
+        path.append(node);
+    }
+
+    return true;
+}
+
+int CompletionTrie::allocateNode(const Node& node)
+{
+    if (!m_freeNodes.isEmpty()) {
+        int slot = m_freeNodes.takeLast();
+        m_nodes[slot] = node;
+        return slot;
+    }
+
+    m_nodes.append(node);
+    return m_nodes.size() - 1;
+}
+
+void CompletionTrie::refreshPath(const QVector<int>& path)
+{
+    for (int i = path.size() - 1; i >= 0; --i) {
+        Node& node = m_nodes[path[i]];
+
+        int maxWeight = -1;
+        for (int entry : node.entries) {
+            maxWeight = qMax(maxWeight, m_entries[entry].weight);
+        }
+        for (int child : node.children) {
+            maxWeight = qMax(maxWeight, m_nodes[child].maxWeight);
+        }
+        node.maxWeight = maxWeight;
+    }
+}
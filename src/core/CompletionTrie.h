@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+/**
+ * @brief Weighted prefix completion over a compressed trie
+ *
+ * Each value is stored under its lowercased text and again from the start of
+ * every later word, so "spur gear" completes both "sp" and "ge". Chains of
+ * single-child nodes are merged into one edge label, and every node caches
+ * the highest weight in its subtree: a top-k lookup expands nodes best-first
+ * and stops after k values, without visiting the rest of the subtree.
+ */
+class CompletionTrie
+{
+public:
+    CompletionTrie();
+
+    // Add a value or replace its weight
+    void insert(const QString& value, int weight);
+
+    // Adjust a weight, adding the value when missing; values reaching zero or less are removed
+    void addWeight(const QString& value, int delta);
+
+    void remove(const QString& value);
+    void clear();
+
+    bool contains(const QString& value) const;
+    int weight(const QString& value) const;
+    int size() const;
+    qint64 memoryUsage() const;
+
+    // Up to maxCompletions values with a word starting with prefix, heaviest first
+    QStringList complete(const QString& prefix, int maxCompletions) const;
+
+private:
+    struct Node {
+        QString label;           // edge text from the parent
+        QVector<int> children;
+        int maxWeight = -1;      // heaviest value in the subtree, -1 when empty
+
+        // Values whose key ends here; sorted heaviest first on the next lookup
+        // after a change, so bulk updates do not pay for ordering
+        mutable QVector<int> entries;
+        mutable bool entriesSorted = true;
+    };
+
+    struct Entry {
+        QString value;
+        int weight;
+    };
+
+    static QStringList keysFor(const QString& value);
+
+    void insertKey(const QString& key, int entry);
+    void removeKey(const QString& key, int entry);
+    bool findPath(const QString& key, QVector<int>& path) const;
+    void refreshPath(const QVector<int>& path);
+    int allocateNode(const Node& node);
+
+    QVector<Node> m_nodes;           // node 0 is the root
+    QVector<Entry> m_entries;
+    QHash<QString, int> m_entryIds;  // value -> entry
+    QVector<int> m_freeEntries;
+    QVector<int> m_freeNodes;        // detached nodes, reused before the arena grows
+};
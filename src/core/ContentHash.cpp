@@ -0,0 +1,54 @@
+#include "ContentHash.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDebug>
+
+QByteArray ContentHash::ofFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot hash file:" << path << file.errorString();
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(ALGORITHM);
+    if (!hash.addData(&file)) {
+        qWarning() << "Failed to read file for hashing:" << path << file.errorString();
+        return QByteArray();
+    }
+    return hash.result();
+}
+
+QByteArray ContentHash::copyFile(const QString& source, const QString& destination)
+{
+    QFile in(source);
+    if (!in.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot read file to copy:" << source << in.errorString();
+        return QByteArray();
+    }
+
+    // QSaveFile only replaces the destination once every block is written
+    QSaveFile out(destination);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write file copy:" << destination << out.errorString();
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(ALGORITHM);
+    QByteArray block(BLOCK_SIZE, Qt::Uninitialized);
+    qint64 read;
+    while ((read = in.read(block.data(), BLOCK_SIZE)) > 0) {
+        hash.addData(QByteArrayView(block.constData(), read));
+        if (out.write(block.constData(), read) != read) {
+            qWarning() << "Failed to write file copy:" << destination << out.errorString();
+            out.cancelWriting();
+            return QByteArray();
+        }
+    }
+
+    if (read < 0 || !out.commit()) {
+        qWarning() << "Failed to copy file:" << source << "to" << destination;
+        return QByteArray();
+    }
+    return hash.result();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QCryptographicHash>
+
+/**
+ * @brief Streaming content hash of model files
+ *
+ * Files are read in fixed blocks, so memory stays constant whatever their
+ * size. copyFile() hashes the blocks as it writes them, so storing a new
+ * model costs a single read of the source. Two files with the same hash
+ * hold the same bytes.
+ */
+class ContentHash
+{
+public:
+    static const QCryptographicHash::Algorithm ALGORITHM = QCryptographicHash::Blake2b_256;
+    static const int BLOCK_SIZE = 1 << 20;
+
+    // Empty when the file cannot be read
+    static QByteArray ofFile(const QString& path);
+
+    // Copies source to destination and returns the hash of the bytes copied;
+    // on failure returns an empty hash and leaves destination untouched
+    static QByteArray copyFile(const QString& source, const QString& destination);
+};
@@ -0,0 +1,318 @@
+#include "DatabaseBackup.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QMutexLocker>
+#include <QDebug>
+
+DatabaseBackup::DatabaseBackup(const QString& sourcePath, const QString& destinationPath, QObject* parent)
+    : QThread(parent)
+    , m_sourcePath(sourcePath)
+    , m_destinationPath(destinationPath)
+    , m_writeInPlace(false)
+    , m_cancelRequested(false)
+    , m_succeeded(false)
+{
+    setObjectName("DatabaseBackup");
+}
+
+DatabaseBackup::~DatabaseBackup()
+{
+    cancel();
+    if (isRunning()) {
+        wait();
+    }
+}
+
+void DatabaseBackup::setWriteInPlace(bool inPlace)
+{
+    m_writeInPlace = inPlace;
+}
+
+void DatabaseBackup::cancel()
+{
+    m_cancelRequested = true;
+}
+
+bool DatabaseBackup::succeeded() const
+{
+    return m_succeeded;
+}
+
+QString DatabaseBackup::errorString() const
+{
+    QMutexLocker locker(&m_errorMutex);
+    return m_error;
+}
+
+QString DatabaseBackup::sourcePath() const
+{
+    return m_sourcePath;
+}
+
+QString DatabaseBackup::destinationPath() const
+{
+    return m_destinationPath;
+}
+
+void DatabaseBackup::run()
+{
+    execute();
+}
+
+bool DatabaseBackup::execute()
+{
+    m_succeeded = false;
+    m_cancelRequested = false;
+    setError(QString());
+
+    if (!QFileInfo::exists(m_sourcePath)) {
+        setError("Source database does not exist: " + m_sourcePath);
+        emit completed(false, errorString());
+        return false;
+    }
+
+    QString targetPath = m_writeInPlace ? m_destinationPath : m_destinationPath + ".partial";
+    QDir().mkpath(QFileInfo(targetPath).absolutePath());
+
+    // A leftover partial file belongs to an interrupted run and is started over
+    if (!m_writeInPlace && QFile::exists(targetPath)) {
+        QFile::remove(targetPath);
+    }
+
+    // A backup reads through a connection on the source; a restore writes
+    // through one on the live database, with the backup attached
+    QString connectionName = QString("database_backup_%1").arg(reinterpret_cast<quintptr>(this));
+    bool success = false;
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(m_writeInPlace ? m_destinationPath : m_sourcePath);
+        database.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+
+        if (!database.open()) {
+            setError("Failed to open database: " + database.lastError().text());
+        } else {
+            success = m_writeInPlace ? replaceContents(database) : copyToFile(database, targetPath);
+            database.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    // Only a complete copy replaces the previous backup
+    if (!m_writeInPlace) {
+        if (success) {
+            QFile::remove(m_destinationPath);
+            if (!QFile::rename(targetPath, m_destinationPath)) {
+                setError("Failed to move backup into place: " + m_destinationPath);
+                success = false;
+            }
+        }
+        if (!success) {
+            QFile::remove(targetPath);
+        }
+    }
+
+    if (!success) {
+        qWarning() << "Database backup failed:" << errorString();
+    }
+
+    m_succeeded = success;
+    emit completed(success, errorString());
+    return success;
+}
+
+bool DatabaseBackup::copyToFile(QSqlDatabase& database, const QString& targetPath)
+{
+    QSqlQuery query(database);
+
+    int totalPages = 0;
+    if (query.exec("PRAGMA page_count") && query.next()) {
+        totalPages = query.value(0).toInt();
+    }
+    query.finish();
+    emit progress(0, totalPages);
+
+    if (m_cancelRequested) {
+        setError("Backup cancelled");
+        return false;
+    }
+
+    // One statement in one read transaction: a consistent snapshot that
+    // does not hold up writers, and no torn WAL
+    query.prepare("VACUUM INTO ?");
+    query.addBindValue(targetPath);
+    if (!query.exec()) {
+        setError("Backup failed: " + query.lastError().text());
+        return false;
+    }
+
+    // The copy cannot be stopped part way; a late cancel discards it
+    if (m_cancelRequested) {
+        setError("Backup cancelled");
+        return false;
+    }
+
+    emit progress(totalPages, totalPages);
+    return true;
+}
+
+bool DatabaseBackup::replaceContents(QSqlDatabase& database)
+{
+    QSqlQuery query(database);
+
+    // Tables are dropped and refilled in any order, which foreign key
+    // enforcement would block; the pragma is ignored inside a transaction
+    query.exec("PRAGMA foreign_keys = OFF");
+
+    query.prepare("ATTACH DATABASE ? AS restore_source");
+    query.addBindValue(m_sourcePath);
+    if (!query.exec()) {
+        setError("Failed to open backup: " + query.lastError().text());
+        return false;
+    }
+
+    struct SchemaObject {
+        QString type;
+        QString name;
+        QString table;
+        QString sql;
+    };
+
+    // Virtual tables create their own shadow tables, which are then refilled
+    // like any other table so the virtual table needs no rebuild
+    QList<SchemaObject> objects;
+    QStringList virtualTables;
+    bool success = query.exec("SELECT type, name, tbl_name, sql FROM restore_source.sqlite_master "
+                              "WHERE sql IS NOT NULL AND name NOT LIKE 'sqlite\\_%' ESCAPE '\\' ORDER BY rowid");
+    if (!success) {
+        setError("Backup is not a readable database: " + query.lastError().text());
+    }
+    while (success && query.next()) {
+        SchemaObject object{query.value(0).toString(), query.value(1).toString(),
+                            query.value(2).toString(), query.value(3).toString()};
+        if (object.type == "table" && object.sql.startsWith("CREATE VIRTUAL TABLE", Qt::CaseInsensitive)) {
+            virtualTables << object.name;
+        }
+        objects.append(object);
+    }
+    query.finish();
+
+    auto isShadowTable = [&virtualTables](const QString& table) {
+        for (const QString& virtualTable : virtualTables) {
+            if (table.startsWith(virtualTable + "_")) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Triggers and views go before tables, virtual tables before their shadows
+    QStringList drops;
+    if (success) {
+        success = query.exec("SELECT type, name FROM main.sqlite_master "
+                             "WHERE type IN ('trigger', 'view', 'table') AND name NOT LIKE 'sqlite\\_%' ESCAPE '\\' "
+                             "ORDER BY CASE type WHEN 'trigger' THEN 0 WHEN 'view' THEN 1 ELSE 2 END, "
+                             "sql LIKE 'CREATE VIRTUAL%' DESC");
+        while (success && query.next()) {
+            drops << QString("DROP %1 IF EXISTS main.%2").arg(query.value(0).toString().toUpper(),
+                                                              quoted(query.value(1).toString()));
+        }
+        query.finish();
+        if (!success) {
+            setError("Failed to read database schema: " + query.lastError().text());
+        }
+    }
+
+    if (success && !database.transaction()) {
+        setError("Failed to start restore: " + database.lastError().text());
+        success = false;
+    }
+
+    if (success) {
+        success = execAll(database, drops);
+    }
+
+    // Tables first, then their contents, then indexes, views and triggers,
+    // so no trigger fires while rows are copied. Shadow tables may be listed
+    // before their virtual table, so every table exists before any is filled
+    QStringList copiedTables;
+    for (const SchemaObject& object : objects) {
+        if (success && object.type == "table" && !isShadowTable(object.name)) {
+            success = execAll(database, {object.sql});
+        }
+        if (object.type == "table" && !virtualTables.contains(object.name)) {
+            copiedTables << object.name;
+        }
+    }
+
+    for (int i = 0; success && i < copiedTables.size(); ++i) {
+        QStringList statements;
+        if (isShadowTable(copiedTables[i])) {
+            statements << "DELETE FROM main." + quoted(copiedTables[i]);
+        }
+        statements << QString("INSERT INTO main.%1 SELECT * FROM restore_source.%1").arg(quoted(copiedTables[i]));
+        success = execAll(database, statements);
+
+        if (success) {
+            emit progress(i + 1, copiedTables.size());
+        }
+        if (success && m_cancelRequested) {
+            setError("Restore cancelled");
+            success = false;
+        }
+    }
+
+    // AUTOINCREMENT counters live outside the tables they count for
+    if (success && query.exec("SELECT 1 FROM restore_source.sqlite_master WHERE name = 'sqlite_sequence'")
+        && query.next()) {
+        query.finish();
+        success = execAll(database, {"DELETE FROM main.sqlite_sequence",
+                                     "INSERT INTO main.sqlite_sequence SELECT * FROM restore_source.sqlite_sequence"});
+    }
+    query.finish();
+
+    for (const SchemaObject& object : objects) {
+        if (!success) {
+            break;
+        }
+        if (object.type != "table" && !isShadowTable(object.table)) {
+            success = execAll(database, {object.sql});
+        }
+    }
+
+    if (success && !database.commit()) {
+        setError("Failed to commit restore: " + database.lastError().text());
+        success = false;
+    }
+    if (!success) {
+        database.rollback();
+    }
+
+    query.exec("DETACH DATABASE restore_source");
+    return success;
+}
+
+bool DatabaseBackup::execAll(QSqlDatabase& database, const QStringList& statements)
+{
+    QSqlQuery query(database);
+    for (const QString& statement : statements) {
+        if (!query.exec(statement)) {
+            setError(QString("Restore failed: %1").arg(query.lastError().text()));
+            return false;
+        }
+    }
+    return true;
+}
+
+QString DatabaseBackup::quoted(const QString& identifier)
+{
+    return '"' + QString(identifier).replace('"', "\"\"") + '"';
+}
+
+void DatabaseBackup::setError(const QString& error)
+{
+    QMutexLocker locker(&m_errorMutex);
+    m_error = error;
+}
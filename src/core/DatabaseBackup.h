@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QThread>
+#include <QString>
+#include <QStringList>
+#include <QSqlDatabase>
+#include <QMutex>
+#include <atomic>
+
+/**
+ * @brief Online database copy through Qt's own SQLite
+ *
+ * Backups use VACUUM INTO on a connection of their own: the source is read
+ * inside one read transaction, so the copy is a consistent snapshot and,
+ * under WAL, writers are never blocked. A backup is written to a ".partial"
+ * file and only renamed over the destination once complete; an interrupted
+ * backup is started again from scratch. Restoring into a live database
+ * replaces its contents table by table inside one write transaction, so a
+ * failed restore leaves the database as it was. Everything goes through the
+ * QSQLITE driver, so only one SQLite library ever has the file open. Run it
+ * on its own thread with start(), or call execute() to copy on the calling
+ * thread.
+ */
+class DatabaseBackup : public QThread
+{
+    Q_OBJECT
+
+public:
+    DatabaseBackup(const QString& sourcePath, const QString& destinationPath, QObject* parent = nullptr);
+    virtual ~DatabaseBackup();
+
+    // Replace the contents of the existing destination (used to restore into a live database)
+    void setWriteInPlace(bool inPlace);
+
+    // Copy synchronously on the calling thread
+    bool execute();
+
+    // Stop at the next table, or discard a backup once its copy returns;
+    // the destination is left untouched
+    void cancel();
+
+    bool succeeded() const;
+    QString errorString() const;
+    QString sourcePath() const;
+    QString destinationPath() const;
+
+signals:
+    // Pages for a backup, tables for a restore
+    void progress(int copied, int total);
+    void completed(bool success, const QString& error);
+
+protected:
+    void run() override;
+
+private:
+    bool copyToFile(QSqlDatabase& database, const QString& targetPath);
+    bool replaceContents(QSqlDatabase& database);
+    bool execAll(QSqlDatabase& database, const QStringList& statements);
+    void setError(const QString& error);
+
+    static QString quoted(const QString& identifier);
+
+    QString m_sourcePath;
+    QString m_destinationPath;
+    bool m_writeInPlace;
+
+    std::atomic<bool> m_cancelRequested;
+    std::atomic<bool> m_succeeded;
+
+    mutable QMutex m_errorMutex;
+    QString m_error;
+};
@@ -0,0 +1,192 @@
+#include "DatabaseConnectionPool.h"
+#include <QSqlError>
+#include <QMutexLocker>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+
+DatabaseConnectionPool::DatabaseConnectionPool(const QString& databasePath)
+    : m_databasePath(databasePath)
+    , m_generation(1)
+    , m_connectionCounter(0)
+{
+}
+
+DatabaseConnectionPool::~DatabaseConnectionPool()
+{
+    if (m_threadHandles.hasLocalData()) {
+        m_threadHandles.setLocalData(nullptr);
+    }
+
+    // Threads still alive would only release theirs on exit, after the
+    // storage that tells them to is gone
+    QMutexLocker locker(&m_registryMutex);
+    qDeleteAll(m_ownedConnections);
+    m_ownedConnections.clear();
+}
+
+DatabaseConnectionPool::ThreadConnections::~ThreadConnections()
+{
+    // Statements must be finalized before their connection is removed, which
+    // closes it; this may run on another thread once the owner is idle, where
+    // QSqlDatabase::database() would refuse the connection
+    readerStatements.clear();
+    writerStatements.clear();
+
+    for (const QString& name : {readerName, writerName}) {
+        if (!name.isEmpty() && QSqlDatabase::contains(name)) {
+            QSqlDatabase::removeDatabase(name);
+        }
+    }
+}
+
+DatabaseConnectionPool::ThreadHandle::~ThreadHandle()
+{
+    pool->releaseConnections(connections);
+}
+
+QSqlDatabase DatabaseConnectionPool::connection(AccessMode mode)
+{
+    ThreadConnections* connections = threadConnections();
+    QString& name = (mode == AccessMode::ReadOnly) ? connections->readerName : connections->writerName;
+
+    if (name.isEmpty()) {
+        name = openConnection(mode);
+    }
+
+    return QSqlDatabase::database(name, false);
+}
+
+QSqlQuery& DatabaseConnectionPool::preparedQuery(AccessMode mode, const QString& sql)
+{
+    ThreadConnections* connections = threadConnections();
+    QHash<QString, QSqlQuery>& statements = (mode == AccessMode::ReadOnly)
+        ? connections->readerStatements
+        : connections->writerStatements;
+
+    auto it = statements.find(sql);
+    if (it == statements.end()) {
+        QSqlQuery query(connection(mode));
+        if (!query.prepare(sql)) {
+            qWarning() << "Failed to prepare statement:" << query.lastError().text();
+        }
+        it = statements.insert(sql, query);
+    }
+
+    return it.value();
+}
+
+QMutex* DatabaseConnectionPool::writeMutex()
+{
+    return &m_writeMutex;
+}
+
+void DatabaseConnectionPool::closeAll()
+{
+    // A connection may only be closed by the thread that opened it: this
+    // thread's go now, other threads notice the new generation and drop
+    // theirs on next use or when they exit
+    if (m_threadHandles.hasLocalData()) {
+        m_threadHandles.setLocalData(nullptr);
+    }
+    m_generation++;
+
+    QMutexLocker locker(&m_registryMutex);
+    m_connectionNames.erase(std::remove_if(m_connectionNames.begin(), m_connectionNames.end(),
+                                           [](const QString& name) { return !QSqlDatabase::contains(name); }),
+                            m_connectionNames.end());
+}
+
+QString DatabaseConnectionPool::databasePath() const
+{
+    return m_databasePath;
+}
+
+int DatabaseConnectionPool::openConnectionCount() const
+{
+    QMutexLocker locker(&m_registryMutex);
+
+    int count = 0;
+    for (const QString& name : m_connectionNames) {
+        if (QSqlDatabase::contains(name)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void DatabaseConnectionPool::configureConnection(QSqlDatabase& database, AccessMode mode)
+{
+    QSqlQuery pragmaQuery(database);
+    pragmaQuery.exec("PRAGMA foreign_keys = ON");
+    pragmaQuery.exec("PRAGMA synchronous = NORMAL");
+    pragmaQuery.exec("PRAGMA cache_size = 10000");
+    pragmaQuery.exec("PRAGMA temp_store = MEMORY");
+
+    if (mode == AccessMode::ReadWrite) {
+        // WAL is persistent in the file, but only a writable handle can switch it on
+        pragmaQuery.exec("PRAGMA journal_mode = WAL");
+    } else {
+        pragmaQuery.exec("PRAGMA query_only = ON");
+    }
+}
+
+DatabaseConnectionPool::ThreadConnections* DatabaseConnectionPool::threadConnections()
+{
+    ThreadHandle* handle = m_threadHandles.localData();
+
+    if (!handle || handle->connections->generation != m_generation) {
+        ThreadConnections* connections = new ThreadConnections;
+        connections->generation = m_generation;
+        {
+            QMutexLocker locker(&m_registryMutex);
+            m_ownedConnections.insert(connections);
+        }
+
+        handle = new ThreadHandle{this, connections};
+        m_threadHandles.setLocalData(handle);  // Releases the stale entry
+    }
+
+    return handle->connections;
+}
+
+void DatabaseConnectionPool::releaseConnections(ThreadConnections* connections)
+{
+    // The destructor may have released them already
+    {
+        QMutexLocker locker(&m_registryMutex);
+        if (!m_ownedConnections.remove(connections)) {
+            return;
+        }
+    }
+    delete connections;
+}
+
+QString DatabaseConnectionPool::openConnection(AccessMode mode)
+{
+    QString name = QString("pool_%1_%2_%3")
+                   .arg(mode == AccessMode::ReadOnly ? "reader" : "writer")
+                   .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()))
+                   .arg(++m_connectionCounter);
+
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", name);
+    database.setDatabaseName(m_databasePath);
+
+    // Readers and writers wait on each other instead of failing with SQLITE_BUSY
+    QString options = "QSQLITE_BUSY_TIMEOUT=5000";
+    if (mode == AccessMode::ReadOnly) {
+        options += ";QSQLITE_OPEN_READONLY";
+    }
+    database.setConnectOptions(options);
+
+    if (!database.open()) {
+        qCritical() << "Failed to open pooled connection:" << database.lastError().text();
+    } else {
+        configureConnection(database, mode);
+    }
+
+    QMutexLocker locker(&m_registryMutex);
+    m_connectionNames.append(name);
+
+    return name;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QThreadStorage>
+#include <atomic>
+
+/**
+ * @brief Per-thread SQLite connection pool
+ *
+ * Qt only allows a QSqlDatabase to be used from the thread that opened it, so
+ * the pool lazily opens one read-only and one read-write connection per thread
+ * and closes them when the thread exits. closeAll() retires the current set:
+ * each thread closes its own connections, so worker threads should be stopped
+ * or idle before the database file is replaced underneath them. The pool owns
+ * every thread's connections, and its destructor closes those of threads that
+ * are still alive, such as idle thread pool workers; they must not be running
+ * queries by then. Every connection gets the same WAL and pragma setup as the
+ * primary connection, and keeps its own prepared statement cache. Writers
+ * serialise on writeMutex() so only one connection mutates the database at a
+ * time while any number of readers proceed in parallel.
+ */
+class DatabaseConnectionPool
+{
+public:
+    enum class AccessMode {
+        ReadOnly,
+        ReadWrite
+    };
+
+    explicit DatabaseConnectionPool(const QString& databasePath);
+    ~DatabaseConnectionPool();
+
+    // Connection access for the calling thread
+    QSqlDatabase connection(AccessMode mode = AccessMode::ReadOnly);
+    QSqlQuery& preparedQuery(AccessMode mode, const QString& sql);
+    QMutex* writeMutex();
+
+    // Pool lifecycle
+    void closeAll();
+    QString databasePath() const;
+    int openConnectionCount() const;
+
+    // Pragmas shared by the primary connection and every pooled connection
+    static void configureConnection(QSqlDatabase& database, AccessMode mode);
+
+private:
+    struct ThreadConnections {
+        quint64 generation = 0;
+        QString readerName;
+        QString writerName;
+        QHash<QString, QSqlQuery> readerStatements;
+        QHash<QString, QSqlQuery> writerStatements;
+
+        ~ThreadConnections();
+    };
+
+    // Held in each thread's storage; hands the thread's connections back to
+    // the pool when the thread exits or moves to a new generation
+    struct ThreadHandle {
+        DatabaseConnectionPool* pool;
+        ThreadConnections* connections;
+
+        ~ThreadHandle();
+    };
+
+    ThreadConnections* threadConnections();
+    void releaseConnections(ThreadConnections* connections);
+    QString openConnection(AccessMode mode);
+
+    QString m_databasePath;
+
+    // Every thread's connections, and the names opened by any thread for
+    // openConnectionCount()
+    mutable QMutex m_registryMutex;
+    QSet<ThreadConnections*> m_ownedConnections;
+    QStringList m_connectionNames;
+
+    // Destroyed before the registry, so a thread exiting meanwhile still
+    // finds it; handles of threads outliving the storage are never run
+    QThreadStorage<ThreadHandle*> m_threadHandles;
+
+    // Bumped by closeAll() so threads drop connections from a previous session
+    std::atomic<quint64> m_generation;
+    std::atomic<quint64> m_connectionCounter;
+
+    QMutex m_writeMutex;
+};
@@ -1,18 +1,94 @@
 #include "DatabaseManager.h"
+#include "DatabaseConnectionPool.h"
+#include "DatabaseWriter.h"
+#include "DatabaseBackup.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
 #include <QFile>
+#include <QFileInfo>
 #include <QDir>
 #include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSet>
+#include <QMutexLocker>
+#include <QVersionNumber>
+#include <QRegularExpression>
 #include <QDebug>
 
 // Schema version for migrations
-const QString DatabaseManager::CURRENT_SCHEMA_VERSION = "1.0.0";
+const QString DatabaseManager::CURRENT_SCHEMA_VERSION = "1.9.0";
+
+// SQLite limits host parameters per statement (999 on older builds)
+static const int MAX_BOUND_PARAMETERS = 500;
+
+// Mesh statistics stored in typed, indexable columns; any other keys of
+// ModelMetadata::meshStats stay in the mesh_stats JSON column
+struct MeshStatsColumns {
+    QVariant vertexCount;
+    QVariant triangleCount;
+    QVariant boundsX;
+    QVariant boundsY;
+    QVariant boundsZ;
+    QVariant extra;
+};
+
+static MeshStatsColumns splitMeshStats(QVariantMap meshStats)
+{
+    MeshStatsColumns columns;
+    columns.vertexCount = meshStats.take("vertex_count");
+    columns.triangleCount = meshStats.take("triangle_count");
+
+    QVariantMap bounds = meshStats.take("bounds").toMap();
+    columns.boundsX = bounds.value("x");
+    columns.boundsY = bounds.value("y");
+    columns.boundsZ = bounds.value("z");
+
+    if (!meshStats.isEmpty()) {
+        columns.extra = QString::fromUtf8(QJsonDocument(QJsonObject::fromVariantMap(meshStats))
+                                          .toJson(QJsonDocument::Compact));
+    }
+
+    return columns;
+}
+
+// Columns a range filter may be pushed down to; all of them are indexed
+static const QStringList RANGE_COLUMNS = {
+    "file_size", "vertex_count", "triangle_count", "bounds_x", "bounds_y", "bounds_z", "import_date"
+};
+
+static QString rangeClause(const QVariantMap& ranges, QVariantList& bindValues)
+{
+    QStringList conditions;
+
+    for (auto it = ranges.begin(); it != ranges.end(); ++it) {
+        if (!RANGE_COLUMNS.contains(it.key())) {
+            qWarning() << "Ignoring range filter on unindexed column" << it.key();
+            continue;
+        }
+
+        QVariantMap range = it.value().toMap();
+        if (range.contains("min")) {
+            conditions << QString("models.%1 >= ?").arg(it.key());
+            bindValues << range.value("min");
+        }
+        if (range.contains("max")) {
+            conditions << QString("models.%1 <= ?").arg(it.key());
+            bindValues << range.value("max");
+        }
+    }
+
+    return conditions.isEmpty() ? QString() : conditions.join(" AND ");
+}
 
 DatabaseManager::DatabaseManager(QObject* parent)
     : QObject(parent)
     , m_isInitialized(false)
+    , m_connectionPool(nullptr)
+    , m_writer(nullptr)
+    , m_announcedChangeVersion(0)
 {
     m_database = QSqlDatabase::addDatabase("QSQLITE");
 }
@@ -50,31 +126,43 @@ bool DatabaseManager::initialize(const QString& databasePath)
     }
 
     // Enable foreign keys and WAL mode for better performance
-    QSqlQuery pragmaQuery(m_database);
-    pragmaQuery.exec("PRAGMA foreign_keys = ON");
-    pragmaQuery.exec("PRAGMA journal_mode = WAL");
-    pragmaQuery.exec("PRAGMA synchronous = NORMAL");
-    pragmaQuery.exec("PRAGMA cache_size = 10000");
-    pragmaQuery.exec("PRAGMA temp_store = MEMORY");
-
-    // Create tables and indexes
+    DatabaseConnectionPool::configureConnection(m_database, DatabaseConnectionPool::AccessMode::ReadWrite);
+
+    // Create tables, bring older schemas up to date, then build indexes
     if (!createTables()) {
         qCritical() << "Failed to create database tables";
         return false;
     }
 
-    if (!createIndexes()) {
-        qCritical() << "Failed to create database indexes";
+    // Migrations run before index creation so indexes can rely on migrated columns
+    if (!runMigrations()) {
+        qCritical() << "Failed to run database migrations";
         return false;
     }
 
-    // Run migrations if needed
-    if (!runMigrations()) {
-        qCritical() << "Failed to run database migrations";
+    if (!createIndexes()) {
+        qCritical() << "Failed to create database indexes";
         return false;
     }
 
+    // Worker threads get their own connections with the same setup
+    m_connectionPool = new DatabaseConnectionPool(dbPath);
+
+    // All mutations are applied by one writer thread in group commits
+    m_writer = new DatabaseWriter(m_connectionPool, this);
+    m_writer->start();
+
+    // Announce change log growth on this thread once each group has landed
+    connect(m_writer, &DatabaseWriter::groupCommitted, this, [this]() {
+        qint64 version = currentChangeVersion();
+        if (version > m_announcedChangeVersion) {
+            m_announcedChangeVersion = version;
+            emit changesAvailable(version);
+        }
+    });
+
     m_isInitialized = true;
+    m_announcedChangeVersion = currentChangeVersion();
     emit databaseInitialized();
 
     qInfo() << "Database initialized successfully:" << dbPath;
@@ -84,6 +172,13 @@ bool DatabaseManager::initialize(const QString& databasePath)
 void DatabaseManager::close()
 {
     if (m_isInitialized) {
+        // Commit queued writes before the writer's connection goes away
+        m_writer->stop();
+        delete m_writer;
+        m_writer = nullptr;
+
+        delete m_connectionPool;  // Finalizes pooled statements and removes their connections
+        m_connectionPool = nullptr;
         m_database.close();
         m_isInitialized = false;
         emit databaseClosed();
@@ -96,19 +191,346 @@ bool DatabaseManager::isInitialized() const
     return m_isInitialized;
 }
 
+ModelCursor DatabaseManager::openModelCursor(ModelCursor::Columns columns, int pageSize) const
+{
+    if (!m_isInitialized) {
+        return ModelCursor();
+    }
+    return ModelCursor(m_connectionPool, columns, pageSize);
+}
+
+ModelCursor DatabaseManager::openModelCursor(const QList<QUuid>& ids, ModelCursor::Columns columns) const
+{
+    if (!m_isInitialized) {
+        return ModelCursor();
+    }
+    return ModelCursor(m_connectionPool, ids, columns);
+}
+
+QList<ModelMetadata> DatabaseManager::getAllModels() const
+{
+    // Prefer openModelCursor() for large catalogues; this materialises everything
+    QList<ModelMetadata> models;
+    ModelCursor cursor = openModelCursor();
+    for (QList<ModelMetadata> page = cursor.nextPage(); !page.isEmpty(); page = cursor.nextPage()) {
+        models.append(page);
+    }
+    return models;
+}
+
+bool DatabaseManager::insertModel(const ModelMetadata& model)
+{
+    return waitForCommit(insertModelAsync(model));
+}
+
+bool DatabaseManager::updateModel(const ModelMetadata& model)
+{
+    return waitForCommit(updateModelAsync(model));
+}
+
+bool DatabaseManager::insertModelTags(const QUuid& modelId, const QStringList& tags)
+{
+    return waitForCommit(insertModelTagsAsync(modelId, tags));
+}
+
+bool DatabaseManager::saveSetting(const QString& key, const QVariant& value)
+{
+    return waitForCommit(saveSettingAsync(key, value));
+}
+
+bool DatabaseManager::insertModels(const QList<ModelMetadata>& models)
+{
+    return waitForCommit(insertModelsAsync(models));
+}
+
+bool DatabaseManager::upsertModels(const QList<ModelMetadata>& models)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot write models: database not initialized";
+        return false;
+    }
+
+    QFuture<bool> future = m_writer->enqueue(
+        [this, models]() {
+            return writeModelBatch(models, true) && writeModelTagBatch(models, true);
+        },
+        [this, models]() {
+            // Commit callbacks run on the writer thread; observers hear on ours
+            QMetaObject::invokeMethod(this, [this, models]() {
+                for (const ModelMetadata& model : models) {
+                    emit modelUpdated(model);
+                }
+            }, Qt::QueuedConnection);
+        });
+    return waitForCommit(future);
+}
+
+QFuture<bool> DatabaseManager::insertModelAsync(const ModelMetadata& model)
+{
+    return insertModelsAsync(QList<ModelMetadata>() << model);
+}
+
+QFuture<bool> DatabaseManager::insertModelsAsync(const QList<ModelMetadata>& models)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot write models: database not initialized";
+        return QtFuture::makeReadyFuture(false);
+    }
+
+    return m_writer->enqueue(
+        [this, models]() {
+            return writeModelBatch(models, false) && writeModelTagBatch(models, false);
+        },
+        [this, models]() {
+            QMetaObject::invokeMethod(this, [this, models]() {
+                for (const ModelMetadata& model : models) {
+                    emit modelInserted(model);
+                }
+            }, Qt::QueuedConnection);
+        });
+}
+
+QFuture<bool> DatabaseManager::updateModelAsync(const ModelMetadata& model)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot update model: database not initialized";
+        return QtFuture::makeReadyFuture(false);
+    }
+
+    QList<ModelMetadata> models = QList<ModelMetadata>() << model;
+    return m_writer->enqueue(
+        [this, models]() {
+            // writeModelBatch upserts; an update must not create the model
+            QSqlQuery& selectModel = preparedQuery("SELECT 1 FROM models WHERE uuid = ?");
+            selectModel.addBindValue(models.first().id.toRfc4122());
+            bool exists = selectModel.exec() && selectModel.next();
+            selectModel.finish();
+            if (!exists) {
+                qWarning() << "Cannot update unknown model" << models.first().id.toString();
+                return false;
+            }
+
+            return writeModelBatch(models, true) && writeModelTagBatch(models, true);
+        },
+        [this, model]() {
+            QMetaObject::invokeMethod(this, [this, model]() {
+                emit modelUpdated(model);
+            }, Qt::QueuedConnection);
+        });
+}
+
+QFuture<bool> DatabaseManager::insertModelTagsAsync(const QUuid& modelId, const QStringList& tags)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot write model tags: database not initialized";
+        return QtFuture::makeReadyFuture(false);
+    }
+
+    return m_writer->enqueue([this, modelId, tags]() {
+        ModelMetadata model(modelId);
+        model.tags = tags;
+
+        if (!writeModelTagBatch(QList<ModelMetadata>() << model, true)) {
+            return false;
+        }
+
+        // Keep the full-text mirror of the tag set current
+        QSqlQuery& updateTagsText = preparedQuery("UPDATE models SET tags_text = ? WHERE uuid = ?");
+        updateTagsText.addBindValue(tags.join(" "));
+        updateTagsText.addBindValue(modelId.toRfc4122());
+        if (!updateTagsText.exec()) {
+            qCritical() << "Failed to update model tag text:" << updateTagsText.lastError().text();
+            return false;
+        }
+
+        return true;
+    });
+}
+
+QFuture<bool> DatabaseManager::addModelTagsAsync(const QList<QUuid>& modelIds, const QStringList& tags)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot write model tags: database not initialized";
+        return QtFuture::makeReadyFuture(false);
+    }
+
+    return m_writer->enqueue([this, modelIds, tags]() {
+        return writeModelTagEdit(modelIds, tags, true);
+    });
+}
+
+QFuture<bool> DatabaseManager::removeModelTagsAsync(const QList<QUuid>& modelIds, const QStringList& tags)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot write model tags: database not initialized";
+        return QtFuture::makeReadyFuture(false);
+    }
+
+    return m_writer->enqueue([this, modelIds, tags]() {
+        return writeModelTagEdit(modelIds, tags, false);
+    });
+}
+
+QFuture<bool> DatabaseManager::saveSettingAsync(const QString& key, const QVariant& value)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot save setting: database not initialized";
+        return QtFuture::makeReadyFuture(false);
+    }
+
+    // Structured values are stored as JSON, scalars as plain text
+    QString serialized;
+    if (value.typeId() == QMetaType::QVariantMap) {
+        serialized = QString::fromUtf8(QJsonDocument(QJsonObject::fromVariantMap(value.toMap()))
+                                       .toJson(QJsonDocument::Compact));
+    } else if (value.typeId() == QMetaType::QVariantList || value.typeId() == QMetaType::QStringList) {
+        serialized = QString::fromUtf8(QJsonDocument(QJsonArray::fromVariantList(value.toList()))
+                                       .toJson(QJsonDocument::Compact));
+    } else {
+        serialized = value.toString();
+    }
+
+    return m_writer->enqueue([this, key, serialized]() {
+        QSqlQuery& upsertSetting = preparedQuery(
+            "INSERT INTO settings (key, value) VALUES (?, ?) "
+            "ON CONFLICT(key) DO UPDATE SET value = excluded.value, modified_date = CURRENT_TIMESTAMP");
+        upsertSetting.addBindValue(key);
+        upsertSetting.addBindValue(serialized);
+
+        if (!upsertSetting.exec()) {
+            qCritical() << "Failed to save setting:" << upsertSetting.lastError().text();
+            return false;
+        }
+
+        return true;
+    });
+}
+
+bool DatabaseManager::waitForCommit(QFuture<bool> future)
+{
+    // Synchronous callers should not sit out the group commit interval
+    if (m_writer) {
+        m_writer->flush();
+    }
+    return future.result();
+}
+
+bool DatabaseManager::backup(const QString& backupPath)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot back up: database not initialized";
+        return false;
+    }
+
+    // Queued writes belong in the backup
+    waitForCommit(m_writer->enqueue([]() { return true; }));
+
+    DatabaseBackup job(m_databasePath, backupPath);
+
+    if (!job.execute()) {
+        emit databaseError("Database Backup Failed", job.errorString());
+        return false;
+    }
+
+    qInfo() << "Database backed up to" << backupPath;
+    return true;
+}
+
+DatabaseBackup* DatabaseManager::startBackup(const QString& backupPath)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot back up: database not initialized";
+        return nullptr;
+    }
+
+    m_writer->flush();
+
+    DatabaseBackup* job = new DatabaseBackup(m_databasePath, backupPath, this);
+    connect(job, &DatabaseBackup::completed, this, [this, backupPath](bool success, const QString& error) {
+        if (!success) {
+            emit databaseError("Database Backup Failed", error);
+        }
+        emit backupCompleted(backupPath, success, error);
+    });
+    connect(job, &QThread::finished, job, &QObject::deleteLater);
+    job->start(QThread::LowPriority);
+
+    return job;
+}
+
+bool DatabaseManager::restore(const QString& backupPath)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot restore: database not initialized";
+        return false;
+    }
+
+    // Readers finish first, and the writer commits what is queued and stops;
+    // the contents are then replaced in one transaction of the job's own
+    emit aboutToRestore();
+    m_writer->stop();
+    m_database.close();
+
+    DatabaseBackup job(backupPath, m_databasePath);
+    job.setWriteInPlace(true);
+    bool success = job.execute();
+
+    if (!m_database.open()) {
+        qCritical() << "Failed to reopen database:" << m_database.lastError().text();
+        success = false;
+    } else {
+        DatabaseConnectionPool::configureConnection(m_database, DatabaseConnectionPool::AccessMode::ReadWrite);
+    }
+
+    // Cached statements describe the old schema, and the backup may predate
+    // it; the writer reopens its connection once the schema is current
+    m_connectionPool->closeAll();
+    bool upgraded = success && createTables() && runMigrations() && createIndexes();
+    m_writer->resume();
+
+    if (!success) {
+        emit databaseError("Database Restore Failed", job.errorString());
+        return false;
+    }
+
+    if (!upgraded) {
+        emit databaseError("Database Restore Failed", "Could not upgrade the restored schema");
+        return false;
+    }
+
+    m_announcedChangeVersion = currentChangeVersion();
+    emit databaseRestored();
+
+    qInfo() << "Database restored from" << backupPath;
+    return true;
+}
+
 bool DatabaseManager::createTables()
 {
     QSqlQuery query(m_database);
 
-    // Models table
+    // Models table; id is the rowid alias used by joins, uuid the 16-byte external key
     QString createModelsTable =
         "CREATE TABLE IF NOT EXISTS models ("
-        "id TEXT PRIMARY KEY,"
+        "id INTEGER PRIMARY KEY,"
+        "uuid BLOB NOT NULL UNIQUE,"
         "filename TEXT NOT NULL,"
         "file_size INTEGER NOT NULL,"
         "import_date TEXT NOT NULL,"
         "thumbnail_path TEXT,"
-        "mesh_stats TEXT,"  // JSON string
+        "vertex_count INTEGER,"
+        "triangle_count INTEGER,"
+        "bounds_x REAL,"
+        "bounds_y REAL,"
+        "bounds_z REAL,"
+        "mesh_stats TEXT,"  // JSON string for statistics without a typed column
+        "custom_fields TEXT,"  // JSON string
+        "tags_text TEXT,"  // Space separated tag names mirrored for full-text search
+        "format TEXT,"  // Lower-case file extension
+        "shape_descriptor BLOB,"  // ShapeDescriptor floats for similarity search
+        "content_hash BLOB,"  // ContentHash of the stored file, for duplicate detection
+        "mesh_fingerprint BLOB,"  // MeshFingerprint floats for near-duplicate detection
+        "thumbnail_hash INTEGER,"  // Perceptual hash of the thumbnail
         "created_date TEXT DEFAULT CURRENT_TIMESTAMP,"
         "modified_date TEXT DEFAULT CURRENT_TIMESTAMP"
         ")";
@@ -121,7 +543,8 @@ bool DatabaseManager::createTables()
     // Projects table
     QString createProjectsTable =
         "CREATE TABLE IF NOT EXISTS projects ("
-        "id TEXT PRIMARY KEY,"
+        "id INTEGER PRIMARY KEY,"
+        "uuid BLOB NOT NULL UNIQUE,"
         "name TEXT NOT NULL,"
         "description TEXT,"
         "created_date TEXT NOT NULL,"
@@ -137,13 +560,13 @@ bool DatabaseManager::createTables()
     // Project-Model relationships table
     QString createProjectModelsTable =
         "CREATE TABLE IF NOT EXISTS project_models ("
-        "project_id TEXT NOT NULL,"
-        "model_id TEXT NOT NULL,"
+        "project_id INTEGER NOT NULL,"
+        "model_id INTEGER NOT NULL,"
         "added_date TEXT DEFAULT CURRENT_TIMESTAMP,"
         "PRIMARY KEY (project_id, model_id),"
         "FOREIGN KEY (project_id) REFERENCES projects(id) ON DELETE CASCADE,"
         "FOREIGN KEY (model_id) REFERENCES models(id) ON DELETE CASCADE"
-        ")";
+        ") WITHOUT ROWID";
 
     if (!query.exec(createProjectModelsTable)) {
         qCritical() << "Failed to create project_models table:" << query.lastError().text();
@@ -168,13 +591,13 @@ bool DatabaseManager::createTables()
     // Model-Tag relationships table
     QString createModelTagsTable =
         "CREATE TABLE IF NOT EXISTS model_tags ("
-        "model_id TEXT NOT NULL,"
+        "model_id INTEGER NOT NULL,"
         "tag_id INTEGER NOT NULL,"
         "assigned_date TEXT DEFAULT CURRENT_TIMESTAMP,"
         "PRIMARY KEY (model_id, tag_id),"
         "FOREIGN KEY (model_id) REFERENCES models(id) ON DELETE CASCADE,"
         "FOREIGN KEY (tag_id) REFERENCES tags(id) ON DELETE CASCADE"
-        ")";
+        ") WITHOUT ROWID";
 
     if (!query.exec(createModelTagsTable)) {
         qCritical() << "Failed to create model_tags table:" << query.lastError().text();
@@ -184,19 +607,60 @@ bool DatabaseManager::createTables()
     // Project-Tag relationships table
     QString createProjectTagsTable =
         "CREATE TABLE IF NOT EXISTS project_tags ("
-        "project_id TEXT NOT NULL,"
+        "project_id INTEGER NOT NULL,"
         "tag_id INTEGER NOT NULL,"
         "assigned_date TEXT DEFAULT CURRENT_TIMESTAMP,"
         "PRIMARY KEY (project_id, tag_id),"
         "FOREIGN KEY (project_id) REFERENCES projects(id) ON DELETE CASCADE,"
         "FOREIGN KEY (tag_id) REFERENCES tags(id) ON DELETE CASCADE"
-        ")";
+        ") WITHOUT ROWID";
 
     if (!query.exec(createProjectTagsTable)) {
         qCritical() << "Failed to create project_tags table:" << query.lastError().text();
         return false;
     }
 
+    // Tag usage counters, maintained by triggers on model_tags
+    QString createTagUsageTable =
+        "CREATE TABLE IF NOT EXISTS tag_usage ("
+        "tag_id INTEGER PRIMARY KEY,"
+        "usage_count INTEGER NOT NULL DEFAULT 0,"
+        "FOREIGN KEY (tag_id) REFERENCES tags(id) ON DELETE CASCADE"
+        ")";
+
+    if (!query.exec(createTagUsageTable)) {
+        qCritical() << "Failed to create tag_usage table:" << query.lastError().text();
+        return false;
+    }
+
+    // Per-format model counts and bytes, maintained by triggers on models
+    QString createFormatStatsTable =
+        "CREATE TABLE IF NOT EXISTS model_format_stats ("
+        "format TEXT PRIMARY KEY,"
+        "model_count INTEGER NOT NULL DEFAULT 0,"
+        "total_bytes INTEGER NOT NULL DEFAULT 0"
+        ")";
+
+    if (!query.exec(createFormatStatsTable)) {
+        qCritical() << "Failed to create model_format_stats table:" << query.lastError().text();
+        return false;
+    }
+
+    // Change log feeding incremental consumers; AUTOINCREMENT keeps versions
+    // from being reused after the log is pruned
+    QString createChangeLogTable =
+        "CREATE TABLE IF NOT EXISTS change_log ("
+        "version INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "entity TEXT NOT NULL,"
+        "entity_id BLOB NOT NULL,"
+        "operation TEXT NOT NULL"
+        ")";
+
+    if (!query.exec(createChangeLogTable)) {
+        qCritical() << "Failed to create change_log table:" << query.lastError().text();
+        return false;
+    }
+
     // Settings table
     QString createSettingsTable =
         "CREATE TABLE IF NOT EXISTS settings ("
@@ -235,7 +699,11 @@ bool DatabaseManager::createIndexes()
         "CREATE INDEX IF NOT EXISTS idx_models_filename ON models(filename)",
         "CREATE INDEX IF NOT EXISTS idx_models_import_date ON models(import_date)",
         "CREATE INDEX IF NOT EXISTS idx_models_file_size ON models(file_size)",
-        "CREATE INDEX IF NOT EXISTS idx_models_created_date ON models(created_date)"
+        "CREATE INDEX IF NOT EXISTS idx_models_created_date ON models(created_date)",
+        "CREATE INDEX IF NOT EXISTS idx_models_vertex_count ON models(vertex_count)",
+        "CREATE INDEX IF NOT EXISTS idx_models_triangle_count ON models(triangle_count)",
+        "CREATE INDEX IF NOT EXISTS idx_models_bounds ON models(bounds_x, bounds_y, bounds_z)",
+        "CREATE INDEX IF NOT EXISTS idx_models_content_hash ON models(content_hash)"
     };
 
     for (const QString& indexQuery : modelIndexes) {
@@ -261,7 +729,8 @@ bool DatabaseManager::createIndexes()
     // Indexes for tags table
     QStringList tagIndexes = {
         "CREATE INDEX IF NOT EXISTS idx_tags_name ON tags(name)",
-        "CREATE INDEX IF NOT EXISTS idx_tags_category ON tags(category)"
+        "CREATE INDEX IF NOT EXISTS idx_tags_category ON tags(category)",
+        "CREATE INDEX IF NOT EXISTS idx_tag_usage_count ON tag_usage(usage_count)"
     };
 
     for (const QString& indexQuery : tagIndexes) {
@@ -271,84 +740,1007 @@ bool DatabaseManager::createIndexes()
         }
     }
 
-    // Full-text search index for models
+    // Reverse lookups on the join tables (tag -> models, model -> projects)
+    QStringList joinIndexes = {
+        "CREATE INDEX IF NOT EXISTS idx_model_tags_tag ON model_tags(tag_id, model_id)",
+        "CREATE INDEX IF NOT EXISTS idx_project_models_model ON project_models(model_id, project_id)",
+        "CREATE INDEX IF NOT EXISTS idx_project_tags_tag ON project_tags(tag_id, project_id)"
+    };
+
+    for (const QString& indexQuery : joinIndexes) {
+        if (!query.exec(indexQuery)) {
+            qCritical() << "Failed to create join index:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    // Full-text search index and materialised counters
+    return createFullTextIndex() && createCounterTriggers() && createChangeLogTriggers();
+}
+
+bool DatabaseManager::createFullTextIndex()
+{
+    QSqlQuery query(m_database);
+
+    // External-content index over models; rows are addressed by the integer model id
     QString ftsQuery = "CREATE VIRTUAL TABLE IF NOT EXISTS models_fts USING fts5("
-                      "filename, content=models, content_rowid=id)";
+                       "filename, tags_text, custom_fields,"
+                       "content='models', content_rowid='id',"
+                       "tokenize='unicode61 remove_diacritics 2')";
 
     if (!query.exec(ftsQuery)) {
         qCritical() << "Failed to create FTS table:" << query.lastError().text();
         return false;
     }
 
+    // Triggers keep the index in step with the content table
+    QStringList ftsTriggers = {
+        "CREATE TRIGGER IF NOT EXISTS models_fts_insert AFTER INSERT ON models BEGIN "
+        "INSERT INTO models_fts (rowid, filename, tags_text, custom_fields) "
+        "VALUES (new.id, new.filename, new.tags_text, new.custom_fields); "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS models_fts_delete AFTER DELETE ON models BEGIN "
+        "INSERT INTO models_fts (models_fts, rowid, filename, tags_text, custom_fields) "
+        "VALUES ('delete', old.id, old.filename, old.tags_text, old.custom_fields); "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS models_fts_update AFTER UPDATE OF filename, tags_text, custom_fields ON models BEGIN "
+        "INSERT INTO models_fts (models_fts, rowid, filename, tags_text, custom_fields) "
+        "VALUES ('delete', old.id, old.filename, old.tags_text, old.custom_fields); "
+        "INSERT INTO models_fts (rowid, filename, tags_text, custom_fields) "
+        "VALUES (new.id, new.filename, new.tags_text, new.custom_fields); "
+        "END"
+    };
+
+    for (const QString& triggerQuery : ftsTriggers) {
+        if (!query.exec(triggerQuery)) {
+            qCritical() << "Failed to create FTS trigger:" << query.lastError().text();
+            return false;
+        }
+    }
+
     return true;
 }
 
-bool DatabaseManager::runMigrations()
+bool DatabaseManager::createCounterTriggers()
 {
-    // Check current schema version
-    QSqlQuery versionQuery("SELECT version FROM schema_version ORDER BY applied_date DESC LIMIT 1", m_database);
-    QString currentVersion;
+    QSqlQuery query(m_database);
 
-    if (versionQuery.next()) {
-        currentVersion = versionQuery.value(0).toString();
-    }
+    // Counters move with every row change so reads never aggregate
+    QStringList counterTriggers = {
+        "CREATE TRIGGER IF NOT EXISTS tag_usage_insert AFTER INSERT ON model_tags BEGIN "
+        "INSERT INTO tag_usage (tag_id, usage_count) VALUES (new.tag_id, 1) "
+        "ON CONFLICT(tag_id) DO UPDATE SET usage_count = usage_count + 1; "
+        "END",
 
-    // If no version found, this is a new database
-    if (currentVersion.isEmpty()) {
-        // Insert initial schema version
-        QSqlQuery insertVersion(m_database);
-        insertVersion.prepare("INSERT INTO schema_version (version) VALUES (?)");
-        insertVersion.addBindValue(CURRENT_SCHEMA_VERSION);
+        "CREATE TRIGGER IF NOT EXISTS tag_usage_delete AFTER DELETE ON model_tags BEGIN "
+        "UPDATE tag_usage SET usage_count = usage_count - 1 WHERE tag_id = old.tag_id; "
+        "END",
 
-        if (!insertVersion.exec()) {
-            qCritical() << "Failed to insert schema version:" << insertVersion.lastError().text();
-            return false;
-        }
+        "CREATE TRIGGER IF NOT EXISTS model_stats_insert AFTER INSERT ON models BEGIN "
+        "INSERT INTO model_format_stats (format, model_count, total_bytes) "
+        "VALUES (COALESCE(new.format, ''), 1, new.file_size) "
+        "ON CONFLICT(format) DO UPDATE SET model_count = model_count + 1, "
+        "total_bytes = total_bytes + excluded.total_bytes; "
+        "END",
 
-        return true;
-    }
+        "CREATE TRIGGER IF NOT EXISTS model_stats_delete AFTER DELETE ON models BEGIN "
+        "UPDATE model_format_stats SET model_count = model_count - 1, total_bytes = total_bytes - old.file_size "
+        "WHERE format = COALESCE(old.format, ''); "
+        "END",
 
-    // Check if migration is needed
-    if (currentVersion == CURRENT_SCHEMA_VERSION) {
-        return true;  // No migration needed
+        "CREATE TRIGGER IF NOT EXISTS model_stats_update AFTER UPDATE OF format, file_size ON models BEGIN "
+        "UPDATE model_format_stats SET model_count = model_count - 1, total_bytes = total_bytes - old.file_size "
+        "WHERE format = COALESCE(old.format, ''); "
+        "INSERT INTO model_format_stats (format, model_count, total_bytes) "
+        "VALUES (COALESCE(new.format, ''), 1, new.file_size) "
+        "ON CONFLICT(format) DO UPDATE SET model_count = model_count + 1, "
+        "total_bytes = total_bytes + excluded.total_bytes; "
+        "END"
+    };
+
+    for (const QString& triggerQuery : counterTriggers) {
+        if (!query.exec(triggerQuery)) {
+            qCritical() << "Failed to create counter trigger:" << query.lastError().text();
+            return false;
+        }
     }
 
-    // Run migrations from current version to target version
-    return migrateFromVersion(currentVersion);
+    return true;
 }
 
-bool DatabaseManager::migrateFromVersion(const QString& fromVersion)
+bool DatabaseManager::createChangeLogTriggers()
 {
-    // For now, we only support the initial version
-    // Future versions would implement migration logic here
+    QSqlQuery query(m_database);
 
-    qInfo() << "Migrating database from version" << fromVersion << "to" << CURRENT_SCHEMA_VERSION;
+    // Tag changes reach the log through the models.tags_text update that
+    // accompanies every tag write; project membership and tags are logged
+    // as updates of the owning project. Updates are only logged for the
+    // columns the search index reads, so derived data such as hashes and
+    // fingerprints can be filled in without re-indexing
+    QHash<QString, QString> indexedColumns;
+    indexedColumns["model"] = "filename, file_size, import_date, thumbnail_path, tags_text, custom_fields, "
+                              "shape_descriptor";
+    indexedColumns["project"] = "name, description, created_date";
 
-    // Update schema version
-    QSqlQuery updateVersion(m_database);
-    updateVersion.prepare("UPDATE schema_version SET version = ?, applied_date = CURRENT_TIMESTAMP WHERE version = ?");
-    updateVersion.addBindValue(CURRENT_SCHEMA_VERSION);
-    updateVersion.addBindValue(fromVersion);
+    QStringList changeTriggers;
+    for (const QString& entity : {QString("model"), QString("project")}) {
+        QString table = entity + "s";
+        changeTriggers
+            << QString("CREATE TRIGGER IF NOT EXISTS %1_log_insert AFTER INSERT ON %1 BEGIN "
+                       "INSERT INTO change_log (entity, entity_id, operation) VALUES ('%2', new.uuid, 'insert'); "
+                       "END").arg(table, entity)
+            << QString("CREATE TRIGGER IF NOT EXISTS %1_log_update AFTER UPDATE OF %3 ON %1 BEGIN "
+                       "INSERT INTO change_log (entity, entity_id, operation) VALUES ('%2', new.uuid, 'update'); "
+                       "END").arg(table, entity, indexedColumns[entity])
+            << QString("CREATE TRIGGER IF NOT EXISTS %1_log_delete AFTER DELETE ON %1 BEGIN "
+                       "INSERT INTO change_log (entity, entity_id, operation) VALUES ('%2', old.uuid, 'delete'); "
+                       "END").arg(table, entity);
+    }
 
-    if (!updateVersion.exec()) {
-        qCritical() << "Failed to update schema version:" << updateVersion.lastError().text();
-        return false;
+    for (const QString& table : {QString("project_models"), QString("project_tags")}) {
+        for (const QString& row : {QString("new"), QString("old")}) {
+            changeTriggers
+                << QString("CREATE TRIGGER IF NOT EXISTS %1_log_%2 AFTER %3 ON %1 BEGIN "
+                           "INSERT INTO change_log (entity, entity_id, operation) "
+                           "SELECT 'project', uuid, 'update' FROM projects WHERE id = %4.project_id; "
+                           "END").arg(table, row == "new" ? "insert" : "delete",
+                                      row == "new" ? "INSERT" : "DELETE", row);
+        }
+    }
+
+    for (const QString& triggerQuery : changeTriggers) {
+        if (!query.exec(triggerQuery)) {
+            qCritical() << "Failed to create change log trigger:" << query.lastError().text();
+            return false;
+        }
     }
 
     return true;
 }
 
-QString DatabaseManager::sanitizeString(const QString& input) const
+qint64 DatabaseManager::currentChangeVersion() const
 {
-    QString sanitized = input;
-    sanitized.replace("\"", "\"\"");  // Escape double quotes
-    sanitized.replace("'", "''");    // Escape single quotes
-    return sanitized;
+    if (!m_isInitialized) {
+        return 0;
+    }
+
+    // sqlite_sequence survives pruning, unlike MAX(version) over an emptied log
+    QSqlQuery& query = m_connectionPool->preparedQuery(
+        DatabaseConnectionPool::AccessMode::ReadOnly,
+        "SELECT seq FROM sqlite_sequence WHERE name = 'change_log'");
+
+    qint64 version = 0;
+    if (query.exec() && query.next()) {
+        version = query.value(0).toLongLong();
+    }
+    query.finish();
+
+    return version;
 }
 
-QVariantMap DatabaseManager::modelToVariantMap(const ModelMetadata& model) const
+qint64 DatabaseManager::oldestChangeVersion() const
 {
-    QVariantMap map;
+    if (!m_isInitialized) {
+        return 0;
+    }
+
+    QSqlQuery& query = m_connectionPool->preparedQuery(
+        DatabaseConnectionPool::AccessMode::ReadOnly,
+        "SELECT MIN(version) FROM change_log");
+
+    qint64 version = 0;
+    if (query.exec() && query.next()) {
+        version = query.value(0).toLongLong();
+    }
+    query.finish();
+
+    return version;
+}
+
+QList<DatabaseManager::Change> DatabaseManager::changesSince(qint64 version, int limit) const
+{
+    QList<Change> changes;
+
+    if (!m_isInitialized) {
+        return changes;
+    }
+
+    QSqlQuery& query = m_connectionPool->preparedQuery(
+        DatabaseConnectionPool::AccessMode::ReadOnly,
+        "SELECT version, entity, entity_id, operation FROM change_log "
+        "WHERE version > ? ORDER BY version LIMIT ?");
+    query.addBindValue(version);
+    query.addBindValue(limit);
+
+    if (!query.exec()) {
+        qWarning() << "Failed to read change log:" << query.lastError().text();
+        return changes;
+    }
+
+    while (query.next()) {
+        Change change;
+        change.version = query.value(0).toLongLong();
+        change.entity = query.value(1).toString();
+        change.id = QUuid::fromRfc4122(query.value(2).toByteArray());
+        change.operation = query.value(3).toString();
+        changes.append(change);
+    }
+    query.finish();
+
+    return changes;
+}
+
+bool DatabaseManager::pruneChangeLog(qint64 upToVersion)
+{
+    if (!m_isInitialized) {
+        return false;
+    }
+
+    return waitForCommit(m_writer->enqueue([this, upToVersion]() {
+        QSqlQuery& prune = preparedQuery("DELETE FROM change_log WHERE version <= ?");
+        prune.addBindValue(upToVersion);
+
+        if (!prune.exec()) {
+            qCritical() << "Failed to prune change log:" << prune.lastError().text();
+            return false;
+        }
+
+        return true;
+    }));
+}
+
+QMap<QString, int> DatabaseManager::getTagUsageCounts() const
+{
+    QMap<QString, int> counts;
+
+    if (!m_isInitialized) {
+        return counts;
+    }
+
+    QSqlQuery& query = m_connectionPool->preparedQuery(
+        DatabaseConnectionPool::AccessMode::ReadOnly,
+        "SELECT tags.name, tag_usage.usage_count FROM tag_usage "
+        "JOIN tags ON tags.id = tag_usage.tag_id "
+        "WHERE tag_usage.usage_count > 0");
+
+    if (!query.exec()) {
+        qWarning() << "Failed to read tag usage:" << query.lastError().text();
+        return counts;
+    }
+
+    while (query.next()) {
+        counts.insert(query.value(0).toString(), query.value(1).toInt());
+    }
+    query.finish();
+
+    return counts;
+}
+
+QStringList DatabaseManager::getPopularTags(int maxTags) const
+{
+    QStringList tags;
+
+    if (!m_isInitialized) {
+        return tags;
+    }
+
+    QSqlQuery& query = m_connectionPool->preparedQuery(
+        DatabaseConnectionPool::AccessMode::ReadOnly,
+        "SELECT tags.name FROM tag_usage "
+        "JOIN tags ON tags.id = tag_usage.tag_id "
+        "WHERE tag_usage.usage_count > 0 "
+        "ORDER BY tag_usage.usage_count DESC, tags.name "
+        "LIMIT ?");
+    query.addBindValue(maxTags);
+
+    if (!query.exec()) {
+        qWarning() << "Failed to read popular tags:" << query.lastError().text();
+        return tags;
+    }
+
+    while (query.next()) {
+        tags.append(query.value(0).toString());
+    }
+    query.finish();
+
+    return tags;
+}
+
+QVariantMap DatabaseManager::getModelStatistics() const
+{
+    QVariantMap stats;
+    qint64 totalModels = 0;
+    qint64 totalSize = 0;
+    QVariantMap formatStats;
+
+    if (m_isInitialized) {
+        // One row per format, so this stays constant-time as the catalogue grows
+        QSqlQuery& query = m_connectionPool->preparedQuery(
+            DatabaseConnectionPool::AccessMode::ReadOnly,
+            "SELECT format, model_count, total_bytes FROM model_format_stats WHERE model_count > 0");
+
+        if (query.exec()) {
+            while (query.next()) {
+                qint64 count = query.value(1).toLongLong();
+                formatStats[query.value(0).toString()] = count;
+                totalModels += count;
+                totalSize += query.value(2).toLongLong();
+            }
+            query.finish();
+        } else {
+            qWarning() << "Failed to read model statistics:" << query.lastError().text();
+        }
+    }
+
+    stats["total_models"] = totalModels;
+    stats["total_size"] = totalSize;
+    stats["format_distribution"] = formatStats;
+
+    return stats;
+}
+
+QList<QUuid> DatabaseManager::fullTextSearch(const QString& query, int limit, const QVariantMap& ranges) const
+{
+    QList<QUuid> ids;
+
+    // Quote every term so user input cannot inject FTS5 operators; the
+    // trailing * turns each term into a prefix match for type-ahead
+    QStringList terms;
+    for (const QString& term : query.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts)) {
+        QString escaped = term;
+        escaped.replace("\"", "\"\"");
+        terms << QString("\"%1\"*").arg(escaped);
+    }
+
+    if (terms.isEmpty()) {
+        return ids;
+    }
+
+    if (!m_isInitialized) {
+        return ids;
+    }
+
+    QVariantList rangeValues;
+    QString rangeCondition = rangeClause(ranges, rangeValues);
+
+    // Column weights favour filename over tags over custom fields
+    QSqlQuery& ftsQuery = m_connectionPool->preparedQuery(
+        DatabaseConnectionPool::AccessMode::ReadOnly,
+        QString("SELECT models.uuid FROM models_fts "
+                "JOIN models ON models.id = models_fts.rowid "
+                "WHERE models_fts MATCH ? %1"
+                "ORDER BY bm25(models_fts, 10.0, 5.0, 1.0) "
+                "LIMIT ?").arg(rangeCondition.isEmpty() ? QString() : "AND " + rangeCondition + " "));
+    ftsQuery.addBindValue(terms.join(" "));
+    for (const QVariant& value : rangeValues) {
+        ftsQuery.addBindValue(value);
+    }
+    ftsQuery.addBindValue(limit);
+
+    if (!ftsQuery.exec()) {
+        qWarning() << "Full-text search failed:" << ftsQuery.lastError().text();
+        return ids;
+    }
+
+    while (ftsQuery.next()) {
+        ids.append(QUuid::fromRfc4122(ftsQuery.value(0).toByteArray()));
+    }
+    ftsQuery.finish();
+
+    return ids;
+}
+
+QList<QUuid> DatabaseManager::findModelsInRanges(const QVariantMap& ranges, int limit) const
+{
+    QList<QUuid> ids;
+
+    if (!m_isInitialized) {
+        return ids;
+    }
+
+    QVariantList rangeValues;
+    QString rangeCondition = rangeClause(ranges, rangeValues);
+
+    QSqlQuery& rangeQuery = m_connectionPool->preparedQuery(
+        DatabaseConnectionPool::AccessMode::ReadOnly,
+        QString("SELECT models.uuid FROM models %1LIMIT ?")
+        .arg(rangeCondition.isEmpty() ? QString() : "WHERE " + rangeCondition + " "));
+    for (const QVariant& value : rangeValues) {
+        rangeQuery.addBindValue(value);
+    }
+    rangeQuery.addBindValue(limit);
+
+    if (!rangeQuery.exec()) {
+        qWarning() << "Range query failed:" << rangeQuery.lastError().text();
+        return ids;
+    }
+
+    while (rangeQuery.next()) {
+        ids.append(QUuid::fromRfc4122(rangeQuery.value(0).toByteArray()));
+    }
+    rangeQuery.finish();
+
+    return ids;
+}
+
+QHash<QUuid, QByteArray> DatabaseManager::getContentHashesBySize(qint64 fileSize) const
+{
+    QHash<QUuid, QByteArray> hashes;
+
+    if (!m_isInitialized) {
+        return hashes;
+    }
+
+    QSqlQuery& sizeQuery = m_connectionPool->preparedQuery(
+        DatabaseConnectionPool::AccessMode::ReadOnly,
+        "SELECT uuid, content_hash FROM models WHERE file_size = ?");
+    sizeQuery.addBindValue(fileSize);
+
+    if (!sizeQuery.exec()) {
+        qWarning() << "Content hash lookup failed:" << sizeQuery.lastError().text();
+        return hashes;
+    }
+
+    while (sizeQuery.next()) {
+        hashes.insert(QUuid::fromRfc4122(sizeQuery.value(0).toByteArray()), sizeQuery.value(1).toByteArray());
+    }
+    sizeQuery.finish();
+
+    return hashes;
+}
+
+bool DatabaseManager::setContentHash(const QUuid& id, const QByteArray& contentHash)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot set content hash: database not initialized";
+        return false;
+    }
+
+    return waitForCommit(m_writer->enqueue([this, id, contentHash]() {
+        QSqlQuery& updateHash = preparedQuery("UPDATE models SET content_hash = ? WHERE uuid = ?");
+        updateHash.addBindValue(contentHash);
+        updateHash.addBindValue(id.toRfc4122());
+
+        if (!updateHash.exec()) {
+            qCritical() << "Failed to set content hash:" << updateHash.lastError().text();
+            return false;
+        }
+        return true;
+    }));
+}
+
+QFuture<bool> DatabaseManager::setThumbnailHashesAsync(const QHash<QUuid, quint64>& thumbnailHashes)
+{
+    if (!m_isInitialized) {
+        qWarning() << "Cannot set thumbnail hashes: database not initialized";
+        return QtFuture::makeReadyFuture(false);
+    }
+
+    QVariantList hashes, ids;
+    for (auto it = thumbnailHashes.constBegin(); it != thumbnailHashes.constEnd(); ++it) {
+        hashes << (it.value() == 0 ? QVariant() : QVariant(static_cast<qint64>(it.value())));
+        ids << it.key().toRfc4122();
+    }
+
+    // Derived data: the column is not logged, so no re-indexing follows
+    return m_writer->enqueue([this, hashes, ids]() {
+        QSqlQuery& updateHashes = preparedQuery("UPDATE models SET thumbnail_hash = ? WHERE uuid = ?");
+        updateHashes.addBindValue(hashes);
+        updateHashes.addBindValue(ids);
+
+        if (!updateHashes.execBatch()) {
+            qCritical() << "Failed to set thumbnail hashes:" << updateHashes.lastError().text();
+            return false;
+        }
+        return true;
+    });
+}
+
+bool DatabaseManager::runMigrations()
+{
+    // Check current schema version
+    QSqlQuery versionQuery("SELECT version FROM schema_version ORDER BY applied_date DESC LIMIT 1", m_database);
+    QString currentVersion;
+
+    if (versionQuery.next()) {
+        currentVersion = versionQuery.value(0).toString();
+    }
+
+    // If no version found, this is a new database
+    if (currentVersion.isEmpty()) {
+        // Insert initial schema version
+        QSqlQuery insertVersion(m_database);
+        insertVersion.prepare("INSERT INTO schema_version (version) VALUES (?)");
+        insertVersion.addBindValue(CURRENT_SCHEMA_VERSION);
+
+        if (!insertVersion.exec()) {
+            qCritical() << "Failed to insert schema version:" << insertVersion.lastError().text();
+            return false;
+        }
+
+        return true;
+    }
+
+    // Check if migration is needed
+    if (currentVersion == CURRENT_SCHEMA_VERSION) {
+        return true;  // No migration needed
+    }
+
+    // Run migrations from current version to target version
+    return migrateFromVersion(currentVersion);
+}
+
+bool DatabaseManager::migrateFromVersion(const QString& fromVersion)
+{
+    qInfo() << "Migrating database from version" << fromVersion << "to" << CURRENT_SCHEMA_VERSION;
+
+    QVersionNumber version = QVersionNumber::fromString(fromVersion);
+    QSqlQuery query(m_database);
+
+    // Steps commit on their own, so each is recorded as soon as it is done;
+    // a run that fails or is interrupted resumes after the last finished step
+    QString recordedVersion = fromVersion;
+    auto stepDone = [this, &recordedVersion](const QString& stepVersion) {
+        if (!recordSchemaVersion(recordedVersion, stepVersion)) {
+            return false;
+        }
+        recordedVersion = stepVersion;
+        return true;
+    };
+
+    // 1.1.0: searchable columns and a working external-content FTS index.
+    // A run interrupted after an ALTER leaves the column behind, so each one
+    // is only added when missing
+    if (version < QVersionNumber(1, 1, 0)) {
+        QStringList statements;
+        for (const QString& column : {QString("custom_fields TEXT"), QString("tags_text TEXT")}) {
+            if (!hasColumn("models", column.section(' ', 0, 0))) {
+                statements << "ALTER TABLE models ADD COLUMN " + column;
+            }
+        }
+        statements << "UPDATE models SET tags_text = ("
+                      "SELECT group_concat(tags.name, ' ') FROM model_tags "
+                      "JOIN tags ON tags.id = model_tags.tag_id "
+                      "WHERE model_tags.model_id = models.id)";
+
+        for (const QString& statement : statements) {
+            if (!query.exec(statement)) {
+                qCritical() << "Failed to migrate to 1.1.0:" << query.lastError().text();
+                return false;
+            }
+        }
+
+        if (!stepDone("1.1.0")) {
+            return false;
+        }
+    }
+
+    // 1.2.0: integer rowid keys for joins, UUIDs stored as 16-byte blobs.
+    // The rekeying commits before the version is recorded, so tables that
+    // already have their uuid column are not rekeyed a second time
+    if (version < QVersionNumber(1, 2, 0)) {
+        if (!hasColumn("models", "uuid") && !migrateToIntegerKeys()) {
+            return false;
+        }
+
+        // The index is keyed by the new integer ids, so build it from scratch
+        if (!createFullTextIndex() ||
+            !query.exec("INSERT INTO models_fts (models_fts) VALUES ('rebuild')")) {
+            qCritical() << "Failed to rebuild full-text index:" << query.lastError().text();
+            return false;
+        }
+
+        if (!stepDone("1.2.0")) {
+            return false;
+        }
+    }
+
+    // 1.3.0: trigger-maintained tag usage and per-format counters
+    if (version < QVersionNumber(1, 3, 0)) {
+        if (!migrateToCounterTables() || !stepDone("1.3.0")) {
+            return false;
+        }
+    }
+
+    // 1.4.0: typed, indexed mesh statistics columns
+    if (version < QVersionNumber(1, 4, 0)) {
+        if (!migrateToTypedMeshStats() || !stepDone("1.4.0")) {
+            return false;
+        }
+    }
+
+    // 1.5.0: change_log starts empty; its table and triggers come with the schema
+
+    // 1.6.0: shape descriptors; existing models get one when next imported
+    if (version < QVersionNumber(1, 6, 0)) {
+        if (!hasColumn("models", "shape_descriptor") &&
+            !query.exec("ALTER TABLE models ADD COLUMN shape_descriptor BLOB")) {
+            qCritical() << "Failed to migrate to 1.6.0:" << query.lastError().text();
+            return false;
+        }
+        if (!stepDone("1.6.0")) {
+            return false;
+        }
+    }
+
+    // 1.7.0: content hashes; existing models are hashed when a file of the same size is imported
+    if (version < QVersionNumber(1, 7, 0)) {
+        if (!hasColumn("models", "content_hash") &&
+            !query.exec("ALTER TABLE models ADD COLUMN content_hash BLOB")) {
+            qCritical() << "Failed to migrate to 1.7.0:" << query.lastError().text();
+            return false;
+        }
+        if (!stepDone("1.7.0")) {
+            return false;
+        }
+    }
+
+    // 1.8.0: near-duplicate fingerprints, filled in on import and thumbnail generation
+    if (version < QVersionNumber(1, 8, 0)) {
+        for (const QString& column : {QString("mesh_fingerprint BLOB"), QString("thumbnail_hash INTEGER")}) {
+            if (!hasColumn("models", column.section(' ', 0, 0)) &&
+                !query.exec("ALTER TABLE models ADD COLUMN " + column)) {
+                qCritical() << "Failed to migrate to 1.8.0:" << query.lastError().text();
+                return false;
+            }
+        }
+        if (!stepDone("1.8.0")) {
+            return false;
+        }
+    }
+
+    // 1.9.0: update triggers only log the columns the search index reads;
+    // createIndexes() recreates them
+    if (version < QVersionNumber(1, 9, 0)) {
+        for (const QString& trigger : {QString("models_log_update"), QString("projects_log_update")}) {
+            if (!query.exec("DROP TRIGGER IF EXISTS " + trigger)) {
+                qCritical() << "Failed to migrate to 1.9.0:" << query.lastError().text();
+                return false;
+            }
+        }
+        if (!stepDone("1.9.0")) {
+            return false;
+        }
+    }
+
+    // Covers a current version that needs no step of its own
+    return recordedVersion == CURRENT_SCHEMA_VERSION || stepDone(CURRENT_SCHEMA_VERSION);
+}
+
+bool DatabaseManager::recordSchemaVersion(const QString& fromVersion, const QString& toVersion)
+{
+    QSqlQuery updateVersion(m_database);
+    updateVersion.prepare("UPDATE schema_version SET version = ?, applied_date = CURRENT_TIMESTAMP WHERE version = ?");
+    updateVersion.addBindValue(toVersion);
+    updateVersion.addBindValue(fromVersion);
+
+    if (!updateVersion.exec()) {
+        qCritical() << "Failed to update schema version:" << updateVersion.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool DatabaseManager::migrateToIntegerKeys()
+{
+    QSqlQuery query(m_database);
+
+    // Tables are rebuilt in place, which foreign key enforcement would block;
+    // the pragma is ignored inside a transaction so it is switched first
+    query.exec("PRAGMA foreign_keys = OFF");
+
+    if (!m_database.transaction()) {
+        qCritical() << "Failed to start key migration:" << m_database.lastError().text();
+        query.exec("PRAGMA foreign_keys = ON");
+        return false;
+    }
+
+    // Set the text-keyed tables aside; the FTS index and its triggers are
+    // dropped first because they reference the old models table
+    QStringList renames = {
+        "DROP TRIGGER IF EXISTS models_fts_insert",
+        "DROP TRIGGER IF EXISTS models_fts_delete",
+        "DROP TRIGGER IF EXISTS models_fts_update",
+        "DROP TABLE IF EXISTS models_fts",
+        "ALTER TABLE project_tags RENAME TO project_tags_v1",
+        "ALTER TABLE model_tags RENAME TO model_tags_v1",
+        "ALTER TABLE project_models RENAME TO project_models_v1",
+        "ALTER TABLE projects RENAME TO projects_v1",
+        "ALTER TABLE models RENAME TO models_v1"
+    };
+
+    bool success = true;
+    for (const QString& statement : renames) {
+        if (!query.exec(statement)) {
+            qCritical() << "Failed to migrate to 1.2.0:" << query.lastError().text();
+            success = false;
+            break;
+        }
+    }
+
+    // Old rowids become the new integer ids, so the join tables can be
+    // carried over with plain joins against the set-aside tables
+    success = success && createTables() &&
+        copyRowsWithUuidKey("models_v1", "models",
+                            {"filename", "file_size", "import_date", "thumbnail_path", "mesh_stats",
+                             "custom_fields", "tags_text", "created_date", "modified_date"}) &&
+        copyRowsWithUuidKey("projects_v1", "projects",
+                            {"name", "description", "created_date", "metadata", "modified_date"});
+
+    if (success) {
+        QStringList statements = {
+            "INSERT INTO model_tags (model_id, tag_id, assigned_date) "
+            "SELECT models_v1.rowid, model_tags_v1.tag_id, model_tags_v1.assigned_date "
+            "FROM model_tags_v1 JOIN models_v1 ON models_v1.id = model_tags_v1.model_id",
+
+            "INSERT INTO project_models (project_id, model_id, added_date) "
+            "SELECT projects_v1.rowid, models_v1.rowid, project_models_v1.added_date "
+            "FROM project_models_v1 "
+            "JOIN projects_v1 ON projects_v1.id = project_models_v1.project_id "
+            "JOIN models_v1 ON models_v1.id = project_models_v1.model_id",
+
+            "INSERT INTO project_tags (project_id, tag_id, assigned_date) "
+            "SELECT projects_v1.rowid, project_tags_v1.tag_id, project_tags_v1.assigned_date "
+            "FROM project_tags_v1 JOIN projects_v1 ON projects_v1.id = project_tags_v1.project_id",
+
+            "DROP TABLE project_tags_v1",
+            "DROP TABLE model_tags_v1",
+            "DROP TABLE project_models_v1",
+            "DROP TABLE projects_v1",
+            "DROP TABLE models_v1"
+        };
+
+        for (const QString& statement : statements) {
+            if (!query.exec(statement)) {
+                qCritical() << "Failed to migrate to 1.2.0:" << query.lastError().text();
+                success = false;
+                break;
+            }
+        }
+    }
+
+    if (success) {
+        success = m_database.commit();
+    }
+
+    if (!success) {
+        m_database.rollback();
+    }
+
+    query.exec("PRAGMA foreign_keys = ON");
+
+    if (success && query.exec("PRAGMA foreign_key_check") && query.next()) {
+        qWarning() << "Key migration left dangling references in" << query.value(0).toString();
+    }
+
+    return success;
+}
+
+bool DatabaseManager::migrateToCounterTables()
+{
+    QSqlQuery query(m_database);
+
+    // Tables rebuilt by the 1.2.0 step already carry the column
+    if (!hasColumn("models", "format") && !query.exec("ALTER TABLE models ADD COLUMN format TEXT")) {
+        qCritical() << "Failed to migrate to 1.3.0:" << query.lastError().text();
+        return false;
+    }
+
+    // Backfill formats; the extension rule lives in C++ alongside the write path
+    QVariantList ids, formats;
+    QSqlQuery select(m_database);
+    select.setForwardOnly(true);
+    if (!select.exec("SELECT id, filename FROM models WHERE format IS NULL")) {
+        qCritical() << "Failed to migrate to 1.3.0:" << select.lastError().text();
+        return false;
+    }
+
+    while (select.next()) {
+        ids << select.value(0);
+        formats << QFileInfo(select.value(1).toString()).suffix().toLower();
+    }
+    select.finish();
+
+    if (!m_database.transaction()) {
+        qCritical() << "Failed to start counter migration:" << m_database.lastError().text();
+        return false;
+    }
+
+    bool success = true;
+    if (!ids.isEmpty()) {
+        QSqlQuery update(m_database);
+        update.prepare("UPDATE models SET format = ? WHERE id = ?");
+        update.addBindValue(formats);
+        update.addBindValue(ids);
+        success = update.execBatch();
+        if (!success) {
+            qCritical() << "Failed to migrate to 1.3.0:" << update.lastError().text();
+        }
+    }
+
+    // Seed the counters once; triggers created with the indexes keep them current
+    QStringList statements = {
+        "DELETE FROM tag_usage",
+        "INSERT INTO tag_usage (tag_id, usage_count) "
+        "SELECT tag_id, COUNT(*) FROM model_tags GROUP BY tag_id",
+        "DELETE FROM model_format_stats",
+        "INSERT INTO model_format_stats (format, model_count, total_bytes) "
+        "SELECT COALESCE(format, ''), COUNT(*), COALESCE(SUM(file_size), 0) FROM models "
+        "GROUP BY COALESCE(format, '')"
+    };
+
+    for (const QString& statement : statements) {
+        if (!success) {
+            break;
+        }
+        if (!query.exec(statement)) {
+            qCritical() << "Failed to migrate to 1.3.0:" << query.lastError().text();
+            success = false;
+        }
+    }
+
+    if (success) {
+        success = m_database.commit();
+    }
+
+    if (!success) {
+        m_database.rollback();
+    }
+
+    return success;
+}
+
+bool DatabaseManager::migrateToTypedMeshStats()
+{
+    QSqlQuery query(m_database);
+
+    QStringList columns = {
+        "vertex_count INTEGER", "triangle_count INTEGER", "bounds_x REAL", "bounds_y REAL", "bounds_z REAL"
+    };
+
+    for (const QString& column : columns) {
+        if (!hasColumn("models", column.section(' ', 0, 0)) &&
+            !query.exec("ALTER TABLE models ADD COLUMN " + column)) {
+            qCritical() << "Failed to migrate to 1.4.0:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    // Move the known statistics out of the JSON blobs into their columns
+    QVariantList ids, vertexCounts, triangleCounts, boundsX, boundsY, boundsZ, extras;
+    QSqlQuery select(m_database);
+    select.setForwardOnly(true);
+    if (!select.exec("SELECT id, mesh_stats FROM models WHERE mesh_stats IS NOT NULL")) {
+        qCritical() << "Failed to migrate to 1.4.0:" << select.lastError().text();
+        return false;
+    }
+
+    while (select.next()) {
+        MeshStatsColumns stats = splitMeshStats(
+            QJsonDocument::fromJson(select.value(1).toByteArray()).object().toVariantMap());
+        ids << select.value(0);
+        vertexCounts << stats.vertexCount;
+        triangleCounts << stats.triangleCount;
+        boundsX << stats.boundsX;
+        boundsY << stats.boundsY;
+        boundsZ << stats.boundsZ;
+        extras << stats.extra;
+    }
+    select.finish();
+
+    if (ids.isEmpty()) {
+        return true;
+    }
+
+    if (!m_database.transaction()) {
+        qCritical() << "Failed to start mesh statistics migration:" << m_database.lastError().text();
+        return false;
+    }
+
+    QSqlQuery update(m_database);
+    update.prepare("UPDATE models SET vertex_count = ?, triangle_count = ?, "
+                   "bounds_x = ?, bounds_y = ?, bounds_z = ?, mesh_stats = ? WHERE id = ?");
+    update.addBindValue(vertexCounts);
+    update.addBindValue(triangleCounts);
+    update.addBindValue(boundsX);
+    update.addBindValue(boundsY);
+    update.addBindValue(boundsZ);
+    update.addBindValue(extras);
+    update.addBindValue(ids);
+
+    if (!update.execBatch() || !m_database.commit()) {
+        qCritical() << "Failed to migrate to 1.4.0:" << update.lastError().text();
+        m_database.rollback();
+        return false;
+    }
+
+    return true;
+}
+
+bool DatabaseManager::hasColumn(const QString& table, const QString& column) const
+{
+    QSqlQuery query(m_database);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        return false;
+    }
+
+    while (query.next()) {
+        if (query.value(1).toString() == column) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DatabaseManager::copyRowsWithUuidKey(const QString& sourceTable, const QString& targetTable,
+                                          const QStringList& columns)
+{
+    static const int COPY_BATCH_SIZE = 1000;
+
+    QStringList placeholders;
+    for (int i = 0; i < columns.count() + 2; ++i) {
+        placeholders << "?";
+    }
+
+    QSqlQuery select(m_database);
+    select.setForwardOnly(true);
+    if (!select.exec(QString("SELECT rowid, id, %1 FROM %2").arg(columns.join(", "), sourceTable))) {
+        qCritical() << "Failed to read" << sourceTable << ":" << select.lastError().text();
+        return false;
+    }
+
+    QSqlQuery insert(m_database);
+    insert.prepare(QString("INSERT INTO %1 (id, uuid, %2) VALUES (%3)")
+                   .arg(targetTable, columns.join(", "), placeholders.join(", ")));
+
+    // Text UUIDs are converted here rather than in SQL, which has no portable unhex()
+    QList<QVariantList> values(columns.count() + 2);
+    auto flush = [&]() {
+        if (values[0].isEmpty()) {
+            return true;
+        }
+        for (const QVariantList& column : values) {
+            insert.addBindValue(column);
+        }
+        bool ok = insert.execBatch();
+        if (!ok) {
+            qCritical() << "Failed to copy rows into" << targetTable << ":" << insert.lastError().text();
+        }
+        for (QVariantList& column : values) {
+            column.clear();
+        }
+        return ok;
+    };
+
+    while (select.next()) {
+        values[0] << select.value(0);
+        values[1] << QUuid::fromString(select.value(1).toString()).toRfc4122();
+        for (int i = 0; i < columns.count(); ++i) {
+            values[i + 2] << select.value(i + 2);
+        }
+
+        if (values[0].count() >= COPY_BATCH_SIZE && !flush()) {
+            return false;
+        }
+    }
+
+    return flush();
+}
+
+QString DatabaseManager::sanitizeString(const QString& input) const
+{
+    QString sanitized = input;
+    sanitized.replace("\"", "\"\"");  // Escape double quotes
+    sanitized.replace("'", "''");    // Escape single quotes
+    return sanitized;
+}
+
+QVariantMap DatabaseManager::modelToVariantMap(const ModelMetadata& model) const
+{
+    QVariantMap map;
     map["id"] = model.id.toString();
     map["filename"] = model.filename;
     map["file_size"] = model.fileSize;
@@ -401,4 +1793,310 @@ ProjectData DatabaseManager::variantMapToProject(const QVariantMap& map) const
 
     project.metadata = map["metadata"].toMap();
     return project;
-}
\ No newline at end of file
+}
+
+bool DatabaseManager::writeModelBatch(const QList<ModelMetadata>& models, bool replaceExisting)
+{
+    QString sql =
+        "INSERT INTO models (uuid, filename, file_size, import_date, thumbnail_path, "
+        "vertex_count, triangle_count, bounds_x, bounds_y, bounds_z, mesh_stats, "
+        "custom_fields, tags_text, format, shape_descriptor, content_hash, mesh_fingerprint, thumbnail_hash) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+
+    if (replaceExisting) {
+        sql += " ON CONFLICT(uuid) DO UPDATE SET "
+               "filename = excluded.filename,"
+               "file_size = excluded.file_size,"
+               "import_date = excluded.import_date,"
+               "thumbnail_path = excluded.thumbnail_path,"
+               "vertex_count = excluded.vertex_count,"
+               "triangle_count = excluded.triangle_count,"
+               "bounds_x = excluded.bounds_x,"
+               "bounds_y = excluded.bounds_y,"
+               "bounds_z = excluded.bounds_z,"
+               "mesh_stats = excluded.mesh_stats,"
+               "custom_fields = excluded.custom_fields,"
+               "tags_text = excluded.tags_text,"
+               "format = excluded.format,"
+               "shape_descriptor = COALESCE(excluded.shape_descriptor, shape_descriptor),"
+               "content_hash = COALESCE(excluded.content_hash, content_hash),"
+               "mesh_fingerprint = COALESCE(excluded.mesh_fingerprint, mesh_fingerprint),"
+               "thumbnail_hash = COALESCE(excluded.thumbnail_hash, thumbnail_hash),"
+               "modified_date = CURRENT_TIMESTAMP";
+    }
+
+    QVariantList ids, filenames, fileSizes, importDates, thumbnailPaths, meshStats;
+    QVariantList vertexCounts, triangleCounts, boundsX, boundsY, boundsZ;
+    QVariantList customFields, tagsText, formats, shapeDescriptors, contentHashes;
+    QVariantList meshFingerprints, thumbnailHashes;
+    for (const ModelMetadata& model : models) {
+        ids << model.id.toRfc4122();
+        filenames << model.filename;
+        fileSizes << model.fileSize;
+        importDates << model.importDate;
+        thumbnailPaths << model.thumbnailPath;
+
+        MeshStatsColumns stats = splitMeshStats(model.meshStats);
+        vertexCounts << stats.vertexCount;
+        triangleCounts << stats.triangleCount;
+        boundsX << stats.boundsX;
+        boundsY << stats.boundsY;
+        boundsZ << stats.boundsZ;
+        meshStats << stats.extra;
+
+        customFields << QString::fromUtf8(QJsonDocument(QJsonObject::fromVariantMap(model.customFields))
+                                          .toJson(QJsonDocument::Compact));
+        tagsText << model.tags.join(" ");
+        formats << QFileInfo(model.filename).suffix().toLower();
+
+        // Updates made without reading the file or thumbnail keep the stored derived values
+        shapeDescriptors << (model.shapeDescriptor.isEmpty() ? QVariant() : QVariant(model.shapeDescriptor));
+        contentHashes << (model.contentHash.isEmpty() ? QVariant() : QVariant(model.contentHash));
+        meshFingerprints << (model.meshFingerprint.isEmpty() ? QVariant() : QVariant(model.meshFingerprint));
+        thumbnailHashes << (model.thumbnailHash == 0 ? QVariant() : QVariant(static_cast<qint64>(model.thumbnailHash)));
+    }
+
+    QSqlQuery& query = preparedQuery(sql);
+    query.addBindValue(ids);
+    query.addBindValue(filenames);
+    query.addBindValue(fileSizes);
+    query.addBindValue(importDates);
+    query.addBindValue(thumbnailPaths);
+    query.addBindValue(vertexCounts);
+    query.addBindValue(triangleCounts);
+    query.addBindValue(boundsX);
+    query.addBindValue(boundsY);
+    query.addBindValue(boundsZ);
+    query.addBindValue(meshStats);
+    query.addBindValue(customFields);
+    query.addBindValue(tagsText);
+    query.addBindValue(formats);
+    query.addBindValue(shapeDescriptors);
+    query.addBindValue(contentHashes);
+    query.addBindValue(meshFingerprints);
+    query.addBindValue(thumbnailHashes);
+
+    if (!query.execBatch()) {
+        qCritical() << "Failed to write model batch:" << query.lastError().text();
+        emit databaseError("Bulk Model Write Failed", query.lastError().text());
+        return false;
+    }
+
+    return true;
+}
+
+bool DatabaseManager::writeModelTagBatch(const QList<ModelMetadata>& models, bool replaceExisting)
+{
+    // Collect the distinct tag names used by the batch
+    QSet<QString> distinctTags;
+    for (const ModelMetadata& model : models) {
+        for (const QString& tag : model.tags) {
+            distinctTags.insert(tag);
+        }
+    }
+
+    if (distinctTags.isEmpty() && !replaceExisting) {
+        return true;
+    }
+
+    // Join rows reference models by integer id
+    QHash<QUuid, qint64> modelKeys;
+    if (!resolveModelKeys(models, modelKeys)) {
+        return false;
+    }
+
+    // Replace the tag sets of existing models wholesale
+    if (replaceExisting) {
+        QVariantList modelIds;
+        for (const ModelMetadata& model : models) {
+            modelIds << modelKeys.value(model.id);
+        }
+
+        QSqlQuery& clearTags = preparedQuery("DELETE FROM model_tags WHERE model_id = ?");
+        clearTags.addBindValue(modelIds);
+        if (!clearTags.execBatch()) {
+            qCritical() << "Failed to clear model tags:" << clearTags.lastError().text();
+            return false;
+        }
+    }
+
+    if (distinctTags.isEmpty()) {
+        return true;
+    }
+
+    QStringList tagNames = distinctTags.values();
+
+    QVariantList tagNameValues;
+    for (const QString& tag : tagNames) {
+        tagNameValues << tag;
+    }
+
+    QSqlQuery& insertTags = preparedQuery("INSERT OR IGNORE INTO tags (name) VALUES (?)");
+    insertTags.addBindValue(tagNameValues);
+    if (!insertTags.execBatch()) {
+        qCritical() << "Failed to insert tags:" << insertTags.lastError().text();
+        return false;
+    }
+
+    // Resolve tag ids in chunks that stay below the host parameter limit
+    QHash<QString, qint64> tagIds;
+    for (int offset = 0; offset < tagNames.count(); offset += MAX_BOUND_PARAMETERS) {
+        QStringList chunk = tagNames.mid(offset, MAX_BOUND_PARAMETERS);
+
+        QStringList placeholders;
+        for (int i = 0; i < chunk.count(); ++i) {
+            placeholders << "?";
+        }
+
+        QSqlQuery& selectTags = preparedQuery(
+            QString("SELECT id, name FROM tags WHERE name IN (%1)").arg(placeholders.join(",")));
+        for (const QString& tag : chunk) {
+            selectTags.addBindValue(tag);
+        }
+
+        if (!selectTags.exec()) {
+            qCritical() << "Failed to resolve tag ids:" << selectTags.lastError().text();
+            return false;
+        }
+
+        while (selectTags.next()) {
+            tagIds.insert(selectTags.value(1).toString(), selectTags.value(0).toLongLong());
+        }
+        selectTags.finish();
+    }
+
+    // Write the join rows as one batch
+    QVariantList joinModelIds, joinTagIds;
+    for (const ModelMetadata& model : models) {
+        qint64 modelId = modelKeys.value(model.id);
+        for (const QString& tag : model.tags) {
+            joinModelIds << modelId;
+            joinTagIds << tagIds.value(tag);
+        }
+    }
+
+    QSqlQuery& insertJoins = preparedQuery("INSERT OR IGNORE INTO model_tags (model_id, tag_id) VALUES (?, ?)");
+    insertJoins.addBindValue(joinModelIds);
+    insertJoins.addBindValue(joinTagIds);
+    if (!insertJoins.execBatch()) {
+        qCritical() << "Failed to insert model tags:" << insertJoins.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool DatabaseManager::writeModelTagEdit(const QList<QUuid>& modelIds, const QStringList& tags, bool add)
+{
+    QList<ModelMetadata> models;
+    for (const QUuid& id : modelIds) {
+        ModelMetadata model(id);
+        model.tags = tags;
+        models.append(model);
+    }
+
+    if (models.isEmpty() || tags.isEmpty()) {
+        return true;
+    }
+
+    QHash<QUuid, qint64> modelKeys;
+    if (!resolveModelKeys(models, modelKeys)) {
+        return false;
+    }
+
+    // Adding reuses the batch insert, which ignores tags a model already has
+    if (add && !writeModelTagBatch(models, false)) {
+        return false;
+    }
+
+    QVariantList keys;
+    for (const QUuid& id : modelIds) {
+        keys << modelKeys.value(id);
+    }
+
+    if (!add) {
+        QVariantList joinModelIds, joinTagNames;
+        for (const QVariant& key : keys) {
+            for (const QString& tag : tags) {
+                joinModelIds << key;
+                joinTagNames << tag;
+            }
+        }
+
+        QSqlQuery& deleteJoins = preparedQuery(
+            "DELETE FROM model_tags WHERE model_id = ? AND tag_id = (SELECT id FROM tags WHERE name = ?)");
+        deleteJoins.addBindValue(joinModelIds);
+        deleteJoins.addBindValue(joinTagNames);
+        if (!deleteJoins.execBatch()) {
+            qCritical() << "Failed to remove model tags:" << deleteJoins.lastError().text();
+            return false;
+        }
+    }
+
+    // Rebuild the full-text mirror from the join rows as they now stand
+    QSqlQuery& updateTagsText = preparedQuery(
+        "UPDATE models SET tags_text = ("
+        "SELECT group_concat(tags.name, ' ') FROM model_tags "
+        "JOIN tags ON tags.id = model_tags.tag_id "
+        "WHERE model_tags.model_id = models.id) WHERE id = ?");
+    updateTagsText.addBindValue(keys);
+    if (!updateTagsText.execBatch()) {
+        qCritical() << "Failed to update model tag text:" << updateTagsText.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool DatabaseManager::resolveModelKeys(const QList<ModelMetadata>& models, QHash<QUuid, qint64>& keys)
+{
+    for (int offset = 0; offset < models.count(); offset += MAX_BOUND_PARAMETERS) {
+        int chunkSize = qMin(MAX_BOUND_PARAMETERS, models.count() - offset);
+
+        QStringList placeholders;
+        for (int i = 0; i < chunkSize; ++i) {
+            placeholders << "?";
+        }
+
+        QSqlQuery& selectModels = preparedQuery(
+            QString("SELECT id, uuid FROM models WHERE uuid IN (%1)").arg(placeholders.join(",")));
+        for (int i = offset; i < offset + chunkSize; ++i) {
+            selectModels.addBindValue(models[i].id.toRfc4122());
+        }
+
+        if (!selectModels.exec()) {
+            qCritical() << "Failed to resolve model ids:" << selectModels.lastError().text();
+            return false;
+        }
+
+        while (selectModels.next()) {
+            keys.insert(QUuid::fromRfc4122(selectModels.value(1).toByteArray()), selectModels.value(0).toLongLong());
+        }
+        selectModels.finish();
+    }
+
+    // Tagging a model that was never stored is a foreign key violation
+    for (const ModelMetadata& model : models) {
+        if (!keys.contains(model.id)) {
+            qCritical() << "Cannot write tags for unknown model" << model.id.toString();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QSqlQuery& DatabaseManager::preparedQuery(const QString& sql)
+{
+    return m_connectionPool->preparedQuery(DatabaseConnectionPool::AccessMode::ReadWrite, sql);
+}
+
+QSqlDatabase DatabaseManager::readerConnection() const
+{
+    return m_connectionPool->connection(DatabaseConnectionPool::AccessMode::ReadOnly);
+}
+
+QSqlDatabase DatabaseManager::writerConnection()
+{
+    return m_connectionPool->connection(DatabaseConnectionPool::AccessMode::ReadWrite);
+}
@@ -1,11 +1,19 @@
 #pragma once
 
 #include "BaseTypes.h"
+#include "ModelCursor.h"
 #include <QObject>
 #include <QString>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 #include <QVariantMap>
 #include <QList>
+#include <QHash>
+#include <QFuture>
+
+class DatabaseConnectionPool;
+class DatabaseWriter;
+class DatabaseBackup;
 
 /**
  * @brief Database manager for SQLite operations
@@ -35,6 +43,50 @@ public:
     virtual QList<ModelMetadata> searchModels(const QString& query,
                                             const QStringList& tags = QStringList()) const = 0;
 
+    // Streaming access to the whole catalogue in constant memory
+    virtual ModelCursor openModelCursor(ModelCursor::Columns columns = ModelCursor::AllColumns,
+                                        int pageSize = ModelCursor::DEFAULT_PAGE_SIZE) const;
+    virtual ModelCursor openModelCursor(const QList<QUuid>& ids,
+                                        ModelCursor::Columns columns = ModelCursor::AllColumns) const;
+
+    // Bulk model operations (single transaction, reused prepared statements)
+    virtual bool insertModels(const QList<ModelMetadata>& models);
+    virtual bool upsertModels(const QList<ModelMetadata>& models);
+
+    // Full-text search over filename, tags and custom fields, best bm25 match first.
+    // Optional ranges restrict matches on indexed numeric columns (see findModelsInRanges)
+    virtual QList<QUuid> fullTextSearch(const QString& query, int limit = 100,
+                                        const QVariantMap& ranges = QVariantMap()) const;
+
+    // Models whose indexed columns fall within the given ranges. Keys are
+    // file_size, import_date, vertex_count, triangle_count, bounds_x, bounds_y or
+    // bounds_z; each value is a map with optional "min" and "max" entries, ISO
+    // text for import_date
+    virtual QList<QUuid> findModelsInRanges(const QVariantMap& ranges, int limit = -1) const;
+
+    // Duplicate detection: content hashes of the models with this file size.
+    // Only a same-sized file can match, so the indexed size lookup comes
+    // first; a null hash means the model predates hashing
+    virtual QHash<QUuid, QByteArray> getContentHashesBySize(qint64 fileSize) const;
+    virtual bool setContentHash(const QUuid& id, const QByteArray& contentHash);
+
+    // Write-behind mutations; futures resolve once the group commit has landed
+    virtual QFuture<bool> insertModelAsync(const ModelMetadata& model);
+    virtual QFuture<bool> insertModelsAsync(const QList<ModelMetadata>& models);
+    virtual QFuture<bool> updateModelAsync(const ModelMetadata& model);
+    virtual QFuture<bool> insertModelTagsAsync(const QUuid& modelId, const QStringList& tags);
+
+    // Incremental tag edits resolved on the writer thread, so edits to the
+    // same model queued together compose instead of replacing each other
+    virtual QFuture<bool> addModelTagsAsync(const QList<QUuid>& modelIds, const QStringList& tags);
+    virtual QFuture<bool> removeModelTagsAsync(const QList<QUuid>& modelIds, const QStringList& tags);
+    virtual QFuture<bool> saveSettingAsync(const QString& key, const QVariant& value);
+
+    // Perceptual thumbnail hashes for near-duplicate detection; 0 clears one.
+    // Queued writes share group commits, so callers need not wait
+    virtual QFuture<bool> setThumbnailHashesAsync(const QHash<QUuid, quint64>& thumbnailHashes);
+    virtual bool waitForCommit(QFuture<bool> future);
+
     // Project operations
     virtual bool insertProject(const ProjectData& project) = 0;
     virtual bool updateProject(const ProjectData& project) = 0;
@@ -50,6 +102,10 @@ public:
     virtual QStringList getAllTags() const = 0;
     virtual QMap<QString, int> getTagUsageCounts() const = 0;
 
+    // Materialised statistics, kept current by triggers
+    virtual QStringList getPopularTags(int maxTags = 20) const;
+    virtual QVariantMap getModelStatistics() const;
+
     // Settings operations
     virtual bool saveSetting(const QString& key, const QVariant& value) = 0;
     virtual QVariant getSetting(const QString& key, const QVariant& defaultValue = QVariant()) const = 0;
@@ -60,6 +116,10 @@ public:
     virtual bool optimize() = 0;
     virtual bool backup(const QString& backupPath) = 0;
     virtual bool restore(const QString& backupPath) = 0;
+
+    // Online backup on a background thread; the returned job reports progress
+    // and completion, then deletes itself
+    virtual DatabaseBackup* startBackup(const QString& backupPath);
     virtual qint64 getDatabaseSize() const = 0;
     virtual QStringList getTableNames() const = 0;
 
@@ -72,12 +132,38 @@ public:
     virtual bool runMigrations() = 0;
     virtual QString getDatabaseVersion() const = 0;
 
+    // Change data capture: every committed model or project mutation appends a
+    // record with a strictly increasing version
+    struct Change {
+        qint64 version;
+        QString entity;     // "model" or "project"
+        QUuid id;
+        QString operation;  // "insert", "update" or "delete"
+    };
+
+    virtual qint64 currentChangeVersion() const;
+    virtual qint64 oldestChangeVersion() const;  // 0 while the log is empty
+    virtual QList<Change> changesSince(qint64 version, int limit = -1) const;
+    virtual bool pruneChangeLog(qint64 upToVersion);
+
 signals:
     // Database events
     void databaseInitialized();
     void databaseClosed();
     void databaseError(const QString& error, const QString& details);
 
+    // New change log records are visible up to this version
+    void changesAvailable(qint64 version);
+
+    // A backup started with startBackup() has finished
+    void backupCompleted(const QString& backupPath, bool success, const QString& error);
+
+    // Contents are about to be replaced from a backup; readers must finish first
+    void aboutToRestore();
+
+    // Contents were replaced from a backup; derived indexes must be rebuilt
+    void databaseRestored();
+
     // Data change events
     void modelInserted(const ModelMetadata& model);
     void modelUpdated(const ModelMetadata& model);
@@ -90,9 +176,18 @@ protected:
     // Database schema
     virtual bool createTables() = 0;
     virtual bool createIndexes() = 0;
+    virtual bool createFullTextIndex();
+    virtual bool createCounterTriggers();
+    virtual bool createChangeLogTriggers();
 
     // Migration system
     virtual bool migrateFromVersion(const QString& fromVersion) = 0;
+    virtual bool migrateToIntegerKeys();
+    virtual bool migrateToCounterTables();
+    virtual bool migrateToTypedMeshStats();
+    virtual bool recordSchemaVersion(const QString& fromVersion, const QString& toVersion);
+    virtual bool hasColumn(const QString& table, const QString& column) const;
+    virtual bool copyRowsWithUuidKey(const QString& sourceTable, const QString& targetTable, const QStringList& columns);
 
     // Utility methods
     virtual QString sanitizeString(const QString& input) const;
@@ -101,11 +196,31 @@ protected:
     virtual QVariantMap projectToVariantMap(const ProjectData& project) const;
     virtual ProjectData variantMapToProject(const QVariantMap& map) const;
 
-    // Database connection
+    // Bulk write helpers
+    virtual bool writeModelBatch(const QList<ModelMetadata>& models, bool replaceExisting);
+    virtual bool writeModelTagBatch(const QList<ModelMetadata>& models, bool replaceExisting);
+    virtual bool writeModelTagEdit(const QList<QUuid>& modelIds, const QStringList& tags, bool add);
+    virtual bool resolveModelKeys(const QList<ModelMetadata>& models, QHash<QUuid, qint64>& keys);
+    virtual QSqlQuery& preparedQuery(const QString& sql);
+
+    // Connections owned by the calling thread
+    virtual QSqlDatabase readerConnection() const;
+    virtual QSqlDatabase writerConnection();
+
+    // Database connection (schema setup and migrations on the initializing thread)
     QSqlDatabase m_database;
     QString m_databasePath;
     bool m_isInitialized;
 
+    // Per-thread connections and prepared statements for reads and writes
+    DatabaseConnectionPool* m_connectionPool;
+
+    // Owns the only write path; see DatabaseWriter
+    DatabaseWriter* m_writer;
+
+    // Last version announced through changesAvailable
+    qint64 m_announcedChangeVersion;
+
     // Schema version
     static const QString CURRENT_SCHEMA_VERSION;
 };
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "DatabaseWriter.h"
+#include "DatabaseConnectionPool.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QMutexLocker>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QDebug>
+
+DatabaseWriter::DatabaseWriter(DatabaseConnectionPool* connectionPool, QObject* parent)
+    : QThread(parent)
+    , m_connectionPool(connectionPool)
+    , m_flushRequested(false)
+    , m_stopRequested(false)
+    , m_commitIntervalMs(20)
+    , m_maxBatchOperations(500)
+{
+    setObjectName("DatabaseWriter");
+}
+
+DatabaseWriter::~DatabaseWriter()
+{
+    stop();
+}
+
+QFuture<bool> DatabaseWriter::enqueue(const Operation& operation, const CommitCallback& onCommitted)
+{
+    PendingWrite write;
+    write.operation = operation;
+    write.onCommitted = onCommitted;
+    write.promise = std::make_shared<QPromise<bool>>();
+    write.promise->start();
+
+    QFuture<bool> future = write.promise->future();
+
+    QMutexLocker locker(&m_queueMutex);
+    if (m_stopRequested) {
+        qWarning() << "Database writer stopped, rejecting write";
+        write.promise->addResult(false);
+        write.promise->finish();
+        return future;
+    }
+
+    m_queue.enqueue(write);
+    m_queueCondition.wakeAll();
+
+    return future;
+}
+
+void DatabaseWriter::flush()
+{
+    QMutexLocker locker(&m_queueMutex);
+    m_flushRequested = true;
+    m_queueCondition.wakeAll();
+}
+
+void DatabaseWriter::stop()
+{
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_stopRequested = true;
+        m_queueCondition.wakeAll();
+    }
+
+    if (isRunning()) {
+        wait();
+    }
+}
+
+void DatabaseWriter::resume()
+{
+    if (isRunning()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_stopRequested = false;
+    }
+
+    start();
+}
+
+void DatabaseWriter::setCommitPolicy(int intervalMs, int maxOperations)
+{
+    QMutexLocker locker(&m_queueMutex);
+    m_commitIntervalMs = qMax(0, intervalMs);
+    m_maxBatchOperations = qMax(1, maxOperations);
+}
+
+int DatabaseWriter::commitInterval() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_commitIntervalMs;
+}
+
+int DatabaseWriter::maxBatchOperations() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_maxBatchOperations;
+}
+
+void DatabaseWriter::run()
+{
+    forever {
+        QList<PendingWrite> batch;
+
+        {
+            QMutexLocker locker(&m_queueMutex);
+
+            while (m_queue.isEmpty() && !m_stopRequested) {
+                m_queueCondition.wait(&m_queueMutex);
+            }
+
+            if (m_queue.isEmpty()) {
+                break;  // Stop requested and nothing left to commit
+            }
+
+            // Hold the group open so concurrent writers can share the commit
+            QDeadlineTimer deadline(m_commitIntervalMs);
+            while (m_queue.size() < m_maxBatchOperations && !m_flushRequested && !m_stopRequested) {
+                if (!m_queueCondition.wait(&m_queueMutex, deadline)) {
+                    break;
+                }
+            }
+
+            m_flushRequested = false;
+
+            int batchSize = qMin(m_queue.size(), m_maxBatchOperations);
+            for (int i = 0; i < batchSize; ++i) {
+                batch.append(m_queue.dequeue());
+            }
+        }
+
+        commitBatch(batch);
+    }
+}
+
+void DatabaseWriter::commitBatch(QList<PendingWrite>& batch)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker writeLocker(m_connectionPool->writeMutex());
+    QSqlDatabase database = m_connectionPool->connection(DatabaseConnectionPool::AccessMode::ReadWrite);
+
+    QList<bool> results;
+    bool committed = database.transaction();
+
+    if (committed) {
+        QSqlQuery savepoint(database);
+
+        // Isolate each operation so one failure does not abort the group
+        for (PendingWrite& write : batch) {
+            savepoint.exec("SAVEPOINT pending_write");
+            bool success = write.operation();
+            if (!success) {
+                savepoint.exec("ROLLBACK TO pending_write");
+            }
+            savepoint.exec("RELEASE pending_write");
+            results.append(success);
+        }
+
+        committed = database.commit();
+    }
+
+    if (!committed) {
+        QString error = database.lastError().text();
+        database.rollback();
+        qCritical() << "Group commit failed:" << error;
+        emit commitFailed(error);
+    }
+
+    writeLocker.unlock();
+
+    // Commit callbacks run here on the writer thread, before waiters are
+    // released; anything they notify on another thread must be queued
+    for (int i = 0; i < batch.count(); ++i) {
+        bool success = committed && results.value(i, false);
+
+        if (success && batch[i].onCommitted) {
+            batch[i].onCommitted();
+        }
+
+        batch[i].promise->addResult(success);
+        batch[i].promise->finish();
+    }
+
+    if (committed) {
+        emit groupCommitted(batch.count(), timer.elapsed());
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QFuture>
+#include <QPromise>
+#include <memory>
+#include <functional>
+
+class DatabaseConnectionPool;
+
+/**
+ * @brief Single writer thread that applies database mutations in group commits
+ *
+ * Mutations are queued from any thread and applied on the writer thread's own
+ * connection. Queued operations are coalesced into one transaction every
+ * commit interval, or sooner once the batch reaches its size limit, so many
+ * small writes share a single fsync. Each operation runs inside its own
+ * savepoint: a failing operation is rolled back without aborting the rest of
+ * the group. Futures resolve, and commit callbacks run on the writer thread,
+ * once the group commit has landed.
+ */
+class DatabaseWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    using Operation = std::function<bool()>;
+    using CommitCallback = std::function<void()>;
+
+    explicit DatabaseWriter(DatabaseConnectionPool* connectionPool, QObject* parent = nullptr);
+    virtual ~DatabaseWriter();
+
+    // Queue a mutation; the future reports whether it was durably committed
+    QFuture<bool> enqueue(const Operation& operation, const CommitCallback& onCommitted = CommitCallback());
+
+    // Commit whatever is queued without waiting for the interval to elapse
+    void flush();
+
+    // Drain the queue, commit and stop the thread
+    void stop();
+
+    // Accept writes again after stop() and restart the thread
+    void resume();
+
+    // Group commit policy
+    void setCommitPolicy(int intervalMs, int maxOperations);
+    int commitInterval() const;
+    int maxBatchOperations() const;
+
+signals:
+    void groupCommitted(int operationCount, qint64 elapsedMs);
+    void commitFailed(const QString& error);
+
+protected:
+    void run() override;
+
+private:
+    struct PendingWrite {
+        Operation operation;
+        CommitCallback onCommitted;
+        std::shared_ptr<QPromise<bool>> promise;
+    };
+
+    void commitBatch(QList<PendingWrite>& batch);
+
+    DatabaseConnectionPool* m_connectionPool;
+
+    mutable QMutex m_queueMutex;
+    QWaitCondition m_queueCondition;
+    QQueue<PendingWrite> m_queue;
+    bool m_flushRequested;
+    bool m_stopRequested;
+
+    int m_commitIntervalMs;
+    int m_maxBatchOperations;
+};
@@ -0,0 +1,174 @@
+#include "DuplicateClusterer.h"
+#include <QHash>
+#include <algorithm>
+#include <numeric>
+
+// Cell coordinates are packed 21 bits apiece
+static const qint32 CELL_OFFSET = 1 << 20;
+static const quint64 CELL_MASK = (1u << 21) - 1;
+
+// Union-find with path halving
+static int findRoot(QVector<int>& parents, int item)
+{
+    while (parents[item] != item) {
+        parents[item] = parents[parents[item]];
+        item = parents[item];
+    }
+    return item;
+}
+
+DuplicateClusterer::DuplicateClusterer(double tolerance, int maxThumbnailDistance)
+    : m_tolerance(qMax(1e-6, tolerance))
+    , m_maxThumbnailDistance(qBound(0, maxThumbnailDistance, 64))
+{
+}
+
+quint64 DuplicateClusterer::thumbnailHash(const QImage& thumbnail)
+{
+    if (thumbnail.isNull()) {
+        return 0;
+    }
+
+    QImage reduced = thumbnail.convertToFormat(QImage::Format_Grayscale8)
+                         .scaled(9, 8, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    // A featureless image hashes to 0, the same as no hash
+    quint64 hash = 0;
+    for (int y = 0; y < 8; ++y) {
+        const uchar* row = reduced.constScanLine(y);
+        for (int x = 0; x < 8; ++x) {
+            hash = (hash << 1) | (row[x] > row[x + 1] ? 1 : 0);
+        }
+    }
+    return hash;
+}
+
+int DuplicateClusterer::hammingDistance(quint64 a, quint64 b)
+{
+    return qPopulationCount(a ^ b);
+}
+
+void DuplicateClusterer::add(const QUuid& id, const MeshFingerprint& fingerprint, quint64 thumbnailHash)
+{
+    if (!fingerprint.isValid() && thumbnailHash == 0) {
+        return;
+    }
+
+    m_ids.append(id);
+    m_fingerprints.append(fingerprint);
+    m_thumbnailHashes.append(thumbnailHash);
+}
+
+int DuplicateClusterer::size() const
+{
+    return m_ids.size();
+}
+
+QList<QList<QUuid>> DuplicateClusterer::clusters() const
+{
+    QVector<int> parents(m_ids.size());
+    std::iota(parents.begin(), parents.end(), 0);
+
+    auto merge = [&](int a, int b) {
+        int rootA = findRoot(parents, a);
+        int rootB = findRoot(parents, b);
+        if (rootA != rootB && nearDuplicates(a, b)) {
+            parents[qMax(rootA, rootB)] = qMin(rootA, rootB);
+        }
+    };
+
+    // Fingerprint grid: each pair is tried once, from its lower item
+    QHash<quint64, QVector<int>> cells;
+    for (int item = 0; item < m_ids.size(); ++item) {
+        if (m_fingerprints[item].isValid()) {
+            cells[cellKey(item, 0, 0, 0)].append(item);
+        }
+    }
+
+    for (int item = 0; item < m_ids.size(); ++item) {
+        if (!m_fingerprints[item].isValid()) {
+            continue;
+        }
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dz = -1; dz <= 1; ++dz) {
+                    auto cell = cells.constFind(cellKey(item, dx, dy, dz));
+                    if (cell == cells.constEnd()) {
+                        continue;
+                    }
+                    for (int other : cell.value()) {
+                        if (other > item) {
+                            merge(item, other);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Thumbnail bands, only needed for pairs where a fingerprint is missing
+    QHash<quint32, QVector<int>> bands;
+    for (int item = 0; item < m_ids.size(); ++item) {
+        quint64 hash = m_thumbnailHashes[item];
+        if (hash == 0) {
+            continue;
+        }
+        for (int band = 0; band < THUMBNAIL_BANDS; ++band) {
+            bands[(quint32(band) << 16) | quint32((hash >> (16 * band)) & 0xFFFF)].append(item);
+        }
+    }
+
+    for (int item = 0; item < m_ids.size(); ++item) {
+        quint64 hash = m_thumbnailHashes[item];
+        if (hash == 0 || m_fingerprints[item].isValid()) {
+            continue;
+        }
+        for (int band = 0; band < THUMBNAIL_BANDS; ++band) {
+            for (int other : bands.value((quint32(band) << 16) | quint32((hash >> (16 * band)) & 0xFFFF))) {
+                if (other != item) {
+                    merge(item, other);
+                }
+            }
+        }
+    }
+
+    QHash<int, QList<QUuid>> groups;
+    for (int item = 0; item < m_ids.size(); ++item) {
+        groups[findRoot(parents, item)].append(m_ids[item]);
+    }
+
+    QList<QList<QUuid>> clusters;
+    for (auto it = groups.constBegin(); it != groups.constEnd(); ++it) {
+        if (it.value().size() > 1) {
+            clusters.append(it.value());
+        }
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const QList<QUuid>& a, const QList<QUuid>& b) {
+        return a.size() > b.size();
+    });
+
+    return clusters;
+}
+
+bool DuplicateClusterer::nearDuplicates(int a, int b) const
+{
+    bool thumbnailsKnown = m_thumbnailHashes[a] != 0 && m_thumbnailHashes[b] != 0;
+    int thumbnailDistance = thumbnailsKnown ? hammingDistance(m_thumbnailHashes[a], m_thumbnailHashes[b]) : 0;
+
+    if (m_fingerprints[a].isValid() && m_fingerprints[b].isValid()) {
+        return m_fingerprints[a].matches(m_fingerprints[b], m_tolerance)
+               && thumbnailDistance <= m_maxThumbnailDistance;
+    }
+
+    // Looks alone are weak evidence, so only near-identical thumbnails count
+    return thumbnailsKnown && thumbnailDistance < THUMBNAIL_BANDS;
+}
+
+quint64 DuplicateClusterer::cellKey(int item, int dx, int dy, int dz) const
+{
+    const MeshFingerprint& fingerprint = m_fingerprints[item];
+    quint64 x = quint64(MeshFingerprint::quantise(fingerprint.area(), m_tolerance) + dx + CELL_OFFSET) & CELL_MASK;
+    quint64 y = quint64(MeshFingerprint::quantise(fingerprint.extents().x(), m_tolerance) + dy + CELL_OFFSET) & CELL_MASK;
+    quint64 z = quint64(MeshFingerprint::quantise(fingerprint.extents().y(), m_tolerance) + dz + CELL_OFFSET) & CELL_MASK;
+    return (x << 42) | (y << 21) | z;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "MeshFingerprint.h"
+#include <QUuid>
+#include <QImage>
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief Groups near-duplicate models across a whole catalogue
+ *
+ * Two models are near-duplicates when their mesh fingerprints match and,
+ * if both have thumbnail hashes, the thumbnails look alike too. A model
+ * without a fingerprint can only match on its thumbnail, under a stricter
+ * distance.
+ *
+ * Candidate pairs come from locality-sensitive buckets rather than from
+ * comparing every pair. Fingerprints are hashed to grid cells of
+ * quantised area and the two largest extents. Every match lies in the
+ * same or a neighbouring cell, so 27 cells are probed per model.
+ * Thumbnail hashes are split into four 16-bit bands. Hashes at most three
+ * bits apart share at least one band exactly. Only candidates are
+ * verified, and matches are merged with union-find, so the work grows
+ * with the catalogue times the typical bucket size.
+ */
+class DuplicateClusterer
+{
+public:
+    static const int THUMBNAIL_BANDS = 4;
+    static const int DEFAULT_THUMBNAIL_DISTANCE = 10;
+
+    explicit DuplicateClusterer(double tolerance = MeshFingerprint::DEFAULT_TOLERANCE,
+                                int maxThumbnailDistance = DEFAULT_THUMBNAIL_DISTANCE);
+
+    // 64-bit difference hash: each bit says whether a pixel of the 9x8
+    // greyscale reduction is brighter than its right neighbour. Small
+    // re-renders change few bits; 0 is reserved for "no hash"
+    static quint64 thumbnailHash(const QImage& thumbnail);
+    static int hammingDistance(quint64 a, quint64 b);
+
+    // fingerprint may be invalid and thumbnailHash 0 when unknown; models
+    // with neither are ignored
+    void add(const QUuid& id, const MeshFingerprint& fingerprint, quint64 thumbnailHash);
+    int size() const;
+
+    // Groups of two or more near-duplicates, largest first
+    QList<QList<QUuid>> clusters() const;
+
+private:
+    bool nearDuplicates(int a, int b) const;
+    quint64 cellKey(int item, int dx, int dy, int dz) const;
+
+    double m_tolerance;
+    int m_maxThumbnailDistance;
+
+    QVector<QUuid> m_ids;
+    QVector<MeshFingerprint> m_fingerprints;
+    QVector<quint64> m_thumbnailHashes;
+};
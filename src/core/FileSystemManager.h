@@ -31,7 +31,10 @@ public:
     virtual QString getExportsDirectory() const = 0;
 
     // File operations
-    virtual QString copyModelToStorage(const QString& sourcePath, const QString& filename = QString()) = 0;
+    // Copies through ContentHash::copyFile(); contentHash, when given, receives
+    // the hash of the bytes stored
+    virtual QString copyModelToStorage(const QString& sourcePath, const QString& filename = QString(),
+                                       QByteArray* contentHash = nullptr) = 0;
     virtual bool deleteModelFromStorage(const QString& modelId) = 0;
     virtual QString getModelFilePath(const QString& modelId) const = 0;
     virtual QString getThumbnailPath(const QString& modelId) const = 0;
@@ -0,0 +1,380 @@
+#include "HnswIndex.h"
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+static const quint64 LEVEL_SEED = 0x9E3779B97F4A7C15ull;
+static const int MAX_LEVEL = 16;
+
+HnswIndex::HnswIndex(int dimensions, int maxConnections, int constructionBreadth)
+    : m_dimensions(qMax(1, dimensions))
+    , m_maxConnections(qMax(2, maxConnections))
+    , m_constructionBreadth(qMax(m_maxConnections, constructionBreadth))
+    , m_levelScale(1.0 / std::log(static_cast<double>(qMax(2, maxConnections))))
+    , m_randomState(LEVEL_SEED)
+    , m_removed(0)
+    , m_entryPoint(-1)
+    , m_topLevel(0)
+{
+}
+
+void HnswIndex::add(const QString& key, const QVector<float>& vector)
+{
+    if (vector.size() != m_dimensions || key.isEmpty()) {
+        return;
+    }
+
+    remove(key);
+
+    quint32 node = static_cast<quint32>(m_keys.size());
+    m_vectors += vector;
+    m_keys.append(key);
+    m_links.append(QVector<QVector<quint32>>(randomLevel() + 1));
+    m_nodes.insert(key, node);
+
+    insertNode(node);
+}
+
+void HnswIndex::remove(const QString& key)
+{
+    auto it = m_nodes.find(key);
+    if (it == m_nodes.end()) {
+        return;
+    }
+
+    // The node keeps routing searches until the next rebuild
+    m_keys[it.value()].clear();
+    m_nodes.erase(it);
+    m_removed++;
+
+    if (m_nodes.isEmpty()) {
+        clear();
+    } else if (m_removed > m_nodes.size()) {
+        rebuild();
+    }
+}
+
+void HnswIndex::clear()
+{
+    m_vectors.clear();
+    m_keys.clear();
+    m_links.clear();
+    m_nodes.clear();
+    m_removed = 0;
+    m_entryPoint = -1;
+    m_topLevel = 0;
+    m_randomState = LEVEL_SEED;
+}
+
+bool HnswIndex::contains(const QString& key) const
+{
+    return m_nodes.contains(key);
+}
+
+int HnswIndex::size() const
+{
+    return m_nodes.size();
+}
+
+int HnswIndex::dimensions() const
+{
+    return m_dimensions;
+}
+
+qint64 HnswIndex::memoryUsage() const
+{
+    qint64 usage = m_vectors.capacity() * static_cast<qint64>(sizeof(float));
+    for (int node = 0; node < m_keys.size(); ++node) {
+        usage += m_keys[node].size() * 2 * 2;  // key list and node map
+        for (const QVector<quint32>& layer : m_links[node]) {
+            usage += layer.capacity() * static_cast<qint64>(sizeof(quint32));
+        }
+    }
+    return usage;
+}
+
+QVector<float> HnswIndex::vector(const QString& key) const
+{
+    auto it = m_nodes.constFind(key);
+    if (it == m_nodes.constEnd()) {
+        return QVector<float>();
+    }
+    return m_vectors.mid(static_cast<int>(it.value()) * m_dimensions, m_dimensions);
+}
+
+QList<HnswIndex::Neighbour> HnswIndex::search(const QVector<float>& query, int k, int searchBreadth) const
+{
+    QList<Neighbour> neighbours;
+    if (m_entryPoint < 0 || k <= 0 || query.size() != m_dimensions) {
+        return neighbours;
+    }
+
+    quint32 entry = greedyDescend(query.constData(), static_cast<quint32>(m_entryPoint), m_topLevel, 1);
+    QVector<Candidate> candidates = searchLayer(query.constData(), {entry}, qMax(k, searchBreadth), 0);
+
+    for (const Candidate& candidate : candidates) {
+        if (neighbours.size() >= k) {
+            break;
+        }
+        if (!m_keys[candidate.node].isEmpty()) {
+            neighbours.append({m_keys[candidate.node], candidate.distance});
+        }
+    }
+
+    return neighbours;
+}
+
+void HnswIndex::save(QDataStream& out) const
+{
+    out << qint32(m_dimensions) << m_vectors << m_keys << m_links
+        << qint32(m_removed) << m_entryPoint << qint32(m_topLevel) << m_randomState;
+}
+
+bool HnswIndex::load(QDataStream& in)
+{
+    clear();
+
+    qint32 dimensions = 0;
+    qint32 removed = 0;
+    qint32 topLevel = 0;
+    in >> dimensions >> m_vectors >> m_keys >> m_links >> removed >> m_entryPoint >> topLevel >> m_randomState;
+
+    bool consistent = in.status() == QDataStream::Ok && dimensions == m_dimensions
+                      && m_vectors.size() == m_keys.size() * m_dimensions && m_links.size() == m_keys.size()
+                      && m_entryPoint < m_keys.size() && (m_entryPoint >= 0 || m_keys.isEmpty());
+    if (consistent && m_entryPoint >= 0) {
+        consistent = m_links[m_entryPoint].size() == topLevel + 1;
+    }
+
+    // Every link must lead to a node that exists on that layer
+    for (int node = 0; consistent && node < m_links.size(); ++node) {
+        for (int layer = 0; consistent && layer < m_links[node].size(); ++layer) {
+            for (quint32 neighbour : m_links[node][layer]) {
+                if (neighbour >= static_cast<quint32>(m_links.size()) || m_links[neighbour].size() <= layer) {
+                    consistent = false;
+                    break;
+                }
+            }
+        }
+    }
+    if (!consistent) {
+        clear();
+        return false;
+    }
+
+    m_removed = removed;
+    m_topLevel = topLevel;
+    for (int node = 0; node < m_keys.size(); ++node) {
+        if (!m_keys[node].isEmpty()) {
+            m_nodes.insert(m_keys[node], static_cast<quint32>(node));
+        }
+    }
+    return true;
+}
+
+const float* HnswIndex::data(quint32 node) const
+{
+    return m_vectors.constData() + static_cast<qint64>(node) * m_dimensions;
+}
+
+float HnswIndex::distance(const float* query, quint32 node) const
+{
+    const float* vector = data(node);
+    float sum = 0.0f;
+    for (int i = 0; i < m_dimensions; ++i) {
+        float difference = query[i] - vector[i];
+        sum += difference * difference;
+    }
+    return std::sqrt(sum);
+}
+
+int HnswIndex::randomLevel()
+{
+    // xorshift64* scaled to [0, 1); levels fall off geometrically
+    m_randomState ^= m_randomState >> 12;
+    m_randomState ^= m_randomState << 25;
+    m_randomState ^= m_randomState >> 27;
+    double uniform = static_cast<double>((m_randomState * 0x2545F4914F6CDD1Dull) >> 11) / 9007199254740992.0;
+
+    int level = static_cast<int>(-std::log(1.0 - uniform) * m_levelScale);
+    return qMin(level, MAX_LEVEL);
+}
+
+quint32 HnswIndex::greedyDescend(const float* query, quint32 entry, int fromLevel, int toLevel) const
+{
+    quint32 current = entry;
+    float best = distance(query, current);
+
+    for (int level = fromLevel; level >= toLevel; --level) {
+        bool moved = true;
+        while (moved) {
+            moved = false;
+            for (quint32 neighbour : m_links[current][level]) {
+                float d = distance(query, neighbour);
+                if (d < best) {
+                    best = d;
+                    current = neighbour;
+                    moved = true;
+                }
+            }
+        }
+    }
+
+    return current;
+}
+
+QVector<HnswIndex::Candidate> HnswIndex::searchLayer(const float* query, const QVector<quint32>& entries,
+                                                     int breadth, int level) const
+{
+    // Frontier nearest first; results farthest first so the worst is dropped
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> frontier;
+    std::priority_queue<Candidate> results;
+    QSet<quint32> visited;
+    visited.reserve(breadth * m_maxConnections);
+
+    for (quint32 entry : entries) {
+        if (!visited.contains(entry)) {
+            visited.insert(entry);
+            Candidate candidate = {distance(query, entry), entry};
+            frontier.push(candidate);
+            results.push(candidate);
+        }
+    }
+    while (static_cast<int>(results.size()) > breadth) {
+        results.pop();
+    }
+
+    while (!frontier.empty()) {
+        Candidate nearest = frontier.top();
+        frontier.pop();
+
+        // Nothing closer can be reached once the frontier passes the worst result
+        if (static_cast<int>(results.size()) >= breadth && nearest.distance > results.top().distance) {
+            break;
+        }
+
+        for (quint32 neighbour : m_links[nearest.node][level]) {
+            if (visited.contains(neighbour)) {
+                continue;
+            }
+            visited.insert(neighbour);
+
+            float d = distance(query, neighbour);
+            if (static_cast<int>(results.size()) < breadth || d < results.top().distance) {
+                frontier.push({d, neighbour});
+                results.push({d, neighbour});
+                if (static_cast<int>(results.size()) > breadth) {
+                    results.pop();
+                }
+            }
+        }
+    }
+
+    QVector<Candidate> ordered(static_cast<int>(results.size()));
+    for (int i = ordered.size() - 1; i >= 0; --i) {
+        ordered[i] = results.top();
+        results.pop();
+    }
+    return ordered;
+}
+
+QVector<quint32> HnswIndex::selectNeighbours(QVector<Candidate> candidates, int maxCount) const
+{
+    std::sort(candidates.begin(), candidates.end());
+
+    // A candidate closer to an already chosen neighbour than to the base is
+    // reachable through it, so spread-out candidates are preferred
+    QVector<quint32> selected;
+    QVector<quint32> skipped;
+    for (const Candidate& candidate : candidates) {
+        if (selected.size() >= maxCount) {
+            break;
+        }
+
+        bool covered = false;
+        for (quint32 chosen : selected) {
+            if (distance(data(candidate.node), chosen) < candidate.distance) {
+                covered = true;
+                break;
+            }
+        }
+        (covered ? skipped : selected).append(candidate.node);
+    }
+
+    // Spare slots still take the nearest skipped candidates
+    for (int i = 0; i < skipped.size() && selected.size() < maxCount; ++i) {
+        selected.append(skipped[i]);
+    }
+
+    return selected;
+}
+
+void HnswIndex::connect(quint32 node, const QVector<quint32>& neighbours, int level)
+{
+    int maxCount = level == 0 ? 2 * m_maxConnections : m_maxConnections;
+    m_links[node][level] = neighbours;
+
+    for (quint32 neighbour : neighbours) {
+        QVector<quint32>& links = m_links[neighbour][level];
+        links.append(node);
+        if (links.size() <= maxCount) {
+            continue;
+        }
+
+        // Over capacity: keep the best spread of the neighbour's links
+        QVector<Candidate> candidates;
+        candidates.reserve(links.size());
+        for (quint32 link : links) {
+            candidates.append({distance(data(neighbour), link), link});
+        }
+        links = selectNeighbours(candidates, maxCount);
+    }
+}
+
+void HnswIndex::insertNode(quint32 node)
+{
+    int level = m_links[node].size() - 1;
+    if (m_entryPoint < 0) {
+        m_entryPoint = node;
+        m_topLevel = level;
+        return;
+    }
+
+    const float* query = data(node);
+    QVector<quint32> entries = {greedyDescend(query, static_cast<quint32>(m_entryPoint), m_topLevel, level + 1)};
+
+    for (int layer = qMin(level, m_topLevel); layer >= 0; --layer) {
+        QVector<Candidate> candidates = searchLayer(query, entries, m_constructionBreadth, layer);
+        connect(node, selectNeighbours(candidates, m_maxConnections), layer);
+
+        entries.clear();
+        for (const Candidate& candidate : candidates) {
+            entries.append(candidate.node);
+        }
+    }
+
+    if (level > m_topLevel) {
+        m_entryPoint = node;
+        m_topLevel = level;
+    }
+}
+
+void HnswIndex::rebuild()
+{
+    QVector<QString> keys;
+    QVector<float> vectors;
+    for (int node = 0; node < m_keys.size(); ++node) {
+        if (!m_keys[node].isEmpty()) {
+            keys.append(m_keys[node]);
+            vectors += m_vectors.mid(node * m_dimensions, m_dimensions);
+        }
+    }
+
+    clear();
+    for (int i = 0; i < keys.size(); ++i) {
+        add(keys[i], vectors.mid(i * m_dimensions, m_dimensions));
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QList>
+#include <QDataStream>
+
+/**
+ * @brief Approximate nearest neighbours over fixed-length float vectors (HNSW)
+ *
+ * Every vector is a node in a stack of proximity graphs: all nodes sit on
+ * layer 0 and each higher layer keeps a random, geometrically shrinking
+ * subset. A search descends greedily through the sparse upper layers to a
+ * good entry point, then runs a bounded best-first walk on layer 0, so a
+ * query visits a few hundred nodes however many are indexed. Neighbour
+ * lists are chosen to spread out around a node rather than cluster on one
+ * side, which keeps the walk from getting stuck. Level draws come from a
+ * fixed seed, so the same insertions always build the same graph.
+ *
+ * Removing or replacing a key leaves a tombstone that is still walked but
+ * never returned; the graph is rebuilt once tombstones outnumber live nodes.
+ */
+class HnswIndex
+{
+public:
+    struct Neighbour {
+        QString key;
+        float distance;
+    };
+
+    explicit HnswIndex(int dimensions, int maxConnections = 16, int constructionBreadth = 100);
+
+    // Adds or replaces the vector stored under key; vectors of the wrong length are ignored
+    void add(const QString& key, const QVector<float>& vector);
+    void remove(const QString& key);
+    void clear();
+
+    bool contains(const QString& key) const;
+    int size() const;
+    int dimensions() const;
+    qint64 memoryUsage() const;
+
+    QVector<float> vector(const QString& key) const;
+
+    // Up to k nearest live vectors by Euclidean distance, closest first;
+    // searchBreadth (at least k) trades time for recall
+    QList<Neighbour> search(const QVector<float>& query, int k, int searchBreadth = 64) const;
+
+    // The graph is stored as built, so loading does no distance work;
+    // load() fails on a stream written with different dimensions
+    void save(QDataStream& out) const;
+    bool load(QDataStream& in);
+
+private:
+    struct Candidate {
+        float distance;
+        quint32 node;
+        bool operator<(const Candidate& other) const { return distance < other.distance; }
+        bool operator>(const Candidate& other) const { return distance > other.distance; }
+    };
+
+    float distance(const float* query, quint32 node) const;
+    const float* data(quint32 node) const;
+
+    int randomLevel();
+    quint32 greedyDescend(const float* query, quint32 entry, int fromLevel, int toLevel) const;
+    QVector<Candidate> searchLayer(const float* query, const QVector<quint32>& entries, int breadth, int level) const;
+    QVector<quint32> selectNeighbours(QVector<Candidate> candidates, int maxCount) const;
+    void connect(quint32 node, const QVector<quint32>& neighbours, int level);
+    void insertNode(quint32 node);
+    void rebuild();
+
+    int m_dimensions;
+    int m_maxConnections;      // per node on upper layers; twice this on layer 0
+    int m_constructionBreadth;
+    double m_levelScale;       // 1 / ln(maxConnections)
+    quint64 m_randomState;
+
+    QVector<float> m_vectors;               // node -> dimensions floats
+    QVector<QString> m_keys;                // node -> key, empty once removed
+    QVector<QVector<QVector<quint32>>> m_links;  // node -> layer -> neighbours
+    QHash<QString, quint32> m_nodes;        // key -> live node
+    int m_removed;
+    qint64 m_entryPoint;                    // -1 while empty
+    int m_topLevel;
+};
@@ -0,0 +1,842 @@
+#include "InvertedIndex.h"
+#include <QRegularExpression>
+#include <QPair>
+#include <QtConcurrent>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <vector>
+#include <cmath>
+
+// BM25 term-frequency saturation and length normalisation
+static const qreal BM25_K1 = 1.2;
+static const qreal BM25_B = 0.75;
+
+// Retired ids tolerated before the postings are rewritten
+static const int MIN_RETIRED_BEFORE_COMPACT = 1024;
+
+// Documents visited between polls of a cancellation check
+static const int CANCEL_POLL_INTERVAL = 256;
+
+// Smaller indexes are not worth splitting across threads
+static const int MIN_DOCUMENTS_PER_SHARD = 16384;
+
+namespace {
+
+using Scored = std::pair<qreal, quint32>;
+
+// Bounded min-heap holding the best (score, doc) pairs seen so far. Equal
+// scores are ordered by doc id, so the kept set does not depend on the order
+// documents are visited in
+class TopDocuments
+{
+public:
+    explicit TopDocuments(int capacity) : m_capacity(capacity) {}
+
+    void offer(qreal score, quint32 doc)
+    {
+        Scored scored(score, doc);
+        if (static_cast<int>(m_best.size()) < m_capacity) {
+            m_best.push(scored);
+        } else if (scored > m_best.top()) {
+            m_best.pop();
+            m_best.push(scored);
+        }
+    }
+
+    // Drains the heap, in no particular order
+    std::vector<Scored> take()
+    {
+        std::vector<Scored> best;
+        best.reserve(m_best.size());
+        while (!m_best.empty()) {
+            best.push_back(m_best.top());
+            m_best.pop();
+        }
+        return best;
+    }
+
+private:
+    std::priority_queue<Scored, std::vector<Scored>, std::greater<Scored>> m_best;
+    int m_capacity;
+};
+
+}
+
+// One contiguous doc id range of a search and what was found in it
+struct InvertedIndex::Shard {
+    quint32 begin = 0;
+    quint32 end = 0;
+    std::vector<Scored> best;
+    QVector<quint32> docs;  // every match, when collected
+    bool cancelled = false;
+};
+
+PostingList::PostingList()
+    : m_count(0)
+{
+}
+
+void PostingList::append(quint32 docId, quint32 frequency)
+{
+    if (m_blocks.isEmpty() || m_blocks.last().count == BLOCK_SIZE) {
+        m_blocks.append({docId, docId, static_cast<int>(m_data.size()), 0});
+    }
+
+    // The first entry of a block encodes a zero delta from its firstDoc
+    Block& block = m_blocks.last();
+    writeVarint(m_data, docId - block.lastDoc);
+    writeVarint(m_data, frequency);
+    block.lastDoc = docId;
+    block.count++;
+    m_count++;
+}
+
+int PostingList::count() const
+{
+    return m_count;
+}
+
+qint64 PostingList::byteSize() const
+{
+    return m_data.capacity() + m_blocks.capacity() * static_cast<qint64>(sizeof(Block));
+}
+
+void PostingList::save(QDataStream& out) const
+{
+    out << qint32(m_count) << qint32(m_blocks.size());
+    for (const Block& block : m_blocks) {
+        out << block.firstDoc << block.lastDoc << qint32(block.offset) << qint32(block.count);
+    }
+
+    out << qint32(m_data.size());
+    out.writeRawData(m_data.constData(), static_cast<int>(m_data.size()));
+}
+
+bool PostingList::load(QDataStream& in, const QByteArray& backing)
+{
+    qint32 count = 0;
+    qint32 blockCount = 0;
+    in >> count >> blockCount;
+    if (in.status() != QDataStream::Ok || count < 0 || blockCount < 0) {
+        return false;
+    }
+
+    QVector<Block> blocks;
+    blocks.reserve(blockCount);
+    for (qint32 i = 0; i < blockCount; ++i) {
+        Block block;
+        qint32 offset = 0;
+        qint32 entries = 0;
+        in >> block.firstDoc >> block.lastDoc >> offset >> entries;
+        block.offset = offset;
+        block.count = entries;
+        blocks.append(block);
+    }
+
+    qint32 size = 0;
+    in >> size;
+    qint64 position = in.device()->pos();
+    if (in.status() != QDataStream::Ok || size < 0 || position + size > backing.size()) {
+        return false;
+    }
+    for (const Block& block : blocks) {
+        if (block.offset < 0 || block.offset > size || block.count <= 0 || block.count > BLOCK_SIZE) {
+            return false;
+        }
+    }
+
+    m_data = QByteArray::fromRawData(backing.constData() + position, size);
+    m_blocks = blocks;
+    m_count = count;
+    return in.skipRawData(size) == size;
+}
+
+void PostingList::detach()
+{
+    m_data = QByteArray(m_data.constData(), m_data.size());
+}
+
+void PostingList::writeVarint(QByteArray& data, quint32 value)
+{
+    while (value >= 0x80) {
+        data.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    data.append(static_cast<char>(value));
+}
+
+quint32 PostingList::readVarint(const QByteArray& data, int& offset)
+{
+    quint32 value = 0;
+    int shift = 0;
+    quint8 byte;
+    do {
+        byte = static_cast<quint8>(data[offset++]);
+        value |= static_cast<quint32>(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+PostingList::Cursor::Cursor(const PostingList* list)
+    : m_list(list)
+    , m_block(0)
+    , m_indexInBlock(0)
+    , m_offset(0)
+    , m_doc(0)
+    , m_frequency(0)
+    , m_atEnd(list->m_count == 0)
+{
+    if (!m_atEnd) {
+        loadBlock(0);
+    }
+}
+
+bool PostingList::Cursor::atEnd() const
+{
+    return m_atEnd;
+}
+
+quint32 PostingList::Cursor::doc() const
+{
+    return m_doc;
+}
+
+quint32 PostingList::Cursor::frequency() const
+{
+    return m_frequency;
+}
+
+int PostingList::Cursor::size() const
+{
+    return m_list->m_count;
+}
+
+void PostingList::Cursor::next()
+{
+    if (m_atEnd) {
+        return;
+    }
+
+    if (m_indexInBlock + 1 < m_list->m_blocks[m_block].count) {
+        decodeNext();
+    } else if (m_block + 1 < m_list->m_blocks.size()) {
+        loadBlock(m_block + 1);
+    } else {
+        m_atEnd = true;
+    }
+}
+
+void PostingList::Cursor::advanceTo(quint32 target)
+{
+    if (m_atEnd || m_doc >= target) {
+        return;
+    }
+
+    const QVector<Block>& blocks = m_list->m_blocks;
+
+    if (blocks[m_block].lastDoc < target) {
+        // Gallop over the skip table, then binary search the final stride
+        int low = m_block + 1;
+        int high = low;
+        int step = 1;
+        while (high < blocks.size() && blocks[high].lastDoc < target) {
+            low = high + 1;
+            high += step;
+            step *= 2;
+        }
+
+        if (low >= blocks.size()) {
+            m_atEnd = true;
+            return;
+        }
+
+        high = qMin(high, static_cast<int>(blocks.size()) - 1);
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (blocks[mid].lastDoc < target) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        if (blocks[low].lastDoc < target) {
+            m_atEnd = true;
+            return;
+        }
+
+        loadBlock(low);
+    }
+
+    // The target is inside the current block
+    while (m_doc < target) {
+        decodeNext();
+    }
+}
+
+void PostingList::Cursor::loadBlock(int block)
+{
+    const Block& header = m_list->m_blocks[block];
+    m_block = block;
+    m_indexInBlock = -1;
+    m_offset = header.offset;
+    m_doc = header.firstDoc;
+    decodeNext();
+}
+
+void PostingList::Cursor::decodeNext()
+{
+    m_doc += readVarint(m_list->m_data, m_offset);
+    m_frequency = readVarint(m_list->m_data, m_offset);
+    m_indexInBlock++;
+}
+
+InvertedIndex::InvertedIndex()
+    : m_shardCount(1)
+    , m_retiredDocuments(0)
+    , m_totalLength(0)
+{
+}
+
+void InvertedIndex::addDocument(const QString& key, const QString& text)
+{
+    if (m_docIds.contains(key)) {
+        removeDocument(key);
+    }
+
+    QStringList tokens = tokenize(text);
+
+    QHash<QString, quint32> frequencies;
+    for (const QString& token : tokens) {
+        frequencies[token]++;
+    }
+
+    // New ids are always the largest so far, which keeps every list sorted
+    quint32 docId = static_cast<quint32>(m_docKeys.size());
+    for (auto it = frequencies.constBegin(); it != frequencies.constEnd(); ++it) {
+        m_postings[it.key()].append(docId, it.value());
+    }
+
+    m_docKeys.append(key);
+    m_docLengths.append(static_cast<quint32>(tokens.size()));
+    m_docIds.insert(key, docId);
+    m_totalLength += tokens.size();
+}
+
+void InvertedIndex::removeDocument(const QString& key)
+{
+    auto it = m_docIds.find(key);
+    if (it == m_docIds.end()) {
+        return;
+    }
+
+    // Postings keep the id until the next compaction; searches skip it
+    quint32 docId = it.value();
+    m_docIds.erase(it);
+    m_docKeys[docId].clear();
+    m_totalLength -= m_docLengths[docId];
+    m_retiredDocuments++;
+
+    if (m_retiredDocuments >= MIN_RETIRED_BEFORE_COMPACT && m_retiredDocuments > m_docIds.size()) {
+        compact();
+    }
+}
+
+void InvertedIndex::clear()
+{
+    m_postings.clear();
+    m_docIds.clear();
+    m_docKeys.clear();
+    m_docLengths.clear();
+    m_retiredDocuments = 0;
+    m_totalLength = 0;
+    m_mappedFile.reset();
+}
+
+bool InvertedIndex::contains(const QString& key) const
+{
+    return m_docIds.contains(key);
+}
+
+QString InvertedIndex::key(quint32 doc) const
+{
+    return doc < static_cast<quint32>(m_docKeys.size()) ? m_docKeys[doc] : QString();
+}
+
+int InvertedIndex::documentCount() const
+{
+    return m_docIds.size();
+}
+
+qint64 InvertedIndex::memoryUsage() const
+{
+    qint64 usage = m_docKeys.capacity() * static_cast<qint64>(sizeof(QString))
+                 + m_docLengths.capacity() * static_cast<qint64>(sizeof(quint32));
+
+    for (auto it = m_postings.constBegin(); it != m_postings.constEnd(); ++it) {
+        usage += it.key().size() * static_cast<qint64>(sizeof(QChar)) + it.value().byteSize();
+    }
+    for (const QString& key : m_docKeys) {
+        usage += key.size() * static_cast<qint64>(sizeof(QChar)) * 2;  // key list and id map
+    }
+
+    return usage;
+}
+
+QList<InvertedIndex::Hit> InvertedIndex::search(const QStringList& terms, int maxResults, bool prefixLast,
+                                                const Filter& accept, Matches* matched,
+                                                const Cancelled& cancelled) const
+{
+    bool truncated = false;
+    QList<QStringList> termSets = expandTerms(terms, prefixLast, &truncated);
+
+    QList<Hit> hits = runShards(termSets, nullptr, maxResults, accept, matched, cancelled);
+    if (matched && truncated) {
+        matched->complete = false;
+    }
+    return hits;
+}
+
+QList<InvertedIndex::Hit> InvertedIndex::searchAlternatives(const QList<QStringList>& termSets, int maxResults,
+                                                            const Filter& accept, Matches* matched,
+                                                            const Cancelled& cancelled) const
+{
+    return runShards(termSets, nullptr, maxResults, accept, matched, cancelled);
+}
+
+QList<InvertedIndex::Hit> InvertedIndex::refine(const QVector<quint32>& candidates, const QStringList& terms,
+                                                int maxResults, bool prefixLast, const Filter& accept,
+                                                Matches* matched, const Cancelled& cancelled) const
+{
+    bool truncated = false;
+    QList<QStringList> termSets = expandTerms(terms, prefixLast, &truncated);
+
+    QList<Hit> hits = runShards(termSets, &candidates, maxResults, accept, matched, cancelled);
+    if (matched && truncated) {
+        matched->complete = false;
+    }
+    return hits;
+}
+
+QStringList InvertedIndex::terms() const
+{
+    return m_postings.keys();
+}
+
+void InvertedIndex::save(QDataStream& out) const
+{
+    out << m_docKeys << m_docLengths << m_totalLength << qint32(m_retiredDocuments);
+
+    out << qint32(m_postings.size());
+    for (auto it = m_postings.constBegin(); it != m_postings.constEnd(); ++it) {
+        out << it.key();
+        it.value().save(out);
+    }
+}
+
+bool InvertedIndex::load(QDataStream& in, const QByteArray& backing, const QSharedPointer<QFile>& mappedFile)
+{
+    clear();
+
+    qint32 retired = 0;
+    qint32 termCount = 0;
+    in >> m_docKeys >> m_docLengths >> m_totalLength >> retired >> termCount;
+    if (in.status() != QDataStream::Ok || m_docKeys.size() != m_docLengths.size() || termCount < 0) {
+        clear();
+        return false;
+    }
+
+    m_retiredDocuments = retired;
+    for (int docId = 0; docId < m_docKeys.size(); ++docId) {
+        if (!m_docKeys[docId].isEmpty()) {
+            m_docIds.insert(m_docKeys[docId], static_cast<quint32>(docId));
+        }
+    }
+
+    // Keys arrive sorted, so each insert lands at the end of the map
+    for (qint32 i = 0; i < termCount; ++i) {
+        QString term;
+        in >> term;
+
+        PostingList list;
+        if (!list.load(in, backing)) {
+            clear();
+            return false;
+        }
+        m_postings.insert(m_postings.constEnd(), term, list);
+    }
+
+    m_mappedFile = mappedFile;
+    return true;
+}
+
+void InvertedIndex::detach()
+{
+    if (!m_mappedFile) {
+        return;
+    }
+
+    // Unlike compact(), ids are kept, so earlier Matches stay valid
+    for (auto it = m_postings.begin(); it != m_postings.end(); ++it) {
+        it.value().detach();
+    }
+    m_mappedFile.reset();
+}
+
+void InvertedIndex::setShardCount(int shards)
+{
+    m_shardCount = qMax(1, shards);
+}
+
+int InvertedIndex::shardCount() const
+{
+    return m_shardCount;
+}
+
+QList<QStringList> InvertedIndex::expandTerms(const QStringList& terms, bool prefixLast, bool* truncated) const
+{
+    QList<QStringList> termSets;
+    for (int i = 0; i < terms.size(); ++i) {
+        termSets.append(prefixLast && i == terms.size() - 1 ? prefixTerms(terms[i], truncated) : QStringList{terms[i]});
+    }
+    return termSets;
+}
+
+QList<InvertedIndex::Hit> InvertedIndex::runShards(const QList<QStringList>& termSets,
+                                                   const QVector<quint32>* candidates, int maxResults,
+                                                   const Filter& accept, Matches* matched,
+                                                   const Cancelled& cancelled) const
+{
+    QList<Hit> hits;
+    if (matched) {
+        matched->docs.clear();
+        matched->complete = true;
+    }
+    if (termSets.isEmpty() || maxResults <= 0 || m_docIds.isEmpty() || (candidates && candidates->isEmpty())) {
+        return hits;
+    }
+
+    // Document frequencies are taken over the whole index, so every shard
+    // scores a document exactly as an unsharded search would. A set with no
+    // indexed term empties an AND query
+    QVector<qreal> idf;
+    for (const QStringList& termSet : termSets) {
+        qint64 frequency = 0;
+        for (const QString& term : termSet) {
+            auto it = m_postings.constFind(term);
+            if (it != m_postings.constEnd()) {
+                frequency += it.value().count();
+            }
+        }
+        if (frequency == 0) {
+            return hits;
+        }
+        idf.append(inverseFrequency(frequency));
+    }
+
+    // Contiguous id ranges, so each shard's matches come out in ascending order
+    qint64 docSpace = m_docKeys.size();
+    int count = qMax(1, qMin<int>(m_shardCount, static_cast<int>(docSpace / MIN_DOCUMENTS_PER_SHARD)));
+    std::vector<Shard> shards(count);
+    for (int i = 0; i < count; ++i) {
+        shards[i].begin = static_cast<quint32>(docSpace * i / count);
+        shards[i].end = static_cast<quint32>(docSpace * (i + 1) / count);
+    }
+
+    auto scan = [&](Shard& shard) {
+        if (candidates) {
+            refineShard(*candidates, termSets, idf, maxResults, accept, cancelled, matched != nullptr, shard);
+        } else {
+            scanShard(termSets, idf, maxResults, accept, cancelled, matched != nullptr, shard);
+        }
+    };
+
+    if (count == 1) {
+        scan(shards[0]);
+    } else {
+        QtConcurrent::blockingMap(shards, scan);
+    }
+
+    // (score, doc) is a total order, so the merged top hits do not depend on the split
+    std::vector<Scored> best;
+    for (const Shard& shard : shards) {
+        if (shard.cancelled) {
+            if (matched) {
+                matched->docs.clear();
+                matched->complete = false;
+            }
+            return hits;
+        }
+        best.insert(best.end(), shard.best.begin(), shard.best.end());
+        if (matched) {
+            matched->docs += shard.docs;
+        }
+    }
+
+    std::sort(best.begin(), best.end(), std::greater<Scored>());
+    int kept = qMin(maxResults, static_cast<int>(best.size()));
+    hits.reserve(kept);
+    for (int i = 0; i < kept; ++i) {
+        hits.append({m_docKeys[best[i].second], best[i].first});
+    }
+
+    return hits;
+}
+
+void InvertedIndex::scanShard(const QList<QStringList>& termSets, const QVector<qreal>& idf, int maxResults,
+                              const Filter& accept, const Cancelled& cancelled, bool collect,
+                              Shard& shard) const
+{
+    // Resolve every set to one posting list over the shard's range
+    std::vector<PostingList> merged;
+    merged.reserve(termSets.size());
+    std::vector<PostingList::Cursor> cursors;
+    cursors.reserve(termSets.size());
+    for (const QStringList& termSet : termSets) {
+        QList<const PostingList*> alternatives;
+        for (const QString& term : termSet) {
+            auto it = m_postings.constFind(term);
+            if (it != m_postings.constEnd()) {
+                alternatives.append(&it.value());
+            }
+        }
+
+        if (alternatives.size() == 1) {
+            cursors.emplace_back(alternatives.first());
+        } else {
+            merged.emplace_back();
+            unionPostings(alternatives, shard.begin, shard.end, merged.back());
+            cursors.emplace_back(&merged.back());
+        }
+
+        cursors.back().advanceTo(shard.begin);
+        if (cursors.back().atEnd()) {
+            return;
+        }
+    }
+
+    // The rarest term leads; the others only ever skip forward to it. Scores
+    // are still summed in term order so they match refineShard() bit for bit
+    QVector<int> order(static_cast<int>(cursors.size()));
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&cursors](int a, int b) {
+        return cursors[a].size() < cursors[b].size();
+    });
+
+    TopDocuments best(maxResults);
+
+    PostingList::Cursor& lead = cursors[order[0]];
+    bool exhausted = false;
+    int steps = 0;
+    while (!exhausted && !lead.atEnd() && lead.doc() < shard.end) {
+        if (cancelled && ++steps % CANCEL_POLL_INTERVAL == 0 && cancelled()) {
+            shard.cancelled = true;
+            return;
+        }
+
+        quint32 doc = lead.doc();
+
+        // Leapfrog: any cursor that overshoots becomes the lead's next target
+        int agreed = 1;
+        for (; agreed < order.size(); ++agreed) {
+            PostingList::Cursor& cursor = cursors[order[agreed]];
+            cursor.advanceTo(doc);
+            if (cursor.atEnd()) {
+                exhausted = true;
+                break;
+            }
+            if (cursor.doc() != doc) {
+                lead.advanceTo(cursor.doc());
+                break;
+            }
+        }
+
+        if (agreed < order.size()) {
+            continue;
+        }
+
+        if (!m_docKeys[doc].isEmpty() && (!accept || accept(m_docKeys[doc]))) {
+            qreal norm = lengthNorm(doc);
+            qreal score = 0.0;
+            for (size_t i = 0; i < cursors.size(); ++i) {
+                qreal tf = cursors[i].frequency();
+                score += idf[static_cast<int>(i)] * tf * (BM25_K1 + 1.0) / (tf + norm);
+            }
+
+            best.offer(score, doc);
+            if (collect) {
+                shard.docs.append(doc);
+            }
+        }
+
+        lead.next();
+    }
+
+    shard.best = best.take();
+}
+
+void InvertedIndex::refineShard(const QVector<quint32>& candidates, const QList<QStringList>& termSets,
+                                const QVector<qreal>& idf, int maxResults, const Filter& accept,
+                                const Cancelled& cancelled, bool collect, Shard& shard) const
+{
+    // One cursor per alternative: with few candidates, skipping each list to
+    // them is cheaper than merging the lists of a short prefix
+    std::vector<std::vector<PostingList::Cursor>> termCursors;
+    for (const QStringList& termSet : termSets) {
+        std::vector<PostingList::Cursor> cursors;
+        for (const QString& term : termSet) {
+            auto it = m_postings.constFind(term);
+            if (it != m_postings.constEnd()) {
+                cursors.emplace_back(&it.value());
+            }
+        }
+        termCursors.push_back(std::move(cursors));
+    }
+
+    TopDocuments best(maxResults);
+
+    auto first = std::lower_bound(candidates.constBegin(), candidates.constEnd(), shard.begin);
+    auto last = std::lower_bound(first, candidates.constEnd(), shard.end);
+
+    int steps = 0;
+    for (auto it = first; it != last; ++it) {
+        if (cancelled && ++steps % CANCEL_POLL_INTERVAL == 0 && cancelled()) {
+            shard.cancelled = true;
+            return;
+        }
+
+        quint32 doc = *it;
+        if (m_docKeys[doc].isEmpty() || (accept && !accept(m_docKeys[doc]))) {
+            continue;
+        }
+
+        qreal norm = lengthNorm(doc);
+        qreal score = 0.0;
+        bool matches = true;
+        for (size_t i = 0; i < termCursors.size() && matches; ++i) {
+            qreal tf = 0.0;
+            for (PostingList::Cursor& cursor : termCursors[i]) {
+                cursor.advanceTo(doc);
+                if (!cursor.atEnd() && cursor.doc() == doc) {
+                    tf += cursor.frequency();
+                }
+            }
+
+            matches = tf > 0.0;
+            score += idf[static_cast<int>(i)] * tf * (BM25_K1 + 1.0) / (tf + norm);
+        }
+
+        if (matches) {
+            best.offer(score, doc);
+            if (collect) {
+                shard.docs.append(doc);
+            }
+        }
+    }
+
+    shard.best = best.take();
+}
+
+QStringList InvertedIndex::prefixTerms(const QString& prefix, bool* truncated) const
+{
+    QStringList expansions;
+    auto it = m_postings.lowerBound(prefix);
+    for (; it != m_postings.constEnd() && it.key().startsWith(prefix) && expansions.size() < MAX_PREFIX_EXPANSIONS;
+         ++it) {
+        expansions.append(it.key());
+    }
+
+    if (truncated && it != m_postings.constEnd() && it.key().startsWith(prefix)) {
+        *truncated = true;
+    }
+    return expansions;
+}
+
+qreal InvertedIndex::inverseFrequency(qint64 frequency) const
+{
+    // Alternatives count every list they appear in; computing the exact union
+    // would mean merging lists that refine() deliberately leaves apart
+    qreal documents = m_docIds.size();
+    qreal clamped = qMin<qreal>(frequency, documents);
+    return std::log(1.0 + (documents - clamped + 0.5) / (clamped + 0.5));
+}
+
+qreal InvertedIndex::lengthNorm(quint32 doc) const
+{
+    qreal averageLength = qMax<qreal>(1.0, static_cast<qreal>(m_totalLength) / m_docIds.size());
+    return BM25_K1 * (1.0 - BM25_B + BM25_B * m_docLengths[doc] / averageLength);
+}
+
+void InvertedIndex::unionPostings(const QList<const PostingList*>& lists, quint32 begin, quint32 end,
+                                  PostingList& merged)
+{
+    // Sum frequencies per doc so a document matching several alternatives scores higher
+    QVector<QPair<quint32, quint32>> entries;
+    for (const PostingList* list : lists) {
+        PostingList::Cursor cursor(list);
+        for (cursor.advanceTo(begin); !cursor.atEnd() && cursor.doc() < end; cursor.next()) {
+            entries.append(qMakePair(cursor.doc(), cursor.frequency()));
+        }
+    }
+
+    std::sort(entries.begin(), entries.end());
+    for (int i = 0; i < entries.size();) {
+        quint32 doc = entries[i].first;
+        quint32 frequency = 0;
+        for (; i < entries.size() && entries[i].first == doc; ++i) {
+            frequency += entries[i].second;
+        }
+        merged.append(doc, frequency);
+    }
+}
+
+void InvertedIndex::compact()
+{
+    // Renumber live documents in order so rewritten lists stay sorted
+    QVector<quint32> remap(m_docKeys.size(), 0);
+    QVector<QString> docKeys;
+    QVector<quint32> docLengths;
+    docKeys.reserve(m_docIds.size());
+    docLengths.reserve(m_docIds.size());
+
+    for (int oldId = 0; oldId < m_docKeys.size(); ++oldId) {
+        if (!m_docKeys[oldId].isEmpty()) {
+            remap[oldId] = static_cast<quint32>(docKeys.size());
+            m_docIds[m_docKeys[oldId]] = remap[oldId];
+            docKeys.append(m_docKeys[oldId]);
+            docLengths.append(m_docLengths[oldId]);
+        }
+    }
+
+    for (auto it = m_postings.begin(); it != m_postings.end();) {
+        PostingList rewritten;
+        for (PostingList::Cursor cursor(&it.value()); !cursor.atEnd(); cursor.next()) {
+            if (!m_docKeys[cursor.doc()].isEmpty()) {
+                rewritten.append(remap[cursor.doc()], cursor.frequency());
+            }
+        }
+
+        if (rewritten.count() == 0) {
+            it = m_postings.erase(it);
+        } else {
+            it.value() = rewritten;
+            ++it;
+        }
+    }
+
+    m_docKeys = docKeys;
+    m_docLengths = docLengths;
+    m_retiredDocuments = 0;
+
+    // Every list was rewritten into owned memory
+    m_mappedFile.reset();
+}
+
+QStringList InvertedIndex::tokenize(const QString& text)
+{
+    static const QRegularExpression separators("[^\\p{L}\\p{N}]+");
+    return text.toLower().split(separators, Qt::SkipEmptyParts);
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QList>
+#include <QDataStream>
+#include <QFile>
+#include <QSharedPointer>
+#include <functional>
+
+/**
+ * @brief Sorted doc-id postings stored as varint deltas in fixed-size blocks
+ *
+ * Each block records its first and last doc id and its byte offset, so a
+ * cursor can skip whole blocks and only decode the one that may hold its
+ * target. Doc ids must be appended in increasing order.
+ */
+class PostingList
+{
+public:
+    static const int BLOCK_SIZE = 128;
+
+    PostingList();
+
+    void append(quint32 docId, quint32 frequency);
+    int count() const;
+    qint64 byteSize() const;
+
+    // The encoded entries are written raw. load() reads from a stream over
+    // backing and refers to them in place rather than copying; backing must
+    // outlive the list, and the first append() or detach() takes a private copy
+    void save(QDataStream& out) const;
+    bool load(QDataStream& in, const QByteArray& backing);
+    void detach();
+
+    class Cursor
+    {
+    public:
+        explicit Cursor(const PostingList* list);
+
+        bool atEnd() const;
+        quint32 doc() const;
+        quint32 frequency() const;
+        int size() const;
+
+        void next();
+
+        // Move to the first entry with doc >= target, galloping over the blocks
+        void advanceTo(quint32 target);
+
+    private:
+        void loadBlock(int block);
+        void decodeNext();
+
+        const PostingList* m_list;
+        int m_block;
+        int m_indexInBlock;
+        int m_offset;
+        quint32 m_doc;
+        quint32 m_frequency;
+        bool m_atEnd;
+    };
+
+private:
+    struct Block {
+        quint32 firstDoc;
+        quint32 lastDoc;
+        int offset;
+        int count;
+    };
+
+    static void writeVarint(QByteArray& data, quint32 value);
+    static quint32 readVarint(const QByteArray& data, int& offset);
+
+    QByteArray m_data;
+    QVector<Block> m_blocks;
+    int m_count;
+};
+
+/**
+ * @brief Tokenised term -> postings index with BM25 top-k retrieval
+ *
+ * Documents are addressed by string key and given dense internal ids in
+ * insertion order. Queries intersect the postings of every term, driven by
+ * the shortest list, and keep only the best maxResults hits in a bounded
+ * heap, so cost follows the rarest term rather than the catalogue size.
+ * Large indexes are searched as several doc id ranges in parallel, each with
+ * its own heap; the merged hits are the same for any shard count.
+ * Re-indexing a key retires its old id; retired ids are dropped from the
+ * postings once they outnumber the live documents.
+ */
+class InvertedIndex
+{
+public:
+    struct Hit {
+        QString key;
+        qreal score;
+    };
+
+    // Most dictionary terms a trailing prefix may expand to
+    static const int MAX_PREFIX_EXPANSIONS = 128;
+
+    // Every document a search matched, so a narrower follow-up query can be
+    // answered by re-scoring only these. Ids are internal and only valid until
+    // the index is next modified
+    struct Matches {
+        QVector<quint32> docs;  // ascending
+        bool complete = true;   // false when a prefix had more expansions than were searched
+    };
+
+    InvertedIndex();
+
+    void addDocument(const QString& key, const QString& text);
+    void removeDocument(const QString& key);
+    void clear();
+
+    bool contains(const QString& key) const;
+    int documentCount() const;
+
+    // Key of an internal id from Matches; empty once the document is retired
+    QString key(quint32 doc) const;
+    qint64 memoryUsage() const;
+
+    // Rejects documents by key before they are scored
+    using Filter = std::function<bool(const QString& key)>;
+
+    // Polled during a scan; once it returns true the search gives up with no hits
+    using Cancelled = std::function<bool()>;
+
+    // Documents containing every term, best first. With prefixLast the final
+    // term also matches longer words so results follow the user while typing
+    QList<Hit> search(const QStringList& terms, int maxResults, bool prefixLast = true,
+                      const Filter& accept = Filter(), Matches* matched = nullptr,
+                      const Cancelled& cancelled = Cancelled()) const;
+
+    // Same, where each set lists interchangeable terms (prefix expansions,
+    // spelling corrections) and a document needs one term from every set
+    QList<Hit> searchAlternatives(const QList<QStringList>& termSets, int maxResults,
+                                  const Filter& accept = Filter(), Matches* matched = nullptr,
+                                  const Cancelled& cancelled = Cancelled()) const;
+
+    // Same as search, visiting only the candidates of an earlier search whose
+    // matches are known to include every match of this one. Scores equal
+    // those of a full search
+    QList<Hit> refine(const QVector<quint32>& candidates, const QStringList& terms, int maxResults,
+                      bool prefixLast = true, const Filter& accept = Filter(),
+                      Matches* matched = nullptr, const Cancelled& cancelled = Cancelled()) const;
+
+    // Doc id ranges a search is split into (at most; small indexes use fewer)
+    void setShardCount(int shards);
+    int shardCount() const;
+
+    // Indexed vocabulary in sorted order
+    QStringList terms() const;
+
+    // Persistence; see PostingList::save(). A loaded index keeps mappedFile
+    // open, since its postings point into the mapping, until they are rewritten
+    // or detach() copies them into owned memory and releases the file
+    void save(QDataStream& out) const;
+    bool load(QDataStream& in, const QByteArray& backing, const QSharedPointer<QFile>& mappedFile);
+    void detach();
+
+    // Lowercased letter/digit runs
+    static QStringList tokenize(const QString& text);
+
+private:
+    struct Shard;
+
+    QList<QStringList> expandTerms(const QStringList& terms, bool prefixLast, bool* truncated) const;
+    QList<Hit> runShards(const QList<QStringList>& termSets, const QVector<quint32>* candidates, int maxResults,
+                         const Filter& accept, Matches* matched, const Cancelled& cancelled) const;
+    void scanShard(const QList<QStringList>& termSets, const QVector<qreal>& idf, int maxResults,
+                   const Filter& accept, const Cancelled& cancelled, bool collect, Shard& shard) const;
+    void refineShard(const QVector<quint32>& candidates, const QList<QStringList>& termSets,
+                     const QVector<qreal>& idf, int maxResults, const Filter& accept,
+                     const Cancelled& cancelled, bool collect, Shard& shard) const;
+
+    QStringList prefixTerms(const QString& prefix, bool* truncated = nullptr) const;
+    qreal inverseFrequency(qint64 frequency) const;
+    qreal lengthNorm(quint32 doc) const;
+    static void unionPostings(const QList<const PostingList*>& lists, quint32 begin, quint32 end,
+                              PostingList& merged);
+    void compact();
+
+    QMap<QString, PostingList> m_postings;  // sorted for prefix expansion
+    QHash<QString, quint32> m_docIds;       // key -> live doc id
+    QVector<QString> m_docKeys;             // doc id -> key, empty once retired
+    QVector<quint32> m_docLengths;          // doc id -> token count
+    int m_shardCount;
+    int m_retiredDocuments;
+    qint64 m_totalLength;
+    QSharedPointer<QFile> m_mappedFile;     // backs loaded postings
+};
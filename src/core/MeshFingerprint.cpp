@@ -0,0 +1,143 @@
+#include "MeshFingerprint.h"
+#include "ShapeDescriptor.h"
+#include <QDataStream>
+#include <QIODevice>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+MeshFingerprint::MeshFingerprint()
+    : m_valid(false)
+    , m_area(0.0f)
+    , m_volume(0.0f)
+{
+}
+
+MeshFingerprint MeshFingerprint::fromMesh(const QVector<QVector3D>& positions, const QVector<unsigned int>& indices)
+{
+    MeshFingerprint fingerprint;
+    if (positions.isEmpty()) {
+        return fingerprint;
+    }
+
+    // Volume is taken about the centroid so it does not depend on placement
+    QVector3D centroid;
+    for (const QVector3D& position : positions) {
+        centroid += position;
+    }
+    centroid /= static_cast<float>(positions.size());
+
+    double area = 0.0;
+    double volume = 0.0;
+    for (int i = 0; i + 2 < indices.size(); i += 3) {
+        if (indices[i] >= static_cast<unsigned int>(positions.size())
+            || indices[i + 1] >= static_cast<unsigned int>(positions.size())
+            || indices[i + 2] >= static_cast<unsigned int>(positions.size())) {
+            continue;
+        }
+
+        QVector3D a = positions[indices[i]] - centroid;
+        QVector3D b = positions[indices[i + 1]] - centroid;
+        QVector3D c = positions[indices[i + 2]] - centroid;
+        area += 0.5 * QVector3D::crossProduct(b - a, c - a).length();
+        volume += QVector3D::dotProduct(a, QVector3D::crossProduct(b, c)) / 6.0;
+    }
+
+    if (area <= 0.0) {
+        return fingerprint;
+    }
+
+    QVector3D axes[3];
+    ShapeDescriptor::principalAxes(positions, axes);
+
+    float extents[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        float low = std::numeric_limits<float>::max();
+        float high = std::numeric_limits<float>::lowest();
+        for (const QVector3D& position : positions) {
+            float projection = QVector3D::dotProduct(position, axes[axis]);
+            low = qMin(low, projection);
+            high = qMax(high, projection);
+        }
+        extents[axis] = high - low;
+    }
+    std::sort(extents, extents + 3, [](float a, float b) { return a > b; });
+
+    fingerprint.m_valid = true;
+    fingerprint.m_area = static_cast<float>(area);
+    fingerprint.m_volume = static_cast<float>(std::fabs(volume));
+    fingerprint.m_extents = QVector3D(extents[0], extents[1], extents[2]);
+    return fingerprint;
+}
+
+bool MeshFingerprint::isValid() const
+{
+    return m_valid;
+}
+
+float MeshFingerprint::area() const
+{
+    return m_area;
+}
+
+float MeshFingerprint::volume() const
+{
+    return m_volume;
+}
+
+const QVector3D& MeshFingerprint::extents() const
+{
+    return m_extents;
+}
+
+bool MeshFingerprint::matches(const MeshFingerprint& other, double tolerance) const
+{
+    return m_valid && other.m_valid
+           && withinTolerance(m_area, other.m_area, tolerance)
+           && withinTolerance(m_volume, other.m_volume, tolerance)
+           && withinTolerance(m_extents.x(), other.m_extents.x(), tolerance)
+           && withinTolerance(m_extents.y(), other.m_extents.y(), tolerance)
+           && withinTolerance(m_extents.z(), other.m_extents.z(), tolerance);
+}
+
+qint32 MeshFingerprint::quantise(float value, double tolerance)
+{
+    return static_cast<qint32>(std::floor(std::log(qMax(value, MIN_VALUE)) / std::log1p(tolerance)));
+}
+
+bool MeshFingerprint::withinTolerance(float a, float b, double tolerance)
+{
+    return std::fabs(std::log(qMax(a, MIN_VALUE)) - std::log(qMax(b, MIN_VALUE))) <= std::log1p(tolerance);
+}
+
+QByteArray MeshFingerprint::toByteArray() const
+{
+    QByteArray data;
+    if (!m_valid) {
+        return data;
+    }
+
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << m_area << m_volume << m_extents.x() << m_extents.y() << m_extents.z();
+    return data;
+}
+
+MeshFingerprint MeshFingerprint::fromByteArray(const QByteArray& data)
+{
+    MeshFingerprint fingerprint;
+    if (data.size() != 5 * static_cast<int>(sizeof(float))) {
+        return fingerprint;
+    }
+
+    QDataStream in(data);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    float x, y, z;
+    in >> fingerprint.m_area >> fingerprint.m_volume >> x >> y >> z;
+    fingerprint.m_extents = QVector3D(x, y, z);
+    fingerprint.m_valid = fingerprint.m_area > 0.0f;
+    return fingerprint;
+}
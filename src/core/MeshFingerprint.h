@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QVector>
+#include <QVector3D>
+#include <QByteArray>
+
+/**
+ * @brief Size and proportions of a mesh, unaffected by how it was written
+ *
+ * Surface area, enclosed volume and the extents along the principal axes
+ * (largest first) do not depend on vertex order, triangle order,
+ * orientation or position. Re-exported copies of the same part therefore
+ * agree to within float noise, while exact content hashes of those copies
+ * differ. Unlike ShapeDescriptor the fingerprint keeps absolute size, so a
+ * part and its scaled copy are not duplicates.
+ *
+ * Values are compared on a log scale: two fingerprints match when every
+ * value is within a relative tolerance of the other's. quantise() maps a
+ * value to a cell of that width, so matching fingerprints fall in the same
+ * or adjacent cells.
+ */
+class MeshFingerprint
+{
+public:
+    static constexpr double DEFAULT_TOLERANCE = 0.02;
+
+    MeshFingerprint();
+
+    // An invalid fingerprint when the mesh has no area
+    static MeshFingerprint fromMesh(const QVector<QVector3D>& positions, const QVector<unsigned int>& indices);
+
+    bool isValid() const;
+    float area() const;
+    float volume() const;             // of the closed surface; meaningless for open meshes
+    const QVector3D& extents() const; // largest first
+
+    bool matches(const MeshFingerprint& other, double tolerance = DEFAULT_TOLERANCE) const;
+
+    // Log-scale cell of the given relative width
+    static qint32 quantise(float value, double tolerance = DEFAULT_TOLERANCE);
+
+    // Five little-endian floats; anything else reads back as invalid
+    QByteArray toByteArray() const;
+    static MeshFingerprint fromByteArray(const QByteArray& data);
+
+private:
+    // Values below this count as zero, so flat and open meshes still compare
+    static constexpr float MIN_VALUE = 1e-6f;
+
+    static bool withinTolerance(float a, float b, double tolerance);
+
+    bool m_valid;
+    float m_area;
+    float m_volume;
+    QVector3D m_extents;
+};
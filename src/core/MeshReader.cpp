@@ -0,0 +1,60 @@
+#include "MeshReader.h"
+#include <QDebug>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+bool MeshReader::read(const QString& filepath, Geometry& geometry)
+{
+    geometry = Geometry();
+
+    // Points and lines are dropped; pre-transforming flattens the node tree
+    Assimp::Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+    const aiScene* scene = importer.ReadFile(filepath.toStdString(),
+                                             aiProcess_Triangulate |
+                                             aiProcess_JoinIdenticalVertices |
+                                             aiProcess_PreTransformVertices |
+                                             aiProcess_SortByPType);
+
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) {
+        qWarning() << "Cannot read mesh" << filepath << ":" << importer.GetErrorString();
+        return false;
+    }
+
+    for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+        const aiMesh* mesh = scene->mMeshes[m];
+        unsigned int offset = static_cast<unsigned int>(geometry.positions.size());
+
+        for (unsigned int v = 0; v < mesh->mNumVertices; ++v) {
+            const aiVector3D& position = mesh->mVertices[v];
+            geometry.positions.append(QVector3D(position.x, position.y, position.z));
+        }
+
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+            const aiFace& face = mesh->mFaces[f];
+            if (face.mNumIndices != 3) {
+                continue;
+            }
+            for (unsigned int i = 0; i < 3; ++i) {
+                geometry.indices.append(offset + face.mIndices[i]);
+            }
+        }
+    }
+
+    if (!geometry.positions.isEmpty()) {
+        geometry.boundsMin = geometry.positions.first();
+        geometry.boundsMax = geometry.positions.first();
+        for (const QVector3D& position : geometry.positions) {
+            geometry.boundsMin.setX(qMin(geometry.boundsMin.x(), position.x()));
+            geometry.boundsMin.setY(qMin(geometry.boundsMin.y(), position.y()));
+            geometry.boundsMin.setZ(qMin(geometry.boundsMin.z(), position.z()));
+            geometry.boundsMax.setX(qMax(geometry.boundsMax.x(), position.x()));
+            geometry.boundsMax.setY(qMax(geometry.boundsMax.y(), position.y()));
+            geometry.boundsMax.setZ(qMax(geometry.boundsMax.z(), position.z()));
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QVector3D>
+
+/**
+ * @brief Triangle geometry of a model file, without render state
+ *
+ * Reads every mesh of a file through Assimp, with node transforms applied,
+ * into one shared vertex and index list. This is what import needs for mesh
+ * statistics, shape descriptors and fingerprints; normals, materials and
+ * GPU buffers are left to ModelLoader. Each call uses its own importer, so
+ * files may be read from several threads at once.
+ */
+class MeshReader
+{
+public:
+    struct Geometry {
+        QVector<QVector3D> positions;
+        QVector<unsigned int> indices;
+        QVector3D boundsMin;
+        QVector3D boundsMax;
+
+        int triangleCount() const { return indices.size() / 3; }
+    };
+
+    // False, with geometry left empty, when the file cannot be read
+    static bool read(const QString& filepath, Geometry& geometry);
+};
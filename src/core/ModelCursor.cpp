@@ -0,0 +1,314 @@
+#include "ModelCursor.h"
+#include "DatabaseConnectionPool.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QHash>
+#include <QDebug>
+
+// Matches the host parameter budget used by DatabaseManager
+static const int MAX_BOUND_PARAMETERS = 500;
+
+ModelCursor::ModelCursor()
+    : m_connectionPool(nullptr)
+    , m_columns(IdOnly)
+    , m_pageSize(DEFAULT_PAGE_SIZE)
+    , m_lastId(0)
+    , m_pageIndex(-1)
+    , m_exhausted(true)
+    , m_hasError(false)
+    , m_idLookup(false)
+    , m_idOffset(0)
+{
+}
+
+ModelCursor::ModelCursor(DatabaseConnectionPool* connectionPool, Columns columns, int pageSize)
+    : m_connectionPool(connectionPool)
+    , m_columns(columns)
+    , m_pageSize(qMax(1, pageSize))
+    , m_lastId(0)
+    , m_pageIndex(-1)
+    , m_exhausted(connectionPool == nullptr)
+    , m_hasError(false)
+    , m_idLookup(false)
+    , m_idOffset(0)
+{
+}
+
+ModelCursor::ModelCursor(DatabaseConnectionPool* connectionPool, const QList<QUuid>& ids,
+                         Columns columns, int pageSize)
+    : m_connectionPool(connectionPool)
+    , m_columns(columns)
+    , m_pageSize(qMax(1, pageSize))
+    , m_lastId(0)
+    , m_pageIndex(-1)
+    , m_exhausted(connectionPool == nullptr || ids.isEmpty())
+    , m_hasError(false)
+    , m_idLookup(true)
+    , m_ids(ids)
+    , m_idOffset(0)
+{
+}
+
+bool ModelCursor::next()
+{
+    if (m_pageIndex + 1 < m_page.size()) {
+        ++m_pageIndex;
+        return true;
+    }
+
+    if (!fetchPage()) {
+        return false;
+    }
+
+    m_pageIndex = 0;
+    return true;
+}
+
+const ModelMetadata& ModelCursor::current() const
+{
+    return m_page.at(m_pageIndex);
+}
+
+QList<ModelMetadata> ModelCursor::nextPage()
+{
+    QList<ModelMetadata> page;
+
+    // Hand out whatever row-wise iteration left behind first
+    if (m_pageIndex + 1 < m_page.size()) {
+        page = m_page.mid(m_pageIndex + 1);
+    } else if (fetchPage()) {
+        page = m_page;
+    }
+
+    m_pageIndex = m_page.size() - 1;
+    return page;
+}
+
+bool ModelCursor::atEnd() const
+{
+    return m_exhausted && m_pageIndex + 1 >= m_page.size();
+}
+
+bool ModelCursor::hasError() const
+{
+    return m_hasError;
+}
+
+ModelCursor::Columns ModelCursor::columns() const
+{
+    return m_columns;
+}
+
+bool ModelCursor::fetchPage()
+{
+    m_page.clear();
+    m_pageIndex = -1;
+
+    // An id chunk can come back empty when its models were deleted, so keep
+    // going until a page has rows or the input runs out
+    while (!m_exhausted && m_page.isEmpty()) {
+        QSqlQuery& query = m_idLookup ? prepareIdChunk() : prepareKeysetPage();
+
+        if (!query.exec()) {
+            qWarning() << "Model cursor query failed:" << query.lastError().text();
+            m_hasError = true;
+            m_exhausted = true;
+            return false;
+        }
+
+        QList<qint64> keys;
+        while (query.next()) {
+            keys.append(query.value(0).toLongLong());
+            m_page.append(readRow(query));
+        }
+        query.finish();
+
+        if (m_idLookup) {
+            m_exhausted = m_idOffset >= m_ids.size();
+        } else {
+            if (!keys.isEmpty()) {
+                m_lastId = keys.last();
+            }
+
+            // A short page means the keyset has run past the last row
+            m_exhausted = keys.size() < m_pageSize;
+        }
+
+        if ((m_columns & Tags) && !m_page.isEmpty() && !loadTags(m_page, keys)) {
+            m_hasError = true;
+        }
+    }
+
+    return !m_page.isEmpty();
+}
+
+QSqlQuery& ModelCursor::prepareKeysetPage()
+{
+    QSqlQuery& query = m_connectionPool->preparedQuery(
+        DatabaseConnectionPool::AccessMode::ReadOnly,
+        buildSelect("id > ? ORDER BY id LIMIT ?"));
+    query.addBindValue(m_lastId);
+    query.addBindValue(m_pageSize);
+    return query;
+}
+
+QSqlQuery& ModelCursor::prepareIdChunk()
+{
+    int chunkSize = qMin(qMin(m_pageSize, MAX_BOUND_PARAMETERS), m_ids.size() - m_idOffset);
+
+    QStringList placeholders;
+    for (int i = 0; i < chunkSize; ++i) {
+        placeholders << "?";
+    }
+
+    QSqlQuery& query = m_connectionPool->preparedQuery(
+        DatabaseConnectionPool::AccessMode::ReadOnly,
+        buildSelect(QString("uuid IN (%1)").arg(placeholders.join(","))));
+    for (int i = m_idOffset; i < m_idOffset + chunkSize; ++i) {
+        query.addBindValue(m_ids[i].toRfc4122());
+    }
+
+    m_idOffset += chunkSize;
+    return query;
+}
+
+ModelMetadata ModelCursor::readRow(const QSqlQuery& query) const
+{
+    ModelMetadata model(QUuid::fromRfc4122(query.value(1).toByteArray()));
+    model.fileSize = 0;
+    int column = 2;
+
+    if (m_columns & Filename) {
+        model.filename = query.value(column++).toString();
+    }
+    if (m_columns & FileSize) {
+        model.fileSize = query.value(column++).toLongLong();
+    }
+    if (m_columns & ImportDate) {
+        model.importDate = query.value(column++).toString();
+    }
+    if (m_columns & ThumbnailPath) {
+        model.thumbnailPath = query.value(column++).toString();
+    }
+    if (m_columns & MeshStats) {
+        model.meshStats = readMeshStats(query, column);
+        column += 6;
+    }
+    if (m_columns & CustomFields) {
+        model.customFields = QJsonDocument::fromJson(query.value(column++).toByteArray()).object().toVariantMap();
+    }
+    if (m_columns & Shape) {
+        model.shapeDescriptor = query.value(column++).toByteArray();
+    }
+    if (m_columns & ContentHash) {
+        model.contentHash = query.value(column++).toByteArray();
+    }
+    if (m_columns & Fingerprints) {
+        model.meshFingerprint = query.value(column++).toByteArray();
+        model.thumbnailHash = static_cast<quint64>(query.value(column++).toLongLong());
+    }
+
+    return model;
+}
+
+QString ModelCursor::buildSelect(const QString& condition) const
+{
+    QStringList selected = {"id", "uuid"};
+
+    if (m_columns & Filename) {
+        selected << "filename";
+    }
+    if (m_columns & FileSize) {
+        selected << "file_size";
+    }
+    if (m_columns & ImportDate) {
+        selected << "import_date";
+    }
+    if (m_columns & ThumbnailPath) {
+        selected << "thumbnail_path";
+    }
+    if (m_columns & MeshStats) {
+        selected << "vertex_count" << "triangle_count" << "bounds_x" << "bounds_y" << "bounds_z" << "mesh_stats";
+    }
+    if (m_columns & CustomFields) {
+        selected << "custom_fields";
+    }
+    if (m_columns & Shape) {
+        selected << "shape_descriptor";
+    }
+    if (m_columns & ContentHash) {
+        selected << "content_hash";
+    }
+    if (m_columns & Fingerprints) {
+        selected << "mesh_fingerprint" << "thumbnail_hash";
+    }
+
+    return QString("SELECT %1 FROM models WHERE %2").arg(selected.join(", "), condition);
+}
+
+QVariantMap ModelCursor::readMeshStats(const QSqlQuery& query, int column) const
+{
+    // Untyped leftovers first, then the typed columns on top
+    QVariantMap meshStats = QJsonDocument::fromJson(query.value(column + 5).toByteArray()).object().toVariantMap();
+
+    if (!query.isNull(column)) {
+        meshStats["vertex_count"] = query.value(column).toLongLong();
+    }
+    if (!query.isNull(column + 1)) {
+        meshStats["triangle_count"] = query.value(column + 1).toLongLong();
+    }
+    if (!query.isNull(column + 2) || !query.isNull(column + 3) || !query.isNull(column + 4)) {
+        meshStats["bounds"] = QVariantMap{
+            {"x", query.value(column + 2).toDouble()},
+            {"y", query.value(column + 3).toDouble()},
+            {"z", query.value(column + 4).toDouble()}
+        };
+    }
+
+    return meshStats;
+}
+
+bool ModelCursor::loadTags(QList<ModelMetadata>& page, const QList<qint64>& keys)
+{
+    QHash<qint64, int> rowById;
+    for (int i = 0; i < keys.size(); ++i) {
+        rowById.insert(keys[i], i);
+    }
+
+    // One join per chunk of the page instead of one query per model
+    for (int offset = 0; offset < page.size(); offset += MAX_BOUND_PARAMETERS) {
+        int chunkSize = qMin(MAX_BOUND_PARAMETERS, page.size() - offset);
+
+        QStringList placeholders;
+        for (int i = 0; i < chunkSize; ++i) {
+            placeholders << "?";
+        }
+
+        QSqlQuery& query = m_connectionPool->preparedQuery(
+            DatabaseConnectionPool::AccessMode::ReadOnly,
+            QString("SELECT model_tags.model_id, tags.name FROM model_tags "
+                    "JOIN tags ON tags.id = model_tags.tag_id "
+                    "WHERE model_tags.model_id IN (%1)").arg(placeholders.join(",")));
+
+        for (int i = offset; i < offset + chunkSize; ++i) {
+            query.addBindValue(keys[i]);
+        }
+
+        if (!query.exec()) {
+            qWarning() << "Model cursor tag query failed:" << query.lastError().text();
+            return false;
+        }
+
+        while (query.next()) {
+            int row = rowById.value(query.value(0).toLongLong(), -1);
+            if (row >= 0) {
+                page[row].tags.append(query.value(1).toString());
+            }
+        }
+        query.finish();
+    }
+
+    return true;
+}
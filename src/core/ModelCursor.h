@@ -0,0 +1,86 @@
+#pragma once
+
+#include "BaseTypes.h"
+#include <QString>
+#include <QList>
+#include <QFlags>
+
+class DatabaseConnectionPool;
+class QSqlQuery;
+
+/**
+ * @brief Forward-only streaming cursor over the models table
+ *
+ * Pages through models with keyset pagination (WHERE id > last ORDER BY id
+ * LIMIT n), so memory stays bounded by one page however large the catalogue
+ * is, and later pages cost the same as the first. Only the requested columns
+ * are read and decoded; the id is always populated. A cursor reads on the
+ * calling thread's pooled read-only connection and must stay on that thread.
+ */
+class ModelCursor
+{
+public:
+    enum Column {
+        IdOnly        = 0x00,
+        Filename      = 0x01,
+        FileSize      = 0x02,
+        ImportDate    = 0x04,
+        ThumbnailPath = 0x08,
+        MeshStats     = 0x10,
+        CustomFields  = 0x20,
+        Tags          = 0x40,
+        Shape         = 0x80,
+        ContentHash   = 0x100,
+        Fingerprints  = 0x200,  // mesh fingerprint and thumbnail hash
+        AllColumns    = 0x3FF
+    };
+    Q_DECLARE_FLAGS(Columns, Column)
+
+    static const int DEFAULT_PAGE_SIZE = 500;
+
+    ModelCursor();
+    ModelCursor(DatabaseConnectionPool* connectionPool, Columns columns, int pageSize = DEFAULT_PAGE_SIZE);
+
+    // Cursor over just the given models, looked up by UUID in chunks; rows come
+    // back in database order and ids without a stored model are skipped
+    ModelCursor(DatabaseConnectionPool* connectionPool, const QList<QUuid>& ids,
+                Columns columns, int pageSize = DEFAULT_PAGE_SIZE);
+
+    // Row-at-a-time iteration
+    bool next();
+    const ModelMetadata& current() const;
+
+    // Page-at-a-time iteration; returns an empty list once exhausted
+    QList<ModelMetadata> nextPage();
+
+    bool atEnd() const;
+    bool hasError() const;
+    Columns columns() const;
+
+private:
+    bool fetchPage();
+    QSqlQuery& prepareKeysetPage();
+    QSqlQuery& prepareIdChunk();
+    ModelMetadata readRow(const QSqlQuery& query) const;
+    QString buildSelect(const QString& condition) const;
+    QVariantMap readMeshStats(const QSqlQuery& query, int column) const;
+    bool loadTags(QList<ModelMetadata>& page, const QList<qint64>& keys);
+
+    DatabaseConnectionPool* m_connectionPool;
+    Columns m_columns;
+    int m_pageSize;
+
+    // Keyset position: integer id of the last row handed out
+    qint64 m_lastId;
+    QList<ModelMetadata> m_page;
+    int m_pageIndex;
+    bool m_exhausted;
+    bool m_hasError;
+
+    // Explicit id list instead of the keyset walk
+    bool m_idLookup;
+    QList<QUuid> m_ids;
+    int m_idOffset;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(ModelCursor::Columns)
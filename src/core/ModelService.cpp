@@ -2,6 +2,11 @@
 #include "DatabaseManager.h"
 #include "FileSystemManager.h"
 #include "CacheManager.h"
+#include "ShapeDescriptor.h"
+#include "ContentHash.h"
+#include "MeshFingerprint.h"
+#include "DuplicateClusterer.h"
+#include "MeshReader.h"
 #include <QFile>
 #include <QDir>
 #include <QFileInfo>
@@ -27,60 +32,180 @@ ModelService::ModelService(QObject* parent)
 QFuture<ModelMetadata> ModelService::loadModelAsync(const QString& filepath)
 {
     return QtConcurrent::run([this, filepath]() -> ModelMetadata {
-        QFileInfo fileInfo(filepath);
+        return importFile(filepath);
+    });
+}
+
+ModelMetadata ModelService::importFile(const QString& filepath, bool* duplicate)
+{
+    QFileInfo fileInfo(filepath);
 
-        if (!fileInfo.exists()) {
-            emit errorOccurred("Load Model", filepath, "File does not exist");
+    if (!fileInfo.exists()) {
+        emit errorOccurred("Load Model", filepath, "File does not exist");
+        return ModelMetadata();
+    }
+
+    if (!isValidModelFile(filepath)) {
+        emit errorOccurred("Load Model", filepath, "Unsupported file format");
+        return ModelMetadata();
+    }
+
+    // Exact copies of stored models are caught before the mesh is parsed
+    QByteArray contentHash;
+    ModelMetadata existing = findStoredCopy(filepath, fileInfo.size(), contentHash);
+    if (duplicate) {
+        *duplicate = !existing.id.isNull();
+    }
+    if (!existing.id.isNull()) {
+        emit modelAlreadyImported(filepath, existing);
+        return existing;
+    }
+
+    // Generate model ID
+    QString modelId = generateModelId();
+
+    // Create model metadata
+    ModelMetadata model(modelId);
+    model.filename = fileInfo.fileName();
+    model.fileSize = fileInfo.size();
+    model.importDate = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+    // Read the mesh once for its statistics, shape descriptor and fingerprint.
+    // This runs on the importing thread: loadModelAsync already keeps it off
+    // the GUI thread, and importModels is a blocking batch call
+    MeshReader::Geometry geometry;
+    MeshReader::read(filepath, geometry);
+    QVector3D extent = geometry.boundsMax - geometry.boundsMin;
+
+    QVariantMap meshStats;
+    meshStats["vertex_count"] = geometry.positions.size();
+    meshStats["triangle_count"] = geometry.triangleCount();
+    meshStats["bounds"] = QVariantMap{
+        {"x", extent.x()}, {"y", extent.y()}, {"z", extent.z()}
+    };
+    model.meshStats = meshStats;
+
+    // All meshes form one surface for the descriptor and fingerprint
+    model.shapeDescriptor = ShapeDescriptor::fromMesh(geometry.positions, geometry.indices).toByteArray();
+    model.meshFingerprint = MeshFingerprint::fromMesh(geometry.positions, geometry.indices).toByteArray();
+
+    // Copy file to storage, hashing it on the way unless that was needed above
+    FileSystemManager* fsManager = qobject_cast<FileSystemManager*>(parent());
+    if (fsManager) {
+        QString storedPath = fsManager->copyModelToStorage(filepath, model.filename,
+                                                           contentHash.isEmpty() ? &contentHash : nullptr);
+        if (storedPath.isEmpty()) {
+            emit errorOccurred("Load Model", filepath, "Failed to copy file to storage");
             return ModelMetadata();
         }
 
-        if (!isValidModelFile(filepath)) {
-            emit errorOccurred("Load Model", filepath, "Unsupported file format");
-            return ModelMetadata();
+        // A storage backend that copies without hashing costs one more read
+        if (contentHash.isEmpty()) {
+            contentHash = ContentHash::ofFile(storedPath);
         }
+    } else if (contentHash.isEmpty()) {
+        contentHash = ContentHash::ofFile(filepath);
+    }
+    model.contentHash = contentHash;
 
-        // Generate model ID
-        QString modelId = generateModelId();
-
-        // Create model metadata
-        ModelMetadata model(modelId);
-        model.filename = fileInfo.fileName();
-        model.fileSize = fileInfo.size();
-        model.importDate = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
-
-        // Extract mesh statistics (placeholder for now)
-        QVariantMap meshStats;
-        meshStats["vertex_count"] = 0;
-        meshStats["triangle_count"] = 0;
-        meshStats["bounds"] = QVariantMap{
-            {"x", 0.0}, {"y", 0.0}, {"z", 0.0}
-        };
-        model.meshStats = meshStats;
-
-        // Copy file to storage
-        FileSystemManager* fsManager = qobject_cast<FileSystemManager*>(parent());
-        if (fsManager) {
-            QString storedPath = fsManager->copyModelToStorage(filepath, model.filename);
-            if (storedPath.isEmpty()) {
-                emit errorOccurred("Load Model", filepath, "Failed to copy file to storage");
-                return ModelMetadata();
-            }
+    // Store in database
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (dbManager) {
+        if (!dbManager->insertModel(model)) {
+            emit errorOccurred("Load Model", filepath, "Failed to store model metadata");
+            return ModelMetadata();
         }
+    }
+
+    emit modelLoaded(model);
+    return model;
+}
 
-        // Store in database
+QFuture<QList<QList<QUuid>>> ModelService::findNearDuplicatesAsync(double tolerance)
+{
+    return QtConcurrent::run([this, tolerance]() -> QList<QList<QUuid>> {
         DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
-        if (dbManager) {
-            if (!dbManager->insertModel(model)) {
-                emit errorOccurred("Load Model", filepath, "Failed to store model metadata");
-                return ModelMetadata();
+        if (!dbManager) {
+            return QList<QList<QUuid>>();
+        }
+
+        DuplicateClusterer clusterer(tolerance);
+        QHash<QUuid, quint64> backfilled;
+        ModelCursor cursor = dbManager->openModelCursor(ModelCursor::Fingerprints | ModelCursor::ThumbnailPath);
+        while (cursor.next()) {
+            const ModelMetadata& model = cursor.current();
+
+            // Thumbnails made before hashing are hashed from the stored image once
+            quint64 thumbnailHash = model.thumbnailHash;
+            if (thumbnailHash == 0 && !model.thumbnailPath.isEmpty()) {
+                thumbnailHash = DuplicateClusterer::thumbnailHash(QImage(model.thumbnailPath));
+                if (thumbnailHash != 0) {
+                    backfilled.insert(model.id, thumbnailHash);
+                }
             }
+
+            clusterer.add(model.id, MeshFingerprint::fromByteArray(model.meshFingerprint), thumbnailHash);
+        }
+
+        if (!backfilled.isEmpty()) {
+            dbManager->setThumbnailHashesAsync(backfilled);
         }
 
-        emit modelLoaded(model);
-        return model;
+        QList<QList<QUuid>> clusters = clusterer.clusters();
+        qInfo() << QString("Near-duplicate scan: %1 groups among %2 models").arg(clusters.size()).arg(clusterer.size());
+        return clusters;
     });
 }
 
+QFuture<bool> ModelService::setThumbnailHashAsync(const QUuid& id, quint64 thumbnailHash)
+{
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (dbManager) {
+        return dbManager->setThumbnailHashesAsync({{id, thumbnailHash}});
+    }
+    return QtFuture::makeReadyFuture(false);
+}
+
+ModelMetadata ModelService::findStoredCopy(const QString& filepath, qint64 fileSize, QByteArray& contentHash) const
+{
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (!dbManager) {
+        return ModelMetadata();
+    }
+
+    // Only a stored model of the same size can match, so most new files are
+    // not read here at all
+    QHash<QUuid, QByteArray> candidates = dbManager->getContentHashesBySize(fileSize);
+    if (candidates.isEmpty()) {
+        return ModelMetadata();
+    }
+
+    contentHash = ContentHash::ofFile(filepath);
+    if (contentHash.isEmpty()) {
+        return ModelMetadata();
+    }
+
+    for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+        // Models stored before hashing are hashed the first time a file could match them
+        if (it.value().isEmpty()) {
+            QString storedPath = getModelFilePath(it.key());
+            it.value() = storedPath.isEmpty() ? QByteArray() : ContentHash::ofFile(storedPath);
+            if (!it.value().isEmpty()) {
+                dbManager->setContentHash(it.key(), it.value());
+            }
+        }
+
+        if (it.value() == contentHash) {
+            ModelCursor cursor = dbManager->openModelCursor(QList<QUuid>() << it.key());
+            if (cursor.next()) {
+                return cursor.current();
+            }
+        }
+    }
+
+    return ModelMetadata();
+}
+
 bool ModelService::saveModel(const ModelMetadata& model, const QString& filepath)
 {
     // For now, this is a placeholder
@@ -98,6 +223,15 @@ QList<ModelMetadata> ModelService::getAllModels() const
     return QList<ModelMetadata>();
 }
 
+ModelCursor ModelService::openModelCursor(ModelCursor::Columns columns, int pageSize) const
+{
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (dbManager) {
+        return dbManager->openModelCursor(columns, pageSize);
+    }
+    return ModelCursor();
+}
+
 ModelMetadata ModelService::getModel(const QUuid& id) const
 {
     DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
@@ -158,24 +292,8 @@ bool ModelService::tagModels(const QList<QUuid>& modelIds, const QStringList& ta
 {
     DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
     if (dbManager) {
-        bool success = true;
-        for (const QUuid& id : modelIds) {
-            ModelMetadata model = dbManager->getModel(id);
-            QStringList currentTags = model.tags;
-
-            // Add new tags
-            for (const QString& tag : tags) {
-                if (!currentTags.contains(tag)) {
-                    currentTags.append(tag);
-                }
-            }
-
-            model.tags = currentTags;
-            if (!dbManager->updateModel(model)) {
-                success = false;
-            }
-        }
-
+        // One incremental edit for every model, applied against committed tags
+        bool success = dbManager->waitForCommit(dbManager->addModelTagsAsync(modelIds, tags));
         if (success) {
             emit modelsTagged(modelIds, tags);
         }
@@ -189,23 +307,7 @@ bool ModelService::untagModels(const QList<QUuid>& modelIds, const QStringList&
 {
     DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
     if (dbManager) {
-        bool success = true;
-        for (const QUuid& id : modelIds) {
-            ModelMetadata model = dbManager->getModel(id);
-            QStringList currentTags = model.tags;
-
-            // Remove specified tags
-            for (const QString& tag : tags) {
-                currentTags.removeAll(tag);
-            }
-
-            model.tags = currentTags;
-            if (!dbManager->updateModel(model)) {
-                success = false;
-            }
-        }
-
-        return success;
+        return dbManager->waitForCommit(dbManager->removeModelTagsAsync(modelIds, tags));
     }
     return false;
 }
@@ -223,18 +325,20 @@ bool ModelService::deleteModels(const QList<QUuid>& modelIds)
 
 qint64 ModelService::getTotalModelsCount() const
 {
-    QList<ModelMetadata> models = getAllModels();
-    return models.count();
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (dbManager) {
+        return dbManager->getModelStatistics().value("total_models").toLongLong();
+    }
+    return 0;
 }
 
 qint64 ModelService::getTotalModelsSize() const
 {
-    QList<ModelMetadata> models = getAllModels();
-    qint64 totalSize = 0;
-    for (const ModelMetadata& model : models) {
-        totalSize += model.fileSize;
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (dbManager) {
+        return dbManager->getModelStatistics().value("total_size").toLongLong();
     }
-    return totalSize;
+    return 0;
 }
 
 QStringList ModelService::getAllTags() const
@@ -248,19 +352,13 @@ QStringList ModelService::getAllTags() const
 
 QVariantMap ModelService::getModelStatistics() const
 {
+    // Count, size and format distribution come from the trigger-maintained counters
     QVariantMap stats;
-    stats["total_models"] = getTotalModelsCount();
-    stats["total_size"] = getTotalModelsSize();
-    stats["supported_formats"] = m_supportedFormats;
-
-    // Calculate format distribution
-    QVariantMap formatStats;
-    QList<ModelMetadata> models = getAllModels();
-    for (const ModelMetadata& model : models) {
-        QString extension = QFileInfo(model.filename).suffix().toLower();
-        formatStats[extension] = formatStats[extension].toInt() + 1;
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (dbManager) {
+        stats = dbManager->getModelStatistics();
     }
-    stats["format_distribution"] = formatStats;
+    stats["supported_formats"] = m_supportedFormats;
 
     return stats;
 }
@@ -278,12 +376,10 @@ QList<ModelMetadata> ModelService::importModels(const QStringList& filepaths,
             continue;
         }
 
-        // Load model asynchronously and wait for result
-        QFuture<ModelMetadata> future = loadModelAsync(filepath);
-        future.waitForFinished();
-
-        ModelMetadata model = future.result();
-        if (!model.id.isNull()) {
+        // Files already in the library are reported by modelAlreadyImported instead
+        bool duplicate = false;
+        ModelMetadata model = importFile(filepath, &duplicate);
+        if (!model.id.isNull() && !duplicate) {
             importedModels.append(model);
         }
     }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "BaseTypes.h"
+#include "ModelCursor.h"
+#include "MeshFingerprint.h"
 #include <QObject>
 #include <QString>
 #include <QList>
@@ -21,12 +23,15 @@ public:
     explicit ModelService(QObject* parent = nullptr);
     virtual ~ModelService() = default;
 
-    // Model loading and saving
+    // Model loading and saving. A file whose bytes are already stored is not
+    // imported again; the stored model is returned and modelAlreadyImported emitted
     virtual QFuture<ModelMetadata> loadModelAsync(const QString& filepath) = 0;
     virtual bool saveModel(const ModelMetadata& model, const QString& filepath) = 0;
 
     // Model metadata operations
     virtual QList<ModelMetadata> getAllModels() const = 0;
+    virtual ModelCursor openModelCursor(ModelCursor::Columns columns = ModelCursor::AllColumns,
+                                        int pageSize = ModelCursor::DEFAULT_PAGE_SIZE) const;
     virtual ModelMetadata getModel(const QUuid& id) const = 0;
     virtual bool updateModelMetadata(const ModelMetadata& model) = 0;
     virtual bool deleteModel(const QUuid& id) = 0;
@@ -41,6 +46,12 @@ public:
     virtual bool untagModels(const QList<QUuid>& modelIds, const QStringList& tags) = 0;
     virtual bool deleteModels(const QList<QUuid>& modelIds) = 0;
 
+    // Groups of models that are near-duplicates of one another (re-exported
+    // copies, float noise, reordered vertices), largest group first. Scans
+    // the whole catalogue; see DuplicateClusterer
+    virtual QFuture<QList<QList<QUuid>>> findNearDuplicatesAsync(double tolerance = MeshFingerprint::DEFAULT_TOLERANCE);
+    virtual QFuture<bool> setThumbnailHashAsync(const QUuid& id, quint64 thumbnailHash);
+
     // Model statistics
     virtual qint64 getTotalModelsCount() const = 0;
     virtual qint64 getTotalModelsSize() const = 0;
@@ -68,6 +79,7 @@ signals:
     void modelDeleted(const QUuid& id);
     void modelUpdated(const ModelMetadata& model);
     void modelsImported(const QList<ModelMetadata>& models);
+    void modelAlreadyImported(const QString& filepath, const ModelMetadata& existing);
 
     // Progress events
     void importProgress(const QString& filename, int percentage);
@@ -77,6 +89,13 @@ signals:
     void errorOccurred(const QString& operation, const QString& error, const QString& details);
 
 protected:
+    // Import steps shared by loadModelAsync() and importModels()
+    virtual ModelMetadata importFile(const QString& filepath, bool* duplicate = nullptr);
+
+    // The stored model with the same bytes as filepath, if any. contentHash
+    // receives the file's hash when it had to be read for the comparison
+    virtual ModelMetadata findStoredCopy(const QString& filepath, qint64 fileSize, QByteArray& contentHash) const;
+
     // Helper methods
     virtual QString generateModelId() const;
     virtual QString sanitizeFilename(const QString& filename) const;
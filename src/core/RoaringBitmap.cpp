@@ -0,0 +1,389 @@
+#include "RoaringBitmap.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <iterator>
+
+bool RoaringBitmap::Container::contains(quint16 low) const
+{
+    if (isBitmap()) {
+        return bits[low >> 6] & (quint64(1) << (low & 63));
+    }
+    return std::binary_search(array.constBegin(), array.constEnd(), low);
+}
+
+RoaringBitmap::RoaringBitmap()
+{
+}
+
+void RoaringBitmap::add(quint32 value)
+{
+    quint16 key = static_cast<quint16>(value >> 16);
+    quint16 low = static_cast<quint16>(value & 0xFFFF);
+
+    int index = findContainer(key);
+    if (index < 0) {
+        index = -index - 1;
+        m_keys.insert(index, key);
+        m_containers.insert(index, Container());
+    }
+
+    Container& container = m_containers[index];
+    if (container.isBitmap()) {
+        quint64& word = container.bits[low >> 6];
+        quint64 mask = quint64(1) << (low & 63);
+        if (!(word & mask)) {
+            word |= mask;
+            container.cardinality++;
+        }
+        return;
+    }
+
+    auto position = std::lower_bound(container.array.begin(), container.array.end(), low);
+    if (position == container.array.end() || *position != low) {
+        container.array.insert(position, low);
+        container.cardinality++;
+        if (container.cardinality > ARRAY_LIMIT) {
+            toBitmap(container);
+        }
+    }
+}
+
+void RoaringBitmap::remove(quint32 value)
+{
+    int index = findContainer(static_cast<quint16>(value >> 16));
+    if (index < 0) {
+        return;
+    }
+
+    quint16 low = static_cast<quint16>(value & 0xFFFF);
+    Container& container = m_containers[index];
+
+    if (container.isBitmap()) {
+        quint64& word = container.bits[low >> 6];
+        quint64 mask = quint64(1) << (low & 63);
+        if (word & mask) {
+            word &= ~mask;
+            container.cardinality--;
+            normalise(container);
+        }
+    } else {
+        auto position = std::lower_bound(container.array.begin(), container.array.end(), low);
+        if (position != container.array.end() && *position == low) {
+            container.array.erase(position);
+            container.cardinality--;
+        }
+    }
+
+    if (container.cardinality == 0) {
+        m_keys.remove(index);
+        m_containers.remove(index);
+    }
+}
+
+bool RoaringBitmap::contains(quint32 value) const
+{
+    int index = findContainer(static_cast<quint16>(value >> 16));
+    return index >= 0 && m_containers[index].contains(static_cast<quint16>(value & 0xFFFF));
+}
+
+void RoaringBitmap::clear()
+{
+    m_keys.clear();
+    m_containers.clear();
+}
+
+bool RoaringBitmap::isEmpty() const
+{
+    return m_keys.isEmpty();
+}
+
+qint64 RoaringBitmap::cardinality() const
+{
+    qint64 total = 0;
+    for (const Container& container : m_containers) {
+        total += container.cardinality;
+    }
+    return total;
+}
+
+qint64 RoaringBitmap::memoryUsage() const
+{
+    qint64 usage = m_keys.capacity() * static_cast<qint64>(sizeof(quint16));
+    for (const Container& container : m_containers) {
+        usage += sizeof(Container)
+               + container.array.capacity() * static_cast<qint64>(sizeof(quint16))
+               + container.bits.capacity() * static_cast<qint64>(sizeof(quint64));
+    }
+    return usage;
+}
+
+QVector<quint32> RoaringBitmap::toVector() const
+{
+    QVector<quint32> values;
+    values.reserve(static_cast<int>(cardinality()));
+
+    for (int i = 0; i < m_keys.size(); ++i) {
+        quint32 high = static_cast<quint32>(m_keys[i]) << 16;
+        const Container& container = m_containers[i];
+
+        if (!container.isBitmap()) {
+            for (quint16 low : container.array) {
+                values.append(high | low);
+            }
+            continue;
+        }
+
+        for (int word = 0; word < BITMAP_WORDS; ++word) {
+            quint64 bits = container.bits[word];
+            while (bits) {
+                values.append(high | static_cast<quint32>(word * 64 + qCountTrailingZeroBits(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    return values;
+}
+
+RoaringBitmap RoaringBitmap::operator&(const RoaringBitmap& other) const
+{
+    RoaringBitmap result;
+
+    // Only groups present on both sides can survive
+    int i = 0;
+    int j = 0;
+    while (i < m_keys.size() && j < other.m_keys.size()) {
+        if (m_keys[i] < other.m_keys[j]) {
+            ++i;
+        } else if (m_keys[i] > other.m_keys[j]) {
+            ++j;
+        } else {
+            Container container = intersect(m_containers[i], other.m_containers[j]);
+            if (container.cardinality > 0) {
+                result.m_keys.append(m_keys[i]);
+                result.m_containers.append(container);
+            }
+            ++i;
+            ++j;
+        }
+    }
+
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::operator|(const RoaringBitmap& other) const
+{
+    RoaringBitmap result;
+
+    int i = 0;
+    int j = 0;
+    while (i < m_keys.size() || j < other.m_keys.size()) {
+        if (j >= other.m_keys.size() || (i < m_keys.size() && m_keys[i] < other.m_keys[j])) {
+            result.m_keys.append(m_keys[i]);
+            result.m_containers.append(m_containers[i]);
+            ++i;
+        } else if (i >= m_keys.size() || m_keys[i] > other.m_keys[j]) {
+            result.m_keys.append(other.m_keys[j]);
+            result.m_containers.append(other.m_containers[j]);
+            ++j;
+        } else {
+            result.m_keys.append(m_keys[i]);
+            result.m_containers.append(unite(m_containers[i], other.m_containers[j]));
+            ++i;
+            ++j;
+        }
+    }
+
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::operator-(const RoaringBitmap& other) const
+{
+    RoaringBitmap result;
+
+    int j = 0;
+    for (int i = 0; i < m_keys.size(); ++i) {
+        while (j < other.m_keys.size() && other.m_keys[j] < m_keys[i]) {
+            ++j;
+        }
+
+        if (j < other.m_keys.size() && other.m_keys[j] == m_keys[i]) {
+            Container container = subtract(m_containers[i], other.m_containers[j]);
+            if (container.cardinality > 0) {
+                result.m_keys.append(m_keys[i]);
+                result.m_containers.append(container);
+            }
+        } else {
+            result.m_keys.append(m_keys[i]);
+            result.m_containers.append(m_containers[i]);
+        }
+    }
+
+    return result;
+}
+
+RoaringBitmap& RoaringBitmap::operator&=(const RoaringBitmap& other)
+{
+    *this = *this & other;
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& other)
+{
+    *this = *this | other;
+    return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator-=(const RoaringBitmap& other)
+{
+    *this = *this - other;
+    return *this;
+}
+
+int RoaringBitmap::findContainer(quint16 key) const
+{
+    auto position = std::lower_bound(m_keys.constBegin(), m_keys.constEnd(), key);
+    int index = static_cast<int>(position - m_keys.constBegin());
+    if (position != m_keys.constEnd() && *position == key) {
+        return index;
+    }
+    return -index - 1;
+}
+
+void RoaringBitmap::toBitmap(Container& container)
+{
+    container.bits = QVector<quint64>(BITMAP_WORDS, 0);
+    for (quint16 low : container.array) {
+        container.bits[low >> 6] |= quint64(1) << (low & 63);
+    }
+    container.array = QVector<quint16>();
+}
+
+void RoaringBitmap::toArray(Container& container)
+{
+    QVector<quint16> array;
+    array.reserve(container.cardinality);
+    for (int word = 0; word < BITMAP_WORDS; ++word) {
+        quint64 bits = container.bits[word];
+        while (bits) {
+            array.append(static_cast<quint16>(word * 64 + qCountTrailingZeroBits(bits)));
+            bits &= bits - 1;
+        }
+    }
+    container.array = array;
+    container.bits = QVector<quint64>();
+}
+
+void RoaringBitmap::normalise(Container& container)
+{
+    if (container.isBitmap() && container.cardinality <= ARRAY_LIMIT) {
+        toArray(container);
+    } else if (!container.isBitmap() && container.cardinality > ARRAY_LIMIT) {
+        toBitmap(container);
+    }
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container& a, const Container& b)
+{
+    Container result;
+
+    if (a.isBitmap() && b.isBitmap()) {
+        result.bits = QVector<quint64>(BITMAP_WORDS, 0);
+        for (int word = 0; word < BITMAP_WORDS; ++word) {
+            result.bits[word] = a.bits[word] & b.bits[word];
+            result.cardinality += qPopulationCount(result.bits[word]);
+        }
+        normalise(result);
+        return result;
+    }
+
+    if (!a.isBitmap() && !b.isBitmap()) {
+        std::set_intersection(a.array.constBegin(), a.array.constEnd(),
+                              b.array.constBegin(), b.array.constEnd(),
+                              std::back_inserter(result.array));
+    } else {
+        // Probe the dense side with every id of the sparse one
+        const Container& sparse = a.isBitmap() ? b : a;
+        const Container& dense = a.isBitmap() ? a : b;
+        for (quint16 low : sparse.array) {
+            if (dense.contains(low)) {
+                result.array.append(low);
+            }
+        }
+    }
+
+    result.cardinality = result.array.size();
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::unite(const Container& a, const Container& b)
+{
+    Container result;
+
+    if (!a.isBitmap() && !b.isBitmap()) {
+        std::set_union(a.array.constBegin(), a.array.constEnd(),
+                       b.array.constBegin(), b.array.constEnd(),
+                       std::back_inserter(result.array));
+        result.cardinality = result.array.size();
+        normalise(result);
+        return result;
+    }
+
+    // Fold both sides into one map
+    result = a.isBitmap() ? a : b;
+    const Container& other = a.isBitmap() ? b : a;
+    if (other.isBitmap()) {
+        result.cardinality = 0;
+        for (int word = 0; word < BITMAP_WORDS; ++word) {
+            result.bits[word] |= other.bits[word];
+            result.cardinality += qPopulationCount(result.bits[word]);
+        }
+    } else {
+        for (quint16 low : other.array) {
+            quint64& word = result.bits[low >> 6];
+            quint64 mask = quint64(1) << (low & 63);
+            if (!(word & mask)) {
+                word |= mask;
+                result.cardinality++;
+            }
+        }
+    }
+
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::subtract(const Container& a, const Container& b)
+{
+    Container result;
+
+    if (!a.isBitmap()) {
+        for (quint16 low : a.array) {
+            if (!b.contains(low)) {
+                result.array.append(low);
+            }
+        }
+        result.cardinality = result.array.size();
+        return result;
+    }
+
+    result = a;
+    if (b.isBitmap()) {
+        result.cardinality = 0;
+        for (int word = 0; word < BITMAP_WORDS; ++word) {
+            result.bits[word] &= ~b.bits[word];
+            result.cardinality += qPopulationCount(result.bits[word]);
+        }
+    } else {
+        for (quint16 low : b.array) {
+            quint64& word = result.bits[low >> 6];
+            quint64 mask = quint64(1) << (low & 63);
+            if (word & mask) {
+                word &= ~mask;
+                result.cardinality--;
+            }
+        }
+    }
+
+    normalise(result);
+    return result;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief Compressed set of 32-bit ids (roaring layout)
+ *
+ * Ids are grouped by their high 16 bits. Each group stores its low halves as
+ * a sorted array while it holds at most ARRAY_LIMIT ids and as a 65536-bit
+ * map beyond that, so sparse and dense sets both stay compact and set
+ * operations work a whole group (or a 64-bit word) at a time.
+ */
+class RoaringBitmap
+{
+public:
+    static const int ARRAY_LIMIT = 4096;
+
+    RoaringBitmap();
+
+    void add(quint32 value);
+    void remove(quint32 value);
+    bool contains(quint32 value) const;
+    void clear();
+
+    bool isEmpty() const;
+    qint64 cardinality() const;
+    qint64 memoryUsage() const;
+
+    // Ids in ascending order
+    QVector<quint32> toVector() const;
+
+    RoaringBitmap operator&(const RoaringBitmap& other) const;
+    RoaringBitmap operator|(const RoaringBitmap& other) const;
+    RoaringBitmap operator-(const RoaringBitmap& other) const;  // and-not
+
+    RoaringBitmap& operator&=(const RoaringBitmap& other);
+    RoaringBitmap& operator|=(const RoaringBitmap& other);
+    RoaringBitmap& operator-=(const RoaringBitmap& other);
+
+private:
+    static const int BITMAP_WORDS = 1024;
+
+    struct Container {
+        QVector<quint16> array;  // sorted low halves while sparse
+        QVector<quint64> bits;   // BITMAP_WORDS words once dense
+        int cardinality = 0;
+
+        bool isBitmap() const { return !bits.isEmpty(); }
+        bool contains(quint16 low) const;
+    };
+
+    int findContainer(quint16 key) const;
+
+    static void toBitmap(Container& container);
+    static void toArray(Container& container);
+    static void normalise(Container& container);
+
+    static Container intersect(const Container& a, const Container& b);
+    static Container unite(const Container& a, const Container& b);
+    static Container subtract(const Container& a, const Container& b);
+
+    QVector<quint16> m_keys;  // sorted high halves
+    QVector<Container> m_containers;
+};
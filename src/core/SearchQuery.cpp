@@ -0,0 +1,326 @@
+#include "SearchQuery.h"
+#include <QUuid>
+#include <cmath>
+
+SearchQuery::SearchQuery(const QString& query)
+    : m_finished(query.isEmpty() || query.at(query.size() - 1).isSpace())
+    , m_hasFieldTerms(false)
+{
+    QStringList terms = splitTerms(query);
+    for (int i = 0; i < terms.size(); ++i) {
+        const QString& term = terms[i];
+
+        // Anything that is not a known field, such as "m3:bolt", stays free text
+        bool negated = term.startsWith('-');
+        int colon = term.indexOf(':');
+        QString field = colon > 0 ? term.mid(negated ? 1 : 0, colon - (negated ? 1 : 0)).toLower() : QString();
+        QString value = colon > 0 ? term.mid(colon + 1) : QString();
+
+        static const QStringList FIELDS = {
+            "tag", "ext", "is", "project", "size", "tris", "triangles", "verts", "vertices", "date"
+        };
+        if (!FIELDS.contains(field)) {
+            m_words.append(term);
+            continue;
+        }
+
+        m_hasFieldTerms = true;
+        if (i == terms.size() - 1) {
+            m_finished = true;
+        }
+
+        if (value.isEmpty() || !addFieldTerm(field, value, negated)) {
+            m_errors.append(term);
+        }
+    }
+}
+
+QString SearchQuery::text() const
+{
+    QString text = m_words.join(' ');
+    if (m_finished && !text.isEmpty()) {
+        text += ' ';
+    }
+    return text;
+}
+
+SearchService::SearchFilters SearchQuery::applyTo(const SearchService::SearchFilters& base) const
+{
+    SearchService::SearchFilters filters = base;
+
+    filters.contentTypes += m_filters.contentTypes;
+    filters.tags += m_filters.tags;
+    filters.excludeTags += m_filters.excludeTags;
+    filters.fileTypes += m_filters.fileTypes;
+    filters.projects += m_filters.projects;
+    filters.contentTypes.removeDuplicates();
+    filters.tags.removeDuplicates();
+    filters.excludeTags.removeDuplicates();
+    filters.fileTypes.removeDuplicates();
+
+    for (auto it = m_filters.sizeRange.constBegin(); it != m_filters.sizeRange.constEnd(); ++it) {
+        filters.sizeRange.insert(it.key(), it.value());
+    }
+    for (auto it = m_filters.dateRange.constBegin(); it != m_filters.dateRange.constEnd(); ++it) {
+        filters.dateRange.insert(it.key(), it.value());
+    }
+    for (auto it = m_filters.customFilters.constBegin(); it != m_filters.customFilters.constEnd(); ++it) {
+        filters.customFilters.insert(it.key(), it.value());
+    }
+
+    return filters;
+}
+
+bool SearchQuery::hasFieldTerms() const
+{
+    return m_hasFieldTerms;
+}
+
+QStringList SearchQuery::errors() const
+{
+    return m_errors;
+}
+
+QStringList SearchQuery::splitTerms(const QString& query)
+{
+    // Whitespace separates terms except inside quotes, which are dropped
+    QStringList terms;
+    QString current;
+    bool quoted = false;
+
+    for (QChar c : query) {
+        if (c == '"') {
+            quoted = !quoted;
+        } else if (c.isSpace() && !quoted) {
+            if (!current.isEmpty()) {
+                terms.append(current);
+                current.clear();
+            }
+        } else {
+            current += c;
+        }
+    }
+    if (!current.isEmpty()) {
+        terms.append(current);
+    }
+
+    return terms;
+}
+
+bool SearchQuery::splitRange(const QString& value, Bound& low, Bound& high)
+{
+    auto bound = [](Bound& target, const QString& text, bool inclusive) {
+        target.set = true;
+        target.inclusive = inclusive;
+        target.value = text.trimmed();
+        return !target.value.isEmpty();
+    };
+
+    if (value.startsWith(">=")) {
+        return bound(low, value.mid(2), true);
+    }
+    if (value.startsWith("<=")) {
+        return bound(high, value.mid(2), true);
+    }
+    if (value.startsWith('>')) {
+        return bound(low, value.mid(1), false);
+    }
+    if (value.startsWith('<')) {
+        return bound(high, value.mid(1), false);
+    }
+
+    int dots = value.indexOf("..");
+    if (dots < 0) {
+        return bound(low, value, true) && bound(high, value, true);
+    }
+
+    QString from = value.left(dots);
+    QString to = value.mid(dots + 2);
+    if (from.isEmpty() && to.isEmpty()) {
+        return false;
+    }
+    return (from.isEmpty() || bound(low, from, true)) && (to.isEmpty() || bound(high, to, true));
+}
+
+bool SearchQuery::parseCount(const QString& value, qint64& count)
+{
+    QString number = value.toLower();
+    double scale = 1.0;
+    if (number.endsWith('k')) {
+        scale = 1e3;
+        number.chop(1);
+    } else if (number.endsWith('m')) {
+        scale = 1e6;
+        number.chop(1);
+    }
+
+    bool ok = false;
+    double parsed = number.toDouble(&ok);
+    if (!ok || parsed < 0) {
+        return false;
+    }
+
+    count = static_cast<qint64>(std::llround(parsed * scale));
+    return true;
+}
+
+bool SearchQuery::parseSize(const QString& value, qint64& bytes)
+{
+    static const struct {
+        const char* suffix;
+        double scale;
+    } UNITS[] = {
+        {"tb", 1099511627776.0}, {"gb", 1073741824.0}, {"mb", 1048576.0}, {"kb", 1024.0},
+        {"t", 1099511627776.0}, {"g", 1073741824.0}, {"m", 1048576.0}, {"k", 1024.0}, {"b", 1.0}
+    };
+
+    QString number = value.toLower();
+    double scale = 1.0;
+    for (const auto& unit : UNITS) {
+        if (number.endsWith(unit.suffix)) {
+            scale = unit.scale;
+            number.chop(static_cast<int>(qstrlen(unit.suffix)));
+            break;
+        }
+    }
+
+    bool ok = false;
+    double parsed = number.toDouble(&ok);
+    if (!ok || parsed < 0) {
+        return false;
+    }
+
+    bytes = static_cast<qint64>(std::llround(parsed * scale));
+    return true;
+}
+
+bool SearchQuery::parsePeriod(const QString& value, QDate& first, QDate& last)
+{
+    // A year, month or day stands for every date inside it
+    first = QDate::fromString(value, "yyyy-MM-dd");
+    if (first.isValid()) {
+        last = first;
+        return true;
+    }
+
+    first = QDate::fromString(value, "yyyy-MM");
+    if (first.isValid()) {
+        last = first.addMonths(1).addDays(-1);
+        return true;
+    }
+
+    first = QDate::fromString(value, "yyyy");
+    if (first.isValid()) {
+        last = first.addYears(1).addDays(-1);
+        return true;
+    }
+
+    return false;
+}
+
+bool SearchQuery::addFieldTerm(const QString& field, const QString& value, bool negated)
+{
+    // Only tags have an excluding filter
+    if (negated && field != "tag") {
+        return false;
+    }
+
+    if (field == "tag") {
+        (negated ? m_filters.excludeTags : m_filters.tags).append(value);
+        return true;
+    }
+
+    if (field == "ext") {
+        m_filters.fileTypes.append(value.startsWith('.') ? value.mid(1).toLower() : value.toLower());
+        return true;
+    }
+
+    if (field == "is") {
+        QString type = value.toLower();
+        if (type != "model" && type != "project") {
+            return false;
+        }
+        m_filters.contentTypes.append(type);
+        return true;
+    }
+
+    if (field == "project") {
+        QUuid project(value);
+        if (project.isNull()) {
+            return false;
+        }
+        m_filters.projects.append(project);
+        return true;
+    }
+
+    if (field == "size") {
+        return addNumericRange(value, true, m_filters.sizeRange);
+    }
+
+    if (field == "date") {
+        return addDateRange(value, m_filters.dateRange);
+    }
+
+    // Mesh statistics go in the custom filters the database can answer
+    QString stat = (field == "tris" || field == "triangles") ? "triangle_count" : "vertex_count";
+    QVariantMap range = m_filters.customFilters.value(stat).toMap();
+    if (!addNumericRange(value, false, range)) {
+        return false;
+    }
+    m_filters.customFilters.insert(stat, range);
+    return true;
+}
+
+bool SearchQuery::addNumericRange(const QString& value, bool size, QVariantMap& range)
+{
+    Bound low;
+    Bound high;
+    if (!splitRange(value, low, high)) {
+        return false;
+    }
+
+    // Whole numbers, so an open bound moves by one
+    qint64 number = 0;
+    if (low.set) {
+        if (!(size ? parseSize(low.value, number) : parseCount(low.value, number))) {
+            return false;
+        }
+        range["min"] = low.inclusive ? number : number + 1;
+    }
+    if (high.set) {
+        if (!(size ? parseSize(high.value, number) : parseCount(high.value, number))) {
+            return false;
+        }
+        range["max"] = high.inclusive ? number : number - 1;
+    }
+
+    return true;
+}
+
+bool SearchQuery::addDateRange(const QString& value, QVariantMap& range)
+{
+    Bound low;
+    Bound high;
+    if (!splitRange(value, low, high)) {
+        return false;
+    }
+
+    // Import dates are stored as ISO text, so the bounds compare as strings:
+    // the start of a day sorts before any time on it, the end after
+    QDate first;
+    QDate last;
+    if (low.set) {
+        if (!parsePeriod(low.value, first, last)) {
+            return false;
+        }
+        range["min"] = (low.inclusive ? first : last.addDays(1)).toString(Qt::ISODate);
+    }
+    if (high.set) {
+        if (!parsePeriod(high.value, first, last)) {
+            return false;
+        }
+        range["max"] = (high.inclusive ? last : first.addDays(-1)).toString(Qt::ISODate) + "T23:59:59Z";
+    }
+
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "SearchService.h"
+#include <QString>
+#include <QStringList>
+#include <QDate>
+
+/**
+ * @brief Field syntax in a search box compiled into SearchFilters
+ *
+ * "tag:bracket -tag:obsolete ext:stl size:>50MB tris:<200k date:2025.. gear"
+ * becomes required and excluded tags, a file type, size, triangle count and
+ * import date ranges, and the free text "gear". The filters are the same plan
+ * a caller can build by hand, so both forms run alike: categorical terms are
+ * bitmap operations, ranges go to the database indexes and only the items
+ * surviving them are scored against the free text.
+ *
+ * Ranges are written ">x", ">=x", "<x", "<=x", "a..b", "a..", "..b" or just
+ * "x". Counts take k/m suffixes, sizes KB/MB/GB (binary), and dates are a
+ * year, month or day covering the whole period. Values may be quoted.
+ */
+class SearchQuery
+{
+public:
+    explicit SearchQuery(const QString& query = QString());
+
+    // Free text left once field terms are removed; ends with a space when
+    // its last word is finished, as the search treats the last word as a prefix
+    QString text() const;
+
+    // base with the field terms added; ranges here replace those in base
+    SearchService::SearchFilters applyTo(const SearchService::SearchFilters& base) const;
+
+    bool hasFieldTerms() const;
+
+    // Field terms that could not be read; they are left out of the filters
+    QStringList errors() const;
+
+private:
+    struct Bound {
+        bool set = false;
+        bool inclusive = true;
+        QString value;
+    };
+
+    static QStringList splitTerms(const QString& query);
+    static bool splitRange(const QString& value, Bound& low, Bound& high);
+    static bool parseCount(const QString& value, qint64& count);
+    static bool parseSize(const QString& value, qint64& bytes);
+    static bool parsePeriod(const QString& value, QDate& first, QDate& last);
+
+    bool addFieldTerm(const QString& field, const QString& value, bool negated);
+    bool addNumericRange(const QString& value, bool size, QVariantMap& range);
+    bool addDateRange(const QString& value, QVariantMap& range);
+
+    QStringList m_words;
+    bool m_finished;
+    SearchService::SearchFilters m_filters;
+    bool m_hasFieldTerms;
+    QStringList m_errors;
+};
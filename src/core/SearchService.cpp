@@ -1,15 +1,78 @@
 #include "SearchService.h"
 #include "DatabaseManager.h"
+#include "InvertedIndex.h"
+#include "TrigramIndex.h"
+#include "CompletionTrie.h"
+#include "SearchQuery.h"
+#include "ShapeDescriptor.h"
 #include <QStringList>
 #include <QRegularExpression>
 #include <QDateTime>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QBuffer>
+#include <QDataStream>
+#include <QCryptographicHash>
 #include <QTimer>
 #include <QDebug>
+#include <QtConcurrent>
+#include <QThread>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QMutexLocker>
+#include <QStringView>
 #include <algorithm>
+#include <limits>
+
+// Persisted index: a fixed header (magic, format version, change version,
+// payload size, MD5 of the payload) followed by the payload
+static const quint32 INDEX_FILE_MAGIC = 0x42424958;  // "BBIX"
+static const quint32 INDEX_FILE_VERSION = 3;
+static const int INDEX_HEADER_SIZE = 40;
+
+static void writeBitmaps(QDataStream& out, const QHash<QString, RoaringBitmap>& bitmaps)
+{
+    out << qint32(bitmaps.size());
+    for (auto it = bitmaps.constBegin(); it != bitmaps.constEnd(); ++it) {
+        out << it.key() << it.value().toVector();
+    }
+}
+
+static RoaringBitmap readBitmap(QDataStream& in)
+{
+    QVector<quint32> ids;
+    in >> ids;
+
+    RoaringBitmap bitmap;
+    for (quint32 id : ids) {
+        bitmap.add(id);
+    }
+    return bitmap;
+}
+
+static void readBitmaps(QDataStream& in, QHash<QString, RoaringBitmap>& bitmaps)
+{
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString key;
+        in >> key;
+        bitmaps.insert(key, readBitmap(in));
+    }
+}
 
 SearchService::SearchService(QObject* parent)
     : QObject(parent)
+    , m_searchGeneration(0)
     , m_searchTimer(new QTimer(this))
+    , m_shapeIndex(ShapeDescriptor::DIMENSIONS)
+    , m_indexedChangeVersion(0)
+    , m_indexGeneration(0)
+    , m_lastSearchTime(0)
+    , m_fastSearches(0)
+    , m_slowSearches(0)
     , m_hitCount(0)
     , m_missCount(0)
 {
@@ -17,17 +80,35 @@ SearchService::SearchService(QObject* parent)
     m_searchTimer->setSingleShot(true);
     m_searchTimer->setInterval(100); // 100ms debounce
 
+    // Superseded searches stop early, so two workers keep up with typing
+    m_searchPool.setMaxThreadCount(2);
+
     connect(m_searchTimer, &QTimer::timeout, this, [this]() {
         performAsyncSearch();
     });
 
+    // Catch up incrementally whenever the database reports new changes
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent);
+    if (dbManager) {
+        connect(dbManager, &DatabaseManager::changesAvailable, this, &SearchService::syncIndex);
+        connect(dbManager, &DatabaseManager::databaseRestored, this, &SearchService::rebuildIndex);
+
+        // Running searches read through pooled connections the restore retires
+        connect(dbManager, &DatabaseManager::aboutToRestore, this, [this]() {
+            m_searchTimer->stop();
+            m_searchGeneration++;
+            m_searchPool.waitForDone();
+        });
+    }
+
     // Default search options
     QVariantMap defaultOptions;
     defaultOptions["fuzzy_threshold"] = 0.6;
     defaultOptions["max_results"] = 100;
     defaultOptions["search_delay"] = 100;
     defaultOptions["enable_caching"] = true;
-    defaultOptions["cache_timeout"] = 30000; // 30 seconds
+    defaultOptions["cache_size"] = 256; // cached result lists
+    defaultOptions["shard_count"] = QThread::idealThreadCount(); // parallel index scans
 
     setSearchOptions(defaultOptions);
 
@@ -35,9 +116,22 @@ SearchService::SearchService(QObject* parent)
     qRegisterMetaType<SearchFilters>("SearchFilters");
 }
 
+SearchService::~SearchService()
+{
+    // Workers read the index, so they must finish before it is destroyed
+    m_searchGeneration++;
+    m_searchPool.waitForDone();
+}
+
 QList<SearchResult> SearchService::search(const QString& query,
                                          const QStringList& types,
                                          const QVariantMap& filters)
+{
+    return runSearch(query, types, filters, InvertedIndex::Cancelled());
+}
+
+QList<SearchResult> SearchService::runSearch(const QString& query, const QStringList& types,
+                                             const QVariantMap& filters, const InvertedIndex::Cancelled& cancelled)
 {
     qint64 startTime = QDateTime::currentDateTime().toMSecsSinceEpoch();
 
@@ -49,12 +143,40 @@ QList<SearchResult> SearchService::search(const QString& query,
     if (filters.contains("tags")) {
         searchFilters.tags = filters["tags"].toStringList();
     }
+    if (filters.contains("excludeTags")) {
+        searchFilters.excludeTags = filters["excludeTags"].toStringList();
+    }
+    if (filters.contains("fileTypes")) {
+        searchFilters.fileTypes = filters["fileTypes"].toStringList();
+    }
+    if (filters.contains("projects")) {
+        for (const QVariant& project : filters["projects"].toList()) {
+            searchFilters.projects.append(project.toUuid());
+        }
+    }
+    if (filters.contains("sizeRange")) {
+        searchFilters.sizeRange = filters["sizeRange"].toMap();
+    }
+    if (filters.contains("boundsRange")) {
+        searchFilters.boundsRange = filters["boundsRange"].toMap();
+    }
+    if (filters.contains("customFilters")) {
+        searchFilters.customFilters = filters["customFilters"].toMap();
+    }
 
-    QList<SearchResult> results = performSearch(query, searchFilters);
+    QList<SearchResult> results = cachedSearch(query, searchFilters, cancelled);
+    if (cancelled && cancelled()) {
+        return QList<SearchResult>();
+    }
+
+    if (!results.isEmpty()) {
+        recordQuery(query);
+    }
 
     qint64 elapsed = QDateTime::currentDateTime().toMSecsSinceEpoch() - startTime;
 
     // Update performance metrics
+    QMutexLocker locker(&m_stateMutex);
     m_lastSearchTime = elapsed;
     if (elapsed <= 100) {
         m_fastSearches++;
@@ -72,8 +194,9 @@ QList<SearchResult> SearchService::searchAsync(const QString& query,
                                               const QStringList& types,
                                               const QVariantMap& filters)
 {
-    // Cancel any pending search
+    // Cancel any pending search, and any search already running
     m_searchTimer->stop();
+    m_searchGeneration++;
 
     // Store search parameters for async execution
     m_pendingQuery = query;
@@ -94,12 +217,17 @@ QStringList SearchService::getSuggestions(const QString& partialQuery, int maxSu
         return suggestions;
     }
 
-    // Get recent searches for suggestions
-    suggestions.append(getRecentSearches(maxSuggestions / 2));
-
-    // Get tag suggestions
-    QStringList tagSuggestions = getTagSuggestions(partialQuery, maxSuggestions / 2);
-    suggestions.append(tagSuggestions);
+    // Past queries first, then tags and filenames, each ranked by popularity
+    {
+        QMutexLocker locker(&m_stateMutex);
+        suggestions.append(m_queryCompletions.complete(partialQuery, maxSuggestions));
+    }
+    suggestions.append(getTagSuggestions(partialQuery, maxSuggestions));
+    {
+        QReadLocker locker(&m_indexLock);
+        QMutexLocker completionLocker(&m_completionMutex);
+        suggestions.append(m_filenameCompletions.complete(partialQuery, maxSuggestions));
+    }
 
     // Remove duplicates and limit
     suggestions.removeDuplicates();
@@ -112,37 +240,72 @@ QStringList SearchService::getSuggestions(const QString& partialQuery, int maxSu
 
 QStringList SearchService::getTagSuggestions(const QString& partialTag, int maxSuggestions)
 {
+    // Before the first index build, seed the completions once from the usage
+    // counters. Indexing changes the same trie, so it is seeded under the
+    // write lock, unless an index build got there while the counters were read
     DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
-    if (!dbManager) {
-        return QStringList();
+    bool seeded;
+    {
+        QReadLocker locker(&m_indexLock);
+        seeded = m_tagCompletions.size() > 0;
     }
-
-    QStringList allTags = dbManager->getAllTags();
-    QStringList suggestions;
-
-    for (const QString& tag : allTags) {
-        if (tag.contains(partialTag, Qt::CaseInsensitive)) {
-            suggestions.append(tag);
-            if (suggestions.count() >= maxSuggestions) {
-                break;
+    if (!seeded && dbManager) {
+        QMap<QString, int> usageCounts = dbManager->getTagUsageCounts();
+        QWriteLocker locker(&m_indexLock);
+        if (m_tagCompletions.size() == 0) {
+            for (auto it = usageCounts.constBegin(); it != usageCounts.constEnd(); ++it) {
+                m_tagCompletions.insert(it.key().toLower(), it.value());
             }
         }
     }
 
-    return suggestions;
+    QReadLocker locker(&m_indexLock);
+    QMutexLocker completionLocker(&m_completionMutex);
+    return m_tagCompletions.complete(partialTag, maxSuggestions);
 }
 
 void SearchService::indexModel(const ModelMetadata& model)
 {
+    QWriteLocker locker(&m_indexLock);
+
     // Index model for search
     QString searchableText = buildSearchableText(model);
 
     // Store in search index (simplified for now)
-    m_searchIndex[model.id.toString()] = searchableText;
+    QString key = model.id.toString();
+    indexSearchableText(key, searchableText);
 
-    // Update tag index
+    // Update filter bitmaps, replacing whatever the model had before
+    clearFilterAttributes(key);
+    quint32 id = filterId(key);
+    m_modelBitmap.add(id);
+
+    // A tag's completion weight is the number of indexed items carrying it
     for (const QString& tag : model.tags) {
-        m_tagIndex[tag].append(model.id.toString());
+        RoaringBitmap& tagBitmap = m_tagBitmaps[tag.toLower()];
+        tagBitmap.add(id);
+        m_tagCompletions.insert(tag.toLower(), tagBitmap.cardinality());
+        m_display.tags[id].append(internTag(tag));
+    }
+
+    m_display.names[id] = model.filename;
+    m_display.fileSizes[id] = model.fileSize;
+    m_display.dates[id] = model.importDate;
+    m_display.thumbnails[id] = model.thumbnailPath;
+
+    // Like the database, an update without a descriptor keeps the old one
+    ShapeDescriptor shape = ShapeDescriptor::fromByteArray(model.shapeDescriptor);
+    if (shape.isValid()) {
+        m_shapeIndex.add(key, shape.values());
+    }
+
+    if (!model.filename.isEmpty()) {
+        m_filenameCompletions.addWeight(model.filename, 1);
+
+        QString fileType = QFileInfo(model.filename).suffix().toLower();
+        if (!fileType.isEmpty()) {
+            m_fileTypeBitmaps[fileType].add(id);
+        }
     }
 
     emit itemIndexed(model.id, "model");
@@ -150,11 +313,28 @@ void SearchService::indexModel(const ModelMetadata& model)
 
 void SearchService::indexProject(const ProjectData& project)
 {
+    QWriteLocker locker(&m_indexLock);
+
     // Index project for search
     QString searchableText = buildSearchableText(project);
 
     // Store in search index
-    m_searchIndex[project.id.toString()] = searchableText;
+    QString key = project.id.toString();
+    indexSearchableText(key, searchableText);
+    m_projectIds.insert(key);
+
+    // Members get their dense ids now if they have not been indexed yet
+    clearFilterAttributes(key);
+    quint32 id = filterId(key);
+    m_projectBitmap.add(id);
+    m_display.names[id] = project.name;
+    m_display.dates[id] = project.createdDate;
+
+    RoaringBitmap members;
+    for (const QUuid& modelId : project.modelIds) {
+        members.add(filterId(modelId.toString()));
+    }
+    m_projectMembers.insert(key, members);
 
     // Update tag index
     // Note: Would need to get project tags from database
@@ -162,28 +342,192 @@ void SearchService::indexProject(const ProjectData& project)
     emit itemIndexed(project.id, "project");
 }
 
+void SearchService::indexSearchableText(const QString& id, const QString& searchableText)
+{
+    m_indexGeneration++;
+    m_searchIndex[id] = searchableText;
+    m_invertedIndex.addDocument(id, searchableText);
+
+    // Every word joins the vocabulary used for typo-tolerant lookups
+    for (const QString& term : InvertedIndex::tokenize(searchableText)) {
+        m_trigramIndex.addTerm(term);
+    }
+}
+
 void SearchService::removeFromIndex(const QUuid& id)
 {
+    QWriteLocker locker(&m_indexLock);
     QString idStr = id.toString();
+    m_indexGeneration++;
     m_searchIndex.remove(idStr);
+    m_invertedIndex.removeDocument(idStr);
+    m_projectIds.remove(idStr);
+    m_shapeIndex.remove(idStr);
+    clearFilterAttributes(idStr);
+}
 
-    // Remove from tag index
-    QMutableMapIterator<QString, QStringList> it(m_tagIndex);
-    while (it.hasNext()) {
-        it.next();
-        it.value().removeAll(idStr);
-        if (it.value().isEmpty()) {
-            it.remove();
+quint32 SearchService::filterId(const QString& id)
+{
+    auto it = m_filterIds.constFind(id);
+    if (it != m_filterIds.constEnd()) {
+        return it.value();
+    }
+
+    quint32 filterId = static_cast<quint32>(m_filterKeys.size());
+    m_filterIds.insert(id, filterId);
+    m_filterKeys.append(id);
+
+    m_display.names.append(QString());
+    m_display.tags.append(QVector<quint32>());
+    m_display.fileSizes.append(0);
+    m_display.dates.append(QString());
+    m_display.thumbnails.append(QString());
+    return filterId;
+}
+
+quint32 SearchService::internTag(const QString& tag)
+{
+    auto it = m_display.tagIds.constFind(tag);
+    if (it != m_display.tagIds.constEnd()) {
+        return it.value();
+    }
+
+    quint32 tagId = static_cast<quint32>(m_display.tagNames.size());
+    m_display.tagIds.insert(tag, tagId);
+    m_display.tagNames.append(tag);
+    return tagId;
+}
+
+void SearchService::clearFilterAttributes(const QString& id)
+{
+    auto it = m_filterIds.constFind(id);
+    if (it == m_filterIds.constEnd()) {
+        return;
+    }
+
+    // The dense id is kept so project membership bitmaps stay valid
+    quint32 filterId = it.value();
+    bool model = m_modelBitmap.contains(filterId);
+    m_modelBitmap.remove(filterId);
+    m_projectBitmap.remove(filterId);
+    m_projectMembers.remove(id);
+
+    // Unused tags stay completable with no weight until they are deleted
+    QVector<quint32> tags;
+    tags.swap(m_display.tags[filterId]);
+    for (quint32 tagId : tags) {
+        const QString& tag = m_display.tagNames[tagId];
+        auto tagBitmap = m_tagBitmaps.find(tag.toLower());
+        if (tagBitmap != m_tagBitmaps.end()) {
+            tagBitmap->remove(filterId);
+            m_tagCompletions.insert(tag.toLower(), tagBitmap->cardinality());
+            if (tagBitmap->isEmpty()) {
+                m_tagBitmaps.erase(tagBitmap);
+            }
         }
     }
+
+    QString name;
+    name.swap(m_display.names[filterId]);
+    m_display.fileSizes[filterId] = 0;
+    m_display.dates[filterId].clear();
+    m_display.thumbnails[filterId].clear();
+
+    if (model && !name.isEmpty()) {
+        m_filenameCompletions.addWeight(name, -1);
+
+        auto typeBitmap = m_fileTypeBitmaps.find(QFileInfo(name).suffix().toLower());
+        if (typeBitmap != m_fileTypeBitmaps.end()) {
+            typeBitmap->remove(filterId);
+            if (typeBitmap->isEmpty()) {
+                m_fileTypeBitmaps.erase(typeBitmap);
+            }
+        }
+    }
+}
+
+void SearchService::handleTagCreated(const QString& tag)
+{
+    QWriteLocker locker(&m_indexLock);
+    m_indexGeneration++;
+    if (!m_tagCompletions.contains(tag.toLower())) {
+        m_tagCompletions.insert(tag.toLower(), 0);
+    }
+}
+
+void SearchService::handleTagRenamed(const QString& oldTag, const QString& newTag)
+{
+    QWriteLocker locker(&m_indexLock);
+
+    QString from = oldTag.toLower();
+    QString to = newTag.toLower();
+    if (from == to) {
+        return;
+    }
+
+    m_indexGeneration++;
+
+    // Renaming onto an existing tag is a merge: the item sets are united
+    RoaringBitmap moved = m_tagBitmaps.take(from);
+    quint32 renamed = internTag(newTag);
+    for (quint32 filterId : moved.toVector()) {
+        QVector<quint32> tags;
+        for (quint32 tagId : m_display.tags[filterId]) {
+            if (m_display.tagNames[tagId].toLower() == from) {
+                tagId = renamed;
+            }
+            if (!tags.contains(tagId)) {
+                tags.append(tagId);
+            }
+        }
+        m_display.tags[filterId] = tags;
+    }
+
+    if (!moved.isEmpty()) {
+        m_tagBitmaps[to] |= moved;
+    }
+
+    m_tagCompletions.remove(from);
+    m_tagCompletions.insert(to, m_tagBitmaps.value(to).cardinality());
+}
+
+void SearchService::handleTagDeleted(const QString& tag)
+{
+    QWriteLocker locker(&m_indexLock);
+    m_indexGeneration++;
+
+    // A tag still carried by indexed items keeps completing until they are re-synced
+    if (!m_tagBitmaps.contains(tag.toLower())) {
+        m_tagCompletions.remove(tag.toLower());
+    }
+}
+
+void SearchService::recordQuery(const QString& query)
+{
+    static const int MAX_RECENT_QUERIES = 50;
+
+    QString normalised = query.simplified().toLower();
+    if (normalised.length() < 2) {
+        return;
+    }
+
+    QMutexLocker locker(&m_stateMutex);
+    m_recentQueries.removeAll(normalised);
+    m_recentQueries.prepend(normalised);
+    while (m_recentQueries.count() > MAX_RECENT_QUERIES) {
+        m_recentQueries.removeLast();
+    }
+
+    // Repeated queries complete ahead of one-off ones
+    m_queryCompletions.addWeight(normalised, 1);
 }
 
 void SearchService::rebuildIndex()
 {
     qInfo() << "Rebuilding search index...";
 
-    m_searchIndex.clear();
-    m_tagIndex.clear();
+    QWriteLocker locker(&m_indexLock);
+    clearIndex();
 
     DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
     if (!dbManager) {
@@ -191,10 +535,23 @@ void SearchService::rebuildIndex()
         return;
     }
 
-    // Index all models
-    QList<ModelMetadata> models = dbManager->getAllModels();
-    for (const ModelMetadata& model : models) {
-        indexModel(model);
+    // Taken before reading so changes made during the rebuild are replayed
+    m_indexedChangeVersion = dbManager->currentChangeVersion();
+
+    // Index all models, streaming only the columns that feed the searchable
+    // text and the result display
+    int modelCount = 0;
+    ModelCursor cursor = dbManager->openModelCursor(
+        ModelCursor::Filename | ModelCursor::Tags | ModelCursor::CustomFields
+        | ModelCursor::FileSize | ModelCursor::ImportDate | ModelCursor::ThumbnailPath | ModelCursor::Shape);
+    while (cursor.next()) {
+        indexModel(cursor.current());
+        modelCount++;
+    }
+
+    // Tags nothing carries yet still complete, with no weight
+    for (const QString& tag : dbManager->getAllTags()) {
+        handleTagCreated(tag);
     }
 
     // Index all projects
@@ -203,28 +560,297 @@ void SearchService::rebuildIndex()
         indexProject(project);
     }
 
+    locker.unlock();
     emit indexRebuilt();
     qInfo() << QString("Search index rebuilt: %1 models, %2 projects")
-              .arg(models.count()).arg(projects.count());
+              .arg(modelCount).arg(projects.count());
+}
+
+void SearchService::clearIndex()
+{
+    m_indexGeneration++;
+
+    m_searchIndex.clear();
+    m_invertedIndex.clear();
+    m_trigramIndex.clear();
+    m_projectIds.clear();
+    m_filterIds.clear();
+    m_filterKeys.clear();
+    m_modelBitmap.clear();
+    m_projectBitmap.clear();
+    m_tagBitmaps.clear();
+    m_fileTypeBitmaps.clear();
+    m_projectMembers.clear();
+    m_display = DisplayColumns();
+    m_shapeIndex.clear();
+    m_tagCompletions.clear();
+    m_filenameCompletions.clear();
+}
+
+bool SearchService::saveIndex(const QString& path)
+{
+    // The postings may still be mapped from the file about to be replaced,
+    // and Windows refuses to rename over a mapped file
+    {
+        QWriteLocker locker(&m_indexLock);
+        m_invertedIndex.detach();
+    }
+
+    QByteArray payload;
+    qint64 changeVersion;
+    int itemCount;
+    {
+        QReadLocker locker(&m_indexLock);
+        changeVersion = m_indexedChangeVersion;
+        itemCount = m_searchIndex.size();
+
+        // Completions and the trigram vocabulary are cheap to derive, so only
+        // what needs the database or tokenising is stored
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << m_searchIndex << m_projectIds << m_filterKeys;
+        out << m_display.names << m_display.tags << m_display.fileSizes << m_display.dates
+            << m_display.thumbnails << m_display.tagNames;
+        out << m_modelBitmap.toVector() << m_projectBitmap.toVector();
+        writeBitmaps(out, m_tagBitmaps);
+        writeBitmaps(out, m_fileTypeBitmaps);
+        writeBitmaps(out, m_projectMembers);
+        m_shapeIndex.save(out);
+        m_invertedIndex.save(out);
+    }
+
+    QByteArray checksum = QCryptographicHash::hash(payload, QCryptographicHash::Md5);
+
+    // QSaveFile only replaces the old file once everything is written
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write search index:" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream header(&file);
+    header.setVersion(QDataStream::Qt_6_0);
+    header << INDEX_FILE_MAGIC << INDEX_FILE_VERSION << changeVersion << quint64(payload.size());
+    header.writeRawData(checksum.constData(), static_cast<int>(checksum.size()));
+    file.write(payload);
+
+    if (!file.commit()) {
+        qWarning() << "Failed to save search index:" << path << file.errorString();
+        return false;
+    }
+
+    // The saved index can be caught up from here on, so older records are
+    // no longer needed by anyone
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (dbManager && changeVersion > 0) {
+        dbManager->pruneChangeLog(changeVersion);
+    }
+
+    qInfo() << QString("Search index saved: %1 items at change version %2").arg(itemCount).arg(changeVersion);
+    return true;
+}
+
+bool SearchService::loadIndex(const QString& path)
+{
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (!dbManager) {
+        return false;
+    }
+
+    // A missing file is the normal first run
+    QSharedPointer<QFile> file(new QFile(path));
+    if (!file->open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 size = file->size();
+    const char* data = size > INDEX_HEADER_SIZE ? reinterpret_cast<const char*>(file->map(0, size)) : nullptr;
+    if (!data) {
+        qWarning() << "Cannot map search index:" << path;
+        return false;
+    }
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint64 changeVersion = 0;
+    quint64 payloadSize = 0;
+    QByteArray checksum(16, '\0');
+
+    QDataStream header(QByteArray::fromRawData(data, INDEX_HEADER_SIZE));
+    header.setVersion(QDataStream::Qt_6_0);
+    header >> magic >> version >> changeVersion >> payloadSize;
+    header.readRawData(checksum.data(), static_cast<int>(checksum.size()));
+
+    if (magic != INDEX_FILE_MAGIC || version != INDEX_FILE_VERSION
+        || payloadSize != static_cast<quint64>(size - INDEX_HEADER_SIZE)) {
+        qWarning() << "Search index has an unknown format or is truncated:" << path;
+        return false;
+    }
+
+    QByteArray payload = QByteArray::fromRawData(data + INDEX_HEADER_SIZE, size - INDEX_HEADER_SIZE);
+    if (QCryptographicHash::hash(payload, QCryptographicHash::Md5) != checksum) {
+        qWarning() << "Search index checksum mismatch:" << path;
+        return false;
+    }
+
+    // Catching up needs every change after the saved version still in the log;
+    // a newer version than the database means it belongs to another database
+    qint64 currentVersion = dbManager->currentChangeVersion();
+    qint64 oldestVersion = dbManager->oldestChangeVersion();
+    if (changeVersion > currentVersion
+        || (changeVersion < currentVersion && (oldestVersion == 0 || oldestVersion > changeVersion + 1))) {
+        qInfo() << "Search index cannot be caught up with the database:" << path;
+        return false;
+    }
+
+    QWriteLocker locker(&m_indexLock);
+    clearIndex();
+
+    // Postings are used straight from the mapping; the rest is copied out
+    QBuffer buffer(&payload);
+    buffer.open(QIODevice::ReadOnly);
+    QDataStream in(&buffer);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    in >> m_searchIndex >> m_projectIds >> m_filterKeys;
+    in >> m_display.names >> m_display.tags >> m_display.fileSizes >> m_display.dates
+       >> m_display.thumbnails >> m_display.tagNames;
+    m_modelBitmap = readBitmap(in);
+    m_projectBitmap = readBitmap(in);
+    readBitmaps(in, m_tagBitmaps);
+    readBitmaps(in, m_fileTypeBitmaps);
+    readBitmaps(in, m_projectMembers);
+    bool shapesLoaded = m_shapeIndex.load(in);
+
+    int itemIds = m_filterKeys.size();
+    bool columnsMatch = m_display.names.size() == itemIds && m_display.tags.size() == itemIds
+                        && m_display.fileSizes.size() == itemIds && m_display.dates.size() == itemIds
+                        && m_display.thumbnails.size() == itemIds;
+
+    if (in.status() != QDataStream::Ok || !columnsMatch || !shapesLoaded
+        || !m_invertedIndex.load(in, payload, file)) {
+        qWarning() << "Search index is corrupt:" << path;
+        clearIndex();
+        return false;
+    }
+
+    for (int id = 0; id < m_filterKeys.size(); ++id) {
+        m_filterIds.insert(m_filterKeys[id], static_cast<quint32>(id));
+    }
+    for (int tagId = 0; tagId < m_display.tagNames.size(); ++tagId) {
+        m_display.tagIds.insert(m_display.tagNames[tagId], static_cast<quint32>(tagId));
+    }
+    for (const QString& term : m_invertedIndex.terms()) {
+        m_trigramIndex.addTerm(term);
+    }
+    for (auto it = m_tagBitmaps.constBegin(); it != m_tagBitmaps.constEnd(); ++it) {
+        m_tagCompletions.insert(it.key(), it.value().cardinality());
+    }
+    for (quint32 id : m_modelBitmap.toVector()) {
+        if (!m_display.names[id].isEmpty()) {
+            m_filenameCompletions.addWeight(m_display.names[id], 1);
+        }
+    }
+    for (const QString& tag : dbManager->getAllTags()) {
+        handleTagCreated(tag);
+    }
+
+    m_indexedChangeVersion = changeVersion;
+    int itemCount = m_searchIndex.size();
+    locker.unlock();
+
+    syncIndex();
+
+    emit indexRebuilt();
+    qInfo() << QString("Search index loaded: %1 items, replayed changes %2 to %3")
+              .arg(itemCount).arg(changeVersion).arg(currentVersion);
+    return true;
+}
+
+void SearchService::syncIndex()
+{
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (!dbManager) {
+        return;
+    }
+
+    static const int SYNC_BATCH_SIZE = 1000;
+
+    QWriteLocker locker(&m_indexLock);
+
+    QList<DatabaseManager::Change> changes;
+    do {
+        changes = dbManager->changesSince(m_indexedChangeVersion, SYNC_BATCH_SIZE);
+        if (changes.isEmpty()) {
+            break;
+        }
+
+        // Collapse the batch to the latest operation per entity
+        QSet<QUuid> staleModels;
+        QSet<QUuid> staleProjects;
+        for (const DatabaseManager::Change& change : changes) {
+            QSet<QUuid>& stale = (change.entity == "project") ? staleProjects : staleModels;
+            if (change.operation == "delete") {
+                stale.remove(change.id);
+                removeFromIndex(change.id);
+            } else {
+                stale.insert(change.id);
+            }
+        }
+
+        // Re-read changed models in one pass, only the columns the index uses
+        ModelCursor cursor = dbManager->openModelCursor(
+            staleModels.values(), ModelCursor::Filename | ModelCursor::Tags | ModelCursor::CustomFields
+                                  | ModelCursor::FileSize | ModelCursor::ImportDate | ModelCursor::ThumbnailPath
+                                  | ModelCursor::Shape);
+        while (cursor.next()) {
+            removeFromIndex(cursor.current().id);
+            indexModel(cursor.current());
+        }
+
+        for (const QUuid& projectId : staleProjects) {
+            removeFromIndex(projectId);
+            ProjectData project = dbManager->getProject(projectId);
+            if (!project.id.isNull()) {
+                indexProject(project);
+            }
+        }
+
+        m_indexedChangeVersion = changes.last().version;
+    } while (changes.count() == SYNC_BATCH_SIZE);
 }
 
 void SearchService::setSearchOptions(const QVariantMap& options)
 {
+    // Taken before m_stateMutex, the order searches use
+    if (options.contains("shard_count")) {
+        QWriteLocker indexLocker(&m_indexLock);
+        m_invertedIndex.setShardCount(options["shard_count"].toInt());
+    }
+
+    QMutexLocker locker(&m_stateMutex);
     m_searchOptions = options;
 
     // Update timer interval if specified
     if (options.contains("search_delay")) {
         m_searchTimer->setInterval(options["search_delay"].toInt());
     }
+
+    if (options.contains("cache_size")) {
+        m_searchCache.setMaxCost(qMax(1, options["cache_size"].toInt()));
+    }
 }
 
 QVariantMap SearchService::getSearchOptions() const
 {
+    QMutexLocker locker(&m_stateMutex);
     return m_searchOptions;
 }
 
 PerformanceMetrics SearchService::getSearchMetrics() const
 {
+    QMutexLocker locker(&m_stateMutex);
+
     PerformanceMetrics metrics;
     metrics.operationType = "SearchService";
     metrics.operationTimeMs = m_lastSearchTime;
@@ -237,12 +863,15 @@ PerformanceMetrics SearchService::getSearchMetrics() const
     details["fast_searches"] = m_fastSearches;
     details["slow_searches"] = m_slowSearches;
     details["index_size"] = m_searchIndex.size();
+    details["cached_queries"] = m_searchCache.size();
+    metrics.details = details;
 
     return metrics;
 }
 
 void SearchService::clearSearchCache()
 {
+    QMutexLocker locker(&m_stateMutex);
     m_searchCache.clear();
     m_hitCount = 0;
     m_missCount = 0;
@@ -250,70 +879,299 @@ void SearchService::clearSearchCache()
 
 QList<SearchResult> SearchService::searchWithFilters(const QString& query, const SearchFilters& filters)
 {
-    return performSearch(query, filters);
+    return cachedSearch(query, filters);
+}
+
+QList<SearchResult> SearchService::searchWithFacets(const QString& query, const SearchFilters& filters,
+                                                   FacetCounts& facets, int maxFacetValues)
+{
+    return cachedSearch(query, filters, InvertedIndex::Cancelled(), &facets, qMax(1, maxFacetValues));
 }
 
-QList<SearchResult> SearchService::performSearch(const QString& query, const SearchFilters& filters)
+QList<SearchResult> SearchService::cachedSearch(const QString& query, const SearchFilters& filters,
+                                               const InvertedIndex::Cancelled& cancelled,
+                                               FacetCounts* facets, int maxFacetValues)
+{
+    // Held throughout so the generation cannot move while results are computed
+    QReadLocker indexLocker(&m_indexLock);
+
+    // Field terms in the query join the filters, so typed and programmatic
+    // forms of the same search share one plan and one cache entry
+    SearchQuery compiled(query);
+    QString text = compiled.text();
+    SearchFilters plan = compiled.applyTo(filters);
+
+    // Faceted searches are cached apart, per facet limit
+    QString key = cacheKey(text, plan);
+    if (facets) {
+        key += QString("#facets=%1").arg(maxFacetValues);
+    }
+
+    bool caching;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        caching = m_searchOptions.value("enable_caching", true).toBool();
+
+        // An entry computed against an older index is treated as absent
+        CachedSearch* cached = caching ? m_searchCache.object(key) : nullptr;
+        if (cached && cached->generation == m_indexGeneration) {
+            m_hitCount++;
+            if (facets) {
+                *facets = cached->facets;
+            }
+            return cached->results;
+        }
+        m_missCount++;
+    }
+
+    QList<SearchResult> results = performSearch(text, plan, cancelled, facets, maxFacetValues);
+
+    // A cancelled search may have stopped part way
+    if (caching && !(cancelled && cancelled())) {
+        QMutexLocker locker(&m_stateMutex);
+        m_searchCache.insert(key, new CachedSearch{m_indexGeneration, results,
+                                                   facets ? *facets : FacetCounts()});
+    }
+    return results;
+}
+
+QString SearchService::cacheKey(const QString& query, const SearchFilters& filters) const
+{
+    auto normalisedList = [](QStringList values) {
+        for (QString& value : values) {
+            value = value.toLower();
+        }
+        values.sort();
+        return values;
+    };
+
+    QStringList projects;
+    for (const QUuid& project : filters.projects) {
+        projects.append(project.toString());
+    }
+    projects.sort();
+
+    // A trailing space ends the last term, which changes prefix matching
+    QVariantMap key;
+    key["query"] = query.simplified().toLower();
+    key["typing"] = !query.isEmpty() && !query.at(query.size() - 1).isSpace();
+    key["types"] = normalisedList(filters.contentTypes);
+    key["tags"] = normalisedList(filters.tags);
+    key["excludeTags"] = normalisedList(filters.excludeTags);
+    key["fileTypes"] = normalisedList(filters.fileTypes);
+    key["projects"] = projects;
+    key["dateRange"] = filters.dateRange;
+    key["sizeRange"] = filters.sizeRange;
+    key["boundsRange"] = filters.boundsRange;
+    key["customFilters"] = filters.customFilters;
+    key["sortBy"] = filters.sortBy;
+    key["sortDescending"] = filters.sortDescending;
+    key["maxResults"] = filters.maxResults;
+
+    // Object keys serialise sorted, so equal filters always give the same key
+    return QString::fromUtf8(QJsonDocument(QJsonObject::fromVariantMap(key)).toJson(QJsonDocument::Compact));
+}
+
+QList<SearchResult> SearchService::performSearch(const QString& query, const SearchFilters& filters,
+                                                 const InvertedIndex::Cancelled& cancelled,
+                                                 FacetCounts* facets, int maxFacetValues)
 {
     QList<SearchResult> results;
 
+    // Every match by dense id, not just the returned page, when facets are wanted
+    RoaringBitmap matched;
+    bool matchedComplete = true;
+
+    QVariantMap rangeFilters = buildRangeFilters(filters);
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+
+    // Categorical filters are resolved up front so candidates are rejected before scoring
+    RoaringBitmap allowed;
+    bool restricted = buildFilterBitmap(filters, allowed);
+    InvertedIndex::Filter accept;
+    if (restricted) {
+        accept = [this, &allowed](const QString& id) {
+            auto it = m_filterIds.constFind(id);
+            return it != m_filterIds.constEnd() && allowed.contains(it.value());
+        };
+    }
+
     if (query.trimmed().isEmpty()) {
+        if (!rangeFilters.isEmpty() && dbManager) {
+            // A pure range query is answered straight from the indexes
+            bool everyMatch = restricted || facets;
+            QList<QUuid> ids = dbManager->findModelsInRanges(rangeFilters, everyMatch ? -1 : filters.maxResults);
+            for (const QUuid& id : ids) {
+                if (results.count() >= filters.maxResults && !facets) {
+                    break;
+                }
+                if (accept && !accept(id.toString())) {
+                    continue;
+                }
+
+                if (facets) {
+                    auto it = m_filterIds.constFind(id.toString());
+                    if (it != m_filterIds.constEnd()) {
+                        matched.add(it.value());
+                    }
+                }
+                if (results.count() >= filters.maxResults) {
+                    continue;
+                }
+
+                SearchResult result = createSearchResult(id.toString());
+                if (!result.id.isNull()) {
+                    result.relevance = 1.0;
+                    results.append(result);
+                }
+            }
+        } else {
+            // Browsing by tag, type or project is answered from the bitmaps
+            // alone; with no filters at all only the facets cover everything
+            if (restricted) {
+                for (quint32 filterId : allowed.toVector()) {
+                    if (results.count() >= filters.maxResults) {
+                        break;
+                    }
+
+                    SearchResult result = createSearchResult(m_filterKeys[filterId]);
+                    if (!result.id.isNull()) {
+                        result.relevance = 1.0;
+                        results.append(result);
+                    }
+                }
+            }
+            matched = allowed;
+        }
+
+        if (facets) {
+            countFacets(matched, matchedComplete, maxFacetValues, *facets);
+        }
         return results;
     }
 
+    // Ranges narrow the candidate set before scoring, like the categorical
+    // filters, so text matches outside the leading rows are not lost
+    if (!rangeFilters.isEmpty() && dbManager && m_invertedIndex.documentCount() > 0) {
+        RoaringBitmap inRange;
+        for (const QUuid& id : dbManager->findModelsInRanges(rangeFilters, -1)) {
+            auto it = m_filterIds.constFind(id.toString());
+            if (it != m_filterIds.constEnd()) {
+                inRange.add(it.value());
+            }
+        }
+        allowed = restricted ? allowed & inRange : inRange;
+        if (!restricted) {
+            restricted = true;
+            accept = [this, &allowed](const QString& id) {
+                auto it = m_filterIds.constFind(id);
+                return it != m_filterIds.constEnd() && allowed.contains(it.value());
+            };
+        }
+        if (allowed.isEmpty()) {
+            if (facets) {
+                countFacets(allowed, true, maxFacetValues, *facets);
+            }
+            return results;
+        }
+    }
+
     QStringList searchTerms = extractSearchTerms(query);
 
     // Search in index
     QMap<QString, qreal> scoredResults;
 
-    for (auto it = m_searchIndex.begin(); it != m_searchIndex.end(); ++it) {
-        QString id = it.key();
-        QString searchableText = it.value();
+    int candidateLimit = qMax(filters.maxResults * 4, 200);
 
-        qreal score = calculateRelevance(query, searchableText, searchTerms);
+    // Candidates come from the in-memory postings: only documents holding
+    // every term are touched, and the last term matches as a prefix while
+    // the user is still typing it
+    InvertedIndex::Matches matches;
+    bool typing = !query.at(query.size() - 1).isSpace();
+    QList<InvertedIndex::Hit> hits = searchIndex(InvertedIndex::tokenize(searchTerms.join(' ')), typing,
+                                                 candidateLimit, restricted, allowed, accept, cancelled, &matches);
 
-        if (score > 0.1) { // Minimum relevance threshold
-            scoredResults[id] = score;
-        }
+    if (cancelled && cancelled()) {
+        return results;
     }
 
-    // Filter by content types if specified
-    if (!filters.contentTypes.isEmpty()) {
-        QMutableMapIterator<QString, qreal> it(scoredResults);
-        while (it.hasNext()) {
-            it.next();
-            QString id = it.key();
+    // Until the index is built the database full-text query answers instead,
+    // with range filters pushed into it
+    QList<QUuid> ftsCandidates;
+    if (dbManager && hits.isEmpty() && m_invertedIndex.documentCount() == 0) {
+        ftsCandidates = dbManager->fullTextSearch(query, candidateLimit, rangeFilters);
+    }
 
-            // Determine content type (simplified)
-            QString contentType = determineContentType(id);
+    if (!hits.isEmpty()) {
+        // Normalise bm25 against the best hit and keep every hit above the fuzzy range
+        qreal topScore = qMax<qreal>(hits.first().score, 1e-9);
+        for (const InvertedIndex::Hit& hit : hits) {
+            scoredResults[hit.key] = 1.0 + hit.score / topScore;
+        }
+    } else if (!ftsCandidates.isEmpty()) {
+        for (int rank = 0; rank < ftsCandidates.count(); ++rank) {
+            QString id = ftsCandidates[rank].toString();
+            qreal score = calculateRelevance(query, m_searchIndex.value(id), searchTerms);
+            scoredResults[id] = score + 1.0 - static_cast<qreal>(rank) / ftsCandidates.count();
+        }
+    } else {
+        // No exact or prefix hits: widen each term to nearby spellings from the
+        // trigram vocabulary instead of fuzzy matching every entry
+        static const int MAX_SPELLINGS_PER_TERM = 8;
+
+        QList<QStringList> termSets;
+        for (const QString& term : InvertedIndex::tokenize(searchTerms.join(' '))) {
+            QStringList spellings = {term};
+            for (const TrigramIndex::Match& match : m_trigramIndex.similarTerms(
+                     term, TrigramIndex::defaultMaxDistance(term), MAX_SPELLINGS_PER_TERM)) {
+                spellings.append(match.term);
+            }
+            termSets.append(spellings);
+        }
 
-            if (!filters.contentTypes.contains(contentType)) {
-                it.remove();
+        matches = InvertedIndex::Matches();
+        QList<InvertedIndex::Hit> corrected = m_invertedIndex.searchAlternatives(termSets, candidateLimit, accept,
+                                                                                 &matches, cancelled);
+        if (!corrected.isEmpty()) {
+            // Corrected matches stay below anything an exact query would score
+            qreal topScore = qMax<qreal>(corrected.first().score, 1e-9);
+            for (const InvertedIndex::Hit& hit : corrected) {
+                scoredResults[hit.key] = hit.score / topScore;
             }
         }
     }
 
-    // Filter by tags if specified
-    if (!filters.tags.isEmpty()) {
+    // Full-text candidates come from the database, so they are filtered here
+    if (restricted && !ftsCandidates.isEmpty()) {
         QMutableMapIterator<QString, qreal> it(scoredResults);
         while (it.hasNext()) {
             it.next();
-            QString id = it.key();
-
-            QStringList itemTags = getItemTags(id);
-            bool hasAllTags = true;
+            if (!accept(it.key())) {
+                it.remove();
+            }
+        }
+    }
 
-            for (const QString& requiredTag : filters.tags) {
-                if (!itemTags.contains(requiredTag, Qt::CaseInsensitive)) {
-                    hasAllTags = false;
-                    break;
+    // Index matches cover every hit; the database only returns the leading ones
+    if (facets && !(cancelled && cancelled())) {
+        if (ftsCandidates.isEmpty()) {
+            for (quint32 doc : matches.docs) {
+                auto it = m_filterIds.constFind(m_invertedIndex.key(doc));
+                if (it != m_filterIds.constEnd()) {
+                    matched.add(it.value());
                 }
             }
-
-            if (!hasAllTags) {
-                it.remove();
+            matchedComplete = matches.complete;
+        } else {
+            for (auto it = scoredResults.constBegin(); it != scoredResults.constEnd(); ++it) {
+                auto filterId = m_filterIds.constFind(it.key());
+                if (filterId != m_filterIds.constEnd()) {
+                    matched.add(filterId.value());
+                }
             }
+            matchedComplete = ftsCandidates.count() < candidateLimit;
         }
+        countFacets(matched, matchedComplete, maxFacetValues, *facets);
     }
 
     // Sort by relevance score
@@ -330,11 +1188,11 @@ QList<SearchResult> SearchService::performSearch(const QString& query, const Sea
     // Convert to SearchResult objects
     int resultCount = 0;
     for (const QPair<QString, qreal>& pair : sortedResults) {
-        if (resultCount >= filters.maxResults) {
+        if (resultCount >= filters.maxResults || (cancelled && cancelled())) {
             break;
         }
 
-        SearchResult result = createSearchResult(pair.first, query);
+        SearchResult result = createSearchResult(pair.first);
         if (result.id.isNull()) {
             continue; // Skip invalid results
         }
@@ -347,6 +1205,92 @@ QList<SearchResult> SearchService::performSearch(const QString& query, const Sea
     return results;
 }
 
+QList<InvertedIndex::Hit> SearchService::searchIndex(const QStringList& terms, bool typing, int maxResults,
+                                                     bool restricted, const RoaringBitmap& allowed,
+                                                     const InvertedIndex::Filter& accept,
+                                                     const InvertedIndex::Cancelled& cancelled,
+                                                     InvertedIndex::Matches* matched)
+{
+    // Beyond this many matches, keeping their ids costs more than a rescan saves
+    static const int MAX_REFINE_CANDIDATES = 20000;
+
+    bool narrows;
+    QVector<quint32> candidates;
+    {
+        QMutexLocker locker(&m_stateMutex);
+        narrows = narrowsLastSearch(terms, typing, restricted, allowed);
+        if (narrows) {
+            candidates = m_lastSearch.matches.docs;
+        }
+    }
+
+    InvertedIndex::Matches matches;
+    QList<InvertedIndex::Hit> hits;
+    if (narrows) {
+        hits = m_invertedIndex.refine(candidates, terms, maxResults, typing, accept, &matches, cancelled);
+    } else {
+        hits = m_invertedIndex.search(terms, maxResults, typing, accept, &matches, cancelled);
+    }
+
+    if (matched) {
+        *matched = matches;
+    }
+
+    // A partial scan says nothing about the next keystroke
+    if (cancelled && cancelled()) {
+        return hits;
+    }
+
+    QMutexLocker locker(&m_stateMutex);
+    m_lastSearch.valid = !terms.isEmpty() && matches.complete && matches.docs.size() <= MAX_REFINE_CANDIDATES;
+    if (m_lastSearch.valid) {
+        m_lastSearch.generation = m_indexGeneration;
+        m_lastSearch.terms = terms;
+        m_lastSearch.prefixLast = typing;
+        m_lastSearch.restricted = restricted;
+        m_lastSearch.allowed = allowed;
+        m_lastSearch.matches = matches;
+    } else {
+        m_lastSearch.allowed.clear();
+        m_lastSearch.matches.docs.clear();
+    }
+
+    return hits;
+}
+
+bool SearchService::narrowsLastSearch(const QStringList& terms, bool typing,
+                                      bool restricted, const RoaringBitmap& allowed) const
+{
+    // Called with m_stateMutex held
+    // Match ids are only meaningful for the index they were taken from
+    if (!m_lastSearch.valid || m_lastSearch.generation != m_indexGeneration || terms.isEmpty()) {
+        return false;
+    }
+
+    // Added filters may only remove items
+    if (m_lastSearch.restricted && (!restricted || !(allowed - m_lastSearch.allowed).isEmpty())) {
+        return false;
+    }
+
+    // Every earlier term must be implied by some new one: a finished word by
+    // the same finished word, a prefix by any word extending it
+    for (int i = 0; i < m_lastSearch.terms.size(); ++i) {
+        const QString& previous = m_lastSearch.terms[i];
+        bool previousPrefix = m_lastSearch.prefixLast && i == m_lastSearch.terms.size() - 1;
+
+        bool implied = false;
+        for (int j = 0; j < terms.size() && !implied; ++j) {
+            bool prefix = typing && j == terms.size() - 1;
+            implied = previousPrefix ? terms[j].startsWith(previous) : (!prefix && terms[j] == previous);
+        }
+        if (!implied) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 qreal SearchService::calculateRelevance(const QString& query, const SearchResult& result)
 {
     QString searchableText = m_searchIndex[result.id.toString()];
@@ -374,6 +1318,191 @@ qreal SearchService::calculateRelevance(const QString& query, const QString& sea
     return totalScore / searchTerms.count();
 }
 
+QVariantMap SearchService::buildRangeFilters(const SearchFilters& filters) const
+{
+    QVariantMap ranges;
+
+    if (!filters.sizeRange.isEmpty()) {
+        ranges["file_size"] = filters.sizeRange;
+    }
+
+    // ISO text bounds on the import date ("min"/"max")
+    if (!filters.dateRange.isEmpty()) {
+        ranges["import_date"] = filters.dateRange;
+    }
+
+    // Bounds arrive as {"min": {x, y, z}, "max": {x, y, z}}, one range per axis
+    for (const QString& axis : {QString("x"), QString("y"), QString("z")}) {
+        QVariantMap axisRange;
+        for (const QString& limit : {QString("min"), QString("max")}) {
+            QVariantMap extents = filters.boundsRange.value(limit).toMap();
+            if (extents.contains(axis)) {
+                axisRange[limit] = extents.value(axis);
+            }
+        }
+        if (!axisRange.isEmpty()) {
+            ranges["bounds_" + axis] = axisRange;
+        }
+    }
+
+    // Only the typed mesh statistics can be pushed down
+    for (const QString& stat : {QString("vertex_count"), QString("triangle_count")}) {
+        if (filters.customFilters.contains(stat)) {
+            ranges[stat] = filters.customFilters.value(stat).toMap();
+        }
+    }
+
+    return ranges;
+}
+
+bool SearchService::buildFilterBitmap(const SearchFilters& filters, RoaringBitmap& allowed) const
+{
+    bool restricted = false;
+
+    // Content types are alternatives; either way only indexed items remain
+    if (filters.contentTypes.isEmpty()) {
+        allowed = m_modelBitmap | m_projectBitmap;
+    } else {
+        allowed.clear();
+        if (filters.contentTypes.contains("model")) {
+            allowed |= m_modelBitmap;
+        }
+        if (filters.contentTypes.contains("project")) {
+            allowed |= m_projectBitmap;
+        }
+        restricted = true;
+    }
+
+    // Required tags AND together, rarest first so the running set shrinks fastest
+    QList<RoaringBitmap> required;
+    for (const QString& tag : filters.tags) {
+        required.append(m_tagBitmaps.value(tag.toLower()));
+    }
+    std::sort(required.begin(), required.end(), [](const RoaringBitmap& a, const RoaringBitmap& b) {
+        return a.cardinality() < b.cardinality();
+    });
+    for (const RoaringBitmap& tagBitmap : required) {
+        allowed = tagBitmap & allowed;
+        restricted = true;
+    }
+
+    // File types and projects OR within their own group
+    if (!filters.fileTypes.isEmpty()) {
+        RoaringBitmap fileTypes;
+        for (const QString& fileType : filters.fileTypes) {
+            QString extension = fileType.toLower();
+            if (extension.startsWith('.')) {
+                extension.remove(0, 1);
+            }
+            fileTypes |= m_fileTypeBitmaps.value(extension);
+        }
+        allowed &= fileTypes;
+        restricted = true;
+    }
+
+    if (!filters.projects.isEmpty()) {
+        RoaringBitmap members;
+        for (const QUuid& project : filters.projects) {
+            members |= m_projectMembers.value(project.toString());
+        }
+        allowed &= members;
+        restricted = true;
+    }
+
+    // Excluded tags are subtracted last
+    for (const QString& tag : filters.excludeTags) {
+        allowed -= m_tagBitmaps.value(tag.toLower());
+        restricted = true;
+    }
+
+    return restricted;
+}
+
+void SearchService::countFacets(const RoaringBitmap& matched, bool complete, int maxFacetValues,
+                                FacetCounts& facets) const
+{
+    static const qint64 MB = 1024 * 1024;
+    static const int SIZE_BUCKETS = 4;
+    static const qint64 sizeLimits[SIZE_BUCKETS] = {MB, 10 * MB, 100 * MB, std::numeric_limits<qint64>::max()};
+    static const char* sizeLabels[SIZE_BUCKETS] = {"< 1 MB", "1-10 MB", "10-100 MB", ">= 100 MB"};
+
+    facets = FacetCounts();
+    facets.exact = complete;
+
+    // One pass over the matches, reading only the display columns; months
+    // are keyed by views into the stored dates so nothing is allocated per item
+    QVector<int> tagCounts(m_display.tagNames.size(), 0);
+    int sizeCounts[SIZE_BUCKETS] = {};
+    QHash<QStringView, int> monthCounts;
+
+    for (quint32 id : matched.toVector()) {
+        facets.total++;
+
+        for (quint32 tagId : m_display.tags[id]) {
+            tagCounts[tagId]++;
+        }
+
+        if (m_modelBitmap.contains(id)) {
+            int bucket = 0;
+            while (m_display.fileSizes[id] >= sizeLimits[bucket]) {
+                ++bucket;
+            }
+            sizeCounts[bucket]++;
+        }
+
+        const QString& date = m_display.dates[id];
+        if (date.size() >= 7) {
+            monthCounts[QStringView(date).left(7)]++;
+        }
+    }
+
+    auto byCount = [](const FacetValue& a, const FacetValue& b) {
+        return a.count != b.count ? a.count > b.count : a.value < b.value;
+    };
+
+    // Spellings of one tag are counted together, as the tag filter matches them
+    QHash<QString, FacetValue> tags;
+    for (int tagId = 0; tagId < tagCounts.size(); ++tagId) {
+        if (tagCounts[tagId] > 0) {
+            FacetValue& tag = tags[m_display.tagNames[tagId].toLower()];
+            if (tag.value.isEmpty()) {
+                tag.value = m_display.tagNames[tagId];
+            }
+            tag.count += tagCounts[tagId];
+        }
+    }
+    facets.tags = tags.values();
+    std::sort(facets.tags.begin(), facets.tags.end(), byCount);
+
+    // Extensions are few, so their bitmaps are intersected directly
+    for (auto it = m_fileTypeBitmaps.constBegin(); it != m_fileTypeBitmaps.constEnd(); ++it) {
+        int count = static_cast<int>((matched & it.value()).cardinality());
+        if (count > 0) {
+            facets.fileTypes.append({it.key(), count});
+        }
+    }
+    std::sort(facets.fileTypes.begin(), facets.fileTypes.end(), byCount);
+
+    for (int bucket = 0; bucket < SIZE_BUCKETS; ++bucket) {
+        if (sizeCounts[bucket] > 0) {
+            facets.sizes.append({sizeLabels[bucket], sizeCounts[bucket]});
+        }
+    }
+
+    for (auto it = monthCounts.constBegin(); it != monthCounts.constEnd(); ++it) {
+        facets.dates.append({it.key().toString(), it.value()});
+    }
+    std::sort(facets.dates.begin(), facets.dates.end(), [](const FacetValue& a, const FacetValue& b) {
+        return a.value > b.value;
+    });
+
+    for (QList<FacetValue>* values : {&facets.tags, &facets.fileTypes, &facets.sizes, &facets.dates}) {
+        if (values->size() > maxFacetValues) {
+            values->erase(values->begin() + maxFacetValues, values->end());
+        }
+    }
+}
+
 QStringList SearchService::extractSearchTerms(const QString& query)
 {
     // Split query into terms and clean them
@@ -429,10 +1558,21 @@ qreal SearchService::fuzzyMatch(const QString& pattern, const QString& text)
 QStringList SearchService::getFuzzyMatches(const QString& pattern, const QStringList& candidates, qreal threshold)
 {
     QStringList matches;
+    QString word = pattern.toLower();
+    if (word.isEmpty()) {
+        return matches;
+    }
+
+    // threshold is the share of the pattern that must survive unedited
+    int maxDistance = static_cast<int>((1.0 - threshold) * word.size());
 
     for (const QString& candidate : candidates) {
-        qreal score = fuzzyMatch(pattern, candidate);
-        if (score >= threshold) {
+        QString text = candidate.toLower();
+
+        // boundedDistance rejects on length difference before filling its table
+        if (text.contains(word)
+            || TrigramIndex::boundedDistance(word, text, maxDistance) <= maxDistance
+            || TrigramIndex::isAbbreviation(word, text)) {
             matches.append(candidate);
         }
     }
@@ -442,9 +1582,29 @@ QStringList SearchService::getFuzzyMatches(const QString& pattern, const QString
 
 void SearchService::performAsyncSearch()
 {
-    QList<SearchResult> results = search(m_pendingQuery, m_pendingTypes, m_pendingFilters);
+    // searchAsync() moved the generation on; later calls move it again
+    quint64 token = m_searchGeneration.load();
+    QString query = m_pendingQuery;
+    QStringList types = m_pendingTypes;
+    QVariantMap filters = m_pendingFilters;
+
+    QtConcurrent::run(&m_searchPool, [this, token, query, types, filters]() {
+        InvertedIndex::Cancelled superseded = [this, token]() {
+            return m_searchGeneration.load() != token;
+        };
+
+        QList<SearchResult> results = runSearch(query, types, filters, superseded);
+        if (superseded()) {
+            return;
+        }
 
-    emit searchCompleted(m_pendingQuery, results);
+        // Checked again on the owning thread, where the next request would be made
+        QMetaObject::invokeMethod(this, [this, token, query, results]() {
+            if (m_searchGeneration.load() == token) {
+                emit searchCompleted(query, results);
+            }
+        }, Qt::QueuedConnection);
+    });
 }
 
 QString SearchService::buildSearchableText(const ModelMetadata& model)
@@ -475,58 +1635,104 @@ QString SearchService::buildSearchableText(const ProjectData& project)
 QString SearchService::determineContentType(const QString& id)
 {
     // Check if it's a model or project ID
-    // For now, assume UUID format indicates model
-    return QUuid(id).isNull() ? "unknown" : "model";
+    if (QUuid(id).isNull()) {
+        return "unknown";
+    }
+    return m_projectIds.contains(id) ? "project" : "model";
 }
 
 QStringList SearchService::getItemTags(const QString& id)
 {
-    return m_tagIndex.keys(); // Simplified - would need proper lookup
+    QStringList tags;
+    auto it = m_filterIds.constFind(id);
+    if (it != m_filterIds.constEnd()) {
+        for (quint32 tagId : m_display.tags[it.value()]) {
+            tags.append(m_display.tagNames[tagId]);
+        }
+    }
+    return tags;
 }
 
-SearchResult SearchService::createSearchResult(const QString& id, const QString& query)
+SearchResult SearchService::createSearchResult(const QString& id) const
 {
     SearchResult result;
 
-    // Determine if it's a model or project
-    QString contentType = determineContentType(id);
-
-    if (contentType == "model") {
-        // Fetch model data from database
-        DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
-        if (dbManager) {
-            ModelMetadata model = dbManager->getModel(QUuid(id));
-            if (!model.id.isNull()) {
-                result.id = model.id;
-                result.name = model.filename;
-                result.type = "model";
-                result.tags = model.tags;
-
-                // Generate snippet
-                QString searchableText = m_searchIndex[id];
-                result.snippet = generateSnippet(searchableText, query);
-            }
+    // Indexed items are hydrated from the display columns alone
+    auto it = m_filterIds.constFind(id);
+    if (it != m_filterIds.constEnd()) {
+        quint32 filterId = it.value();
+        if (m_modelBitmap.contains(filterId)) {
+            result.type = "model";
+        } else if (m_projectBitmap.contains(filterId)) {
+            result.type = "project";
+        } else {
+            return result;  // removed from the index
         }
-    } else if (contentType == "project") {
-        // Fetch project data from database
-        DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
-        if (dbManager) {
-            ProjectData project = dbManager->getProject(QUuid(id));
-            if (!project.id.isNull()) {
-                result.id = project.id;
-                result.name = project.name;
-                result.type = "project";
 
-                // Generate snippet
-                QString searchableText = m_searchIndex[id];
-                result.snippet = generateSnippet(searchableText, query);
-            }
+        result.id = QUuid(id);
+        result.name = m_display.names[filterId];
+        for (quint32 tagId : m_display.tags[filterId]) {
+            result.tags.append(m_display.tagNames[tagId]);
+        }
+        result.fileSize = m_display.fileSizes[filterId];
+        result.date = m_display.dates[filterId];
+        result.thumbnailPath = m_display.thumbnails[filterId];
+        return result;
+    }
+
+    // Database-only hits (full-text or range matches before the index is
+    // built) are the one case that still reads the model
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (dbManager) {
+        ModelMetadata model = dbManager->getModel(QUuid(id));
+        if (!model.id.isNull()) {
+            result.id = model.id;
+            result.name = model.filename;
+            result.type = "model";
+            result.tags = model.tags;
+            result.fileSize = model.fileSize;
+            result.date = model.importDate;
+            result.thumbnailPath = model.thumbnailPath;
         }
     }
 
     return result;
 }
 
+QString SearchService::getSnippet(const QUuid& id, const QString& query)
+{
+    QReadLocker locker(&m_indexLock);
+    auto it = m_searchIndex.constFind(id.toString());
+    return it != m_searchIndex.constEnd() ? generateSnippet(it.value(), query) : QString();
+}
+
+QList<SearchResult> SearchService::findSimilar(const QUuid& modelId, int k)
+{
+    QReadLocker locker(&m_indexLock);
+    QList<SearchResult> results;
+
+    QString key = modelId.toString();
+    QVector<float> descriptor = m_shapeIndex.vector(key);
+    if (descriptor.isEmpty() || k <= 0) {
+        return results;
+    }
+
+    // One extra neighbour, as the model finds itself
+    for (const HnswIndex::Neighbour& neighbour : m_shapeIndex.search(descriptor, k + 1, qMax(64, 2 * k))) {
+        if (neighbour.key == key || results.size() >= k) {
+            continue;
+        }
+
+        SearchResult result = createSearchResult(neighbour.key);
+        if (!result.id.isNull()) {
+            result.relevance = 1.0 / (1.0 + neighbour.distance);
+            results.append(result);
+        }
+    }
+
+    return results;
+}
+
 QString SearchService::generateSnippet(const QString& text, const QString& query)
 {
     // Find query terms in text and extract surrounding context
@@ -552,6 +1758,7 @@ QString SearchService::generateSnippet(const QString& text, const QString& query
 
 QStringList SearchService::getRecentSearches(int maxSearches)
 {
+    QMutexLocker locker(&m_stateMutex);
     QStringList recent;
     for (int i = 0; i < qMin(maxSearches, m_recentQueries.count()); ++i) {
         recent.append(m_recentQueries[i]);
@@ -569,10 +1776,31 @@ qint64 SearchService::calculateMemoryUsage() const
         usage += it.value().size() * 2;
     }
 
-    // Estimate memory usage of tag index
-    for (auto it = m_tagIndex.begin(); it != m_tagIndex.end(); ++it) {
-        usage += it.key().size() * 2;
-        usage += it.value().join("").size() * 2;
+    usage += m_invertedIndex.memoryUsage();
+    usage += m_lastSearch.matches.docs.capacity() * static_cast<qint64>(sizeof(quint32));
+    usage += m_trigramIndex.memoryUsage();
+    usage += m_shapeIndex.memoryUsage();
+    usage += m_tagCompletions.memoryUsage() + m_filenameCompletions.memoryUsage() + m_queryCompletions.memoryUsage();
+
+    // Estimate memory usage of filter bitmaps
+    for (const QString& key : m_filterKeys) {
+        usage += key.size() * 2 * 2;  // key list and id map
+    }
+
+    // Display columns
+    for (int id = 0; id < m_filterKeys.size(); ++id) {
+        usage += (m_display.names[id].size() + m_display.dates[id].size() + m_display.thumbnails[id].size()) * 2;
+        usage += m_display.tags[id].capacity() * static_cast<qint64>(sizeof(quint32));
+    }
+    usage += m_display.fileSizes.capacity() * static_cast<qint64>(sizeof(qint64));
+    for (const QString& tag : m_display.tagNames) {
+        usage += tag.size() * 2 * 2;  // name list and id map
+    }
+    for (const QHash<QString, RoaringBitmap>* bitmaps : {&m_tagBitmaps, &m_fileTypeBitmaps, &m_projectMembers}) {
+        for (auto it = bitmaps->begin(); it != bitmaps->end(); ++it) {
+            usage += it.key().size() * 2;
+            usage += it.value().memoryUsage();
+        }
     }
 
     return usage;
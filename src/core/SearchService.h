@@ -1,18 +1,33 @@
 #pragma once
 
 #include "BaseTypes.h"
+#include "InvertedIndex.h"
+#include "TrigramIndex.h"
+#include "RoaringBitmap.h"
+#include "CompletionTrie.h"
+#include "HnswIndex.h"
 #include <QObject>
 #include <QString>
 #include <QList>
 #include <QStringList>
+#include <QSet>
 #include <QFuture>
 #include <QTimer>
+#include <QCache>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QThreadPool>
+#include <atomic>
 
 /**
  * @brief High-performance search service for model and project discovery
  *
  * Provides real-time search capabilities with fuzzy matching, faceted search,
  * and intelligent ranking. Performance target: ≤100ms for most queries.
+ *
+ * searchAsync() runs on a worker pool. Index updates happen on the owning
+ * thread under a write lock; searches read under the shared lock, and a newer
+ * searchAsync() request cancels any search still running.
  */
 class SearchService : public QObject
 {
@@ -20,7 +35,7 @@ class SearchService : public QObject
 
 public:
     explicit SearchService(QObject* parent = nullptr);
-    virtual ~SearchService() = default;
+    virtual ~SearchService();
 
     // Search operations
     virtual QList<SearchResult> search(const QString& query,
@@ -40,12 +55,34 @@ public:
 
     virtual QStringList getRecentSearches(int maxSearches = 10) = 0;
 
+    // Results come without snippets; ask for one only for rows being shown
+    virtual QString getSnippet(const QUuid& id, const QString& query);
+
+    // Up to k models shaped most like modelId, closest first, with relevance
+    // 1 / (1 + descriptor distance); empty when the model has no descriptor
+    virtual QList<SearchResult> findSimilar(const QUuid& modelId, int k = 20);
+
     // Index management
     virtual void indexModel(const ModelMetadata& model) = 0;
     virtual void indexProject(const ProjectData& project) = 0;
     virtual void removeFromIndex(const QUuid& id) = 0;
     virtual void rebuildIndex() = 0;
 
+    // Apply database changes logged since the index was last built or synced
+    virtual void syncIndex();
+
+    // Persist the index with the change version it reflects. Loading maps the
+    // file, verifies it and replays only later changes; it returns false when
+    // the file is missing, damaged or too old to catch up, and rebuildIndex()
+    // is needed instead
+    virtual bool saveIndex(const QString& path);
+    virtual bool loadIndex(const QString& path);
+
+    // Keep tag completions and filters in step with TagManager edits
+    virtual void handleTagCreated(const QString& tag);
+    virtual void handleTagRenamed(const QString& oldTag, const QString& newTag);
+    virtual void handleTagDeleted(const QString& tag);
+
     // Search configuration
     virtual void setSearchOptions(const QVariantMap& options) = 0;
     virtual QVariantMap getSearchOptions() const = 0;
@@ -59,10 +96,12 @@ public:
         QStringList contentTypes;    // "model", "project"
         QStringList tags;           // Required tags (AND operation)
         QStringList excludeTags;    // Excluded tags (NOT operation)
-        QStringList fileTypes;      // File extensions
-        QVariantMap dateRange;      // Date filters
-        QVariantMap sizeRange;      // File size filters
-        QVariantMap customFilters;  // Custom field filters
+        QStringList fileTypes;      // File extensions (any of)
+        QList<QUuid> projects;      // Only models in any of these projects
+        QVariantMap dateRange;      // Import date filters: "min"/"max" ISO text
+        QVariantMap sizeRange;      // File size filters: "min"/"max" bytes
+        QVariantMap boundsRange;    // Extent filters: "min"/"max" maps of x, y, z
+        QVariantMap customFilters;  // Custom field filters; mesh stats take "min"/"max" maps
         QString sortBy;             // "relevance", "name", "date", "size"
         bool sortDescending = true;
         int maxResults = 100;
@@ -71,6 +110,27 @@ public:
     virtual QList<SearchResult> searchWithFilters(const QString& query,
                                                  const SearchFilters& filters) = 0;
 
+    // How many matching items carry each facet value, over every match
+    // rather than only the returned page
+    struct FacetValue {
+        QString value;
+        int count = 0;
+    };
+
+    struct FacetCounts {
+        int total = 0;               // matching indexed items
+        bool exact = true;           // false when only the leading candidates were counted
+        QList<FacetValue> tags;      // most common first
+        QList<FacetValue> fileTypes; // most common first
+        QList<FacetValue> sizes;     // size buckets, smallest first
+        QList<FacetValue> dates;     // "yyyy-MM", newest first
+    };
+
+    // Top results plus facet counts from the same search; each facet lists
+    // at most maxFacetValues values
+    virtual QList<SearchResult> searchWithFacets(const QString& query, const SearchFilters& filters,
+                                                 FacetCounts& facets, int maxFacetValues = 20);
+
 signals:
     // Search events
     void searchCompleted(const QString& query, const QList<SearchResult>& results);
@@ -85,15 +145,58 @@ signals:
 protected:
     // Search implementation helpers
     virtual QList<SearchResult> performSearch(const QString& query,
-                                             const SearchFilters& filters) = 0;
+                                             const SearchFilters& filters,
+                                             const InvertedIndex::Cancelled& cancelled = InvertedIndex::Cancelled(),
+                                             FacetCounts* facets = nullptr, int maxFacetValues = 0) = 0;
     virtual qreal calculateRelevance(const QString& query, const SearchResult& result) = 0;
     virtual qreal calculateRelevance(const QString& query, const QString& searchableText, const QStringList& searchTerms) = 0;
     virtual QStringList extractSearchTerms(const QString& query) = 0;
 
+    // Shared by search() and the async workers; returns nothing once cancelled
+    QList<SearchResult> runSearch(const QString& query, const QStringList& types, const QVariantMap& filters,
+                                  const InvertedIndex::Cancelled& cancelled);
+
+    // Serves repeated queries from m_searchCache while the index is unchanged
+    QList<SearchResult> cachedSearch(const QString& query, const SearchFilters& filters,
+                                     const InvertedIndex::Cancelled& cancelled = InvertedIndex::Cancelled(),
+                                     FacetCounts* facets = nullptr, int maxFacetValues = 0);
+    QString cacheKey(const QString& query, const SearchFilters& filters) const;
+
+    // Index hits for a query; when it can only narrow the previous index
+    // search, just that search's matches are re-scored
+    QList<InvertedIndex::Hit> searchIndex(const QStringList& terms, bool typing, int maxResults,
+                                          bool restricted, const RoaringBitmap& allowed,
+                                          const InvertedIndex::Filter& accept,
+                                          const InvertedIndex::Cancelled& cancelled,
+                                          InvertedIndex::Matches* matched = nullptr);
+    bool narrowsLastSearch(const QStringList& terms, bool typing,
+                           bool restricted, const RoaringBitmap& allowed) const;
+
+    // Numeric filters that the database answers from its indexes
+    virtual QVariantMap buildRangeFilters(const SearchFilters& filters) const;
+
+    // Content type, tag, file type and project filters combined as bitmap
+    // operations; returns false when none of them narrows the results
+    virtual bool buildFilterBitmap(const SearchFilters& filters, RoaringBitmap& allowed) const;
+
+    // Facet counts over matched dense ids in one pass over the display columns
+    void countFacets(const RoaringBitmap& matched, bool complete, int maxFacetValues, FacetCounts& facets) const;
+
     // Additional helper methods
     virtual void performAsyncSearch() = 0;
     virtual QString buildSearchableText(const ModelMetadata& model) = 0;
     virtual QString buildSearchableText(const ProjectData& project) = 0;
+    SearchResult createSearchResult(const QString& id) const;
+    QString generateSnippet(const QString& text, const QString& query);
+    QString determineContentType(const QString& id);
+    QStringList getItemTags(const QString& id);
+    qint64 calculateMemoryUsage() const;
+    void indexSearchableText(const QString& id, const QString& searchableText);
+    void clearIndex();
+    quint32 filterId(const QString& id);
+    void clearFilterAttributes(const QString& id);
+    quint32 internTag(const QString& tag);
+    void recordQuery(const QString& query);
 
     // Fuzzy matching
     virtual qreal fuzzyMatch(const QString& pattern, const QString& text) = 0;
@@ -101,14 +204,85 @@ protected:
                                       const QStringList& candidates,
                                       qreal threshold = 0.6) = 0;
 
+    // Write-locked by index updates, read-locked by searches
+    QReadWriteLock m_indexLock{QReadWriteLock::Recursive};
+
+    // Guards the cache, last search, options, recent queries and counters,
+    // which searches on any thread update
+    mutable QMutex m_stateMutex;
+
+    // Completion lookups sort trie nodes lazily, so readers of the tag and
+    // filename tries take turns under the index read lock
+    QMutex m_completionMutex;
+
+    // Async searches; each request's token is superseded by the next request
+    QThreadPool m_searchPool;
+    std::atomic<quint64> m_searchGeneration;
+
     // Performance optimization
     QTimer* m_searchTimer;
     QStringList m_recentQueries;
-    QVariantMap m_searchCache;
+
+    // LRU of result lists keyed by normalised query and filters; an entry is
+    // only valid for the index generation it was computed against
+    struct CachedSearch {
+        quint64 generation;
+        QList<SearchResult> results;
+        FacetCounts facets;
+    };
+    QCache<QString, CachedSearch> m_searchCache;
+
+    // Every match of the last index search, kept while the user types so the
+    // next keystroke re-scores these instead of scanning the whole index
+    struct LastSearch {
+        bool valid = false;
+        quint64 generation = 0;
+        QStringList terms;
+        bool prefixLast = false;
+        bool restricted = false;
+        RoaringBitmap allowed;
+        InvertedIndex::Matches matches;
+    };
+    LastSearch m_lastSearch;
 
     // Search data
     QMap<QString, QString> m_searchIndex;  // id -> searchable text
-    QMap<QString, QStringList> m_tagIndex; // tag -> list of ids
+    InvertedIndex m_invertedIndex;         // term -> postings over the same text
+    TrigramIndex m_trigramIndex;           // vocabulary for typo-tolerant lookups
+    QSet<QString> m_projectIds;            // ids of indexed projects
+
+    // Filter bitmaps over dense ids that stay fixed per item until a rebuild
+    QHash<QString, quint32> m_filterIds;
+    QVector<QString> m_filterKeys;                   // dense id -> item id
+    RoaringBitmap m_modelBitmap;
+    RoaringBitmap m_projectBitmap;
+    QHash<QString, RoaringBitmap> m_tagBitmaps;      // lowercased tag -> items
+    QHash<QString, RoaringBitmap> m_fileTypeBitmaps; // lowercased extension -> models
+    QHash<QString, RoaringBitmap> m_projectMembers;  // project id -> its models
+
+    // Display fields by the same dense ids, so a page of results is built
+    // without reading the database. Tag spellings are interned; the type
+    // comes from the model and project bitmaps
+    struct DisplayColumns {
+        QVector<QString> names;          // filename or project name
+        QVector<QVector<quint32>> tags;  // indexes into tagNames
+        QVector<qint64> fileSizes;
+        QVector<QString> dates;
+        QVector<QString> thumbnails;
+        QVector<QString> tagNames;
+        QHash<QString, quint32> tagIds;  // spelling -> index in tagNames
+    };
+    DisplayColumns m_display;
+
+    // Model shape descriptors for similarity queries
+    HnswIndex m_shapeIndex;
+
+    // Top-k prefix completions
+    CompletionTrie m_tagCompletions;       // lowercased tag, weighted by items using it
+    CompletionTrie m_filenameCompletions;  // filename, weighted by models sharing it
+    CompletionTrie m_queryCompletions;     // past queries, weighted by repeats
+    qint64 m_indexedChangeVersion;         // change log version the index reflects
+    quint64 m_indexGeneration;             // bumped by every index change
 
     // Search parameters for async operations
     QString m_pendingQuery;
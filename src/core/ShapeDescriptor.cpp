@@ -0,0 +1,233 @@
+#include "ShapeDescriptor.h"
+#include <QRandomGenerator>
+#include <QDataStream>
+#include <QIODevice>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+ShapeDescriptor::ShapeDescriptor()
+{
+}
+
+ShapeDescriptor ShapeDescriptor::fromMesh(const QVector<QVector3D>& positions, const QVector<unsigned int>& indices,
+                                          int samplePairs)
+{
+    ShapeDescriptor descriptor;
+    if (samplePairs <= 0) {
+        return descriptor;
+    }
+
+    // Running surface area, so a uniform draw picks triangles in proportion to area
+    QVector<int> triangles;
+    QVector<double> cumulativeArea;
+    double totalArea = 0.0;
+    for (int i = 0; i + 2 < indices.size(); i += 3) {
+        if (indices[i] >= static_cast<unsigned int>(positions.size())
+            || indices[i + 1] >= static_cast<unsigned int>(positions.size())
+            || indices[i + 2] >= static_cast<unsigned int>(positions.size())) {
+            continue;
+        }
+
+        const QVector3D& a = positions[indices[i]];
+        double area = 0.5 * QVector3D::crossProduct(positions[indices[i + 1]] - a, positions[indices[i + 2]] - a).length();
+        if (area > 0.0) {
+            totalArea += area;
+            triangles.append(i);
+            cumulativeArea.append(totalArea);
+        }
+    }
+
+    if (triangles.isEmpty()) {
+        return descriptor;
+    }
+
+    QRandomGenerator random(0x5eed);
+    QVector<QVector3D> points;
+    points.reserve(samplePairs * 2);
+    for (int i = 0; i < samplePairs * 2; ++i) {
+        double target = random.generateDouble() * totalArea;
+        int triangle = static_cast<int>(std::upper_bound(cumulativeArea.constBegin(), cumulativeArea.constEnd(), target)
+                                        - cumulativeArea.constBegin());
+        int first = triangles[qMin(triangle, triangles.size() - 1)];
+
+        // Folding the unit square onto the triangle keeps the density uniform
+        float u = static_cast<float>(random.generateDouble());
+        float v = static_cast<float>(random.generateDouble());
+        if (u + v > 1.0f) {
+            u = 1.0f - u;
+            v = 1.0f - v;
+        }
+
+        const QVector3D& a = positions[indices[first]];
+        points.append(a + u * (positions[indices[first + 1]] - a) + v * (positions[indices[first + 2]] - a));
+    }
+
+    QVector<float> distances(samplePairs);
+    float maxDistance = 0.0f;
+    for (int i = 0; i < samplePairs; ++i) {
+        distances[i] = (points[2 * i] - points[2 * i + 1]).length();
+        maxDistance = qMax(maxDistance, distances[i]);
+    }
+
+    if (maxDistance <= 0.0f) {
+        return descriptor;
+    }
+
+    descriptor.m_values = QVector<float>(DIMENSIONS, 0.0f);
+    for (float distance : distances) {
+        int bin = qMin(HISTOGRAM_BINS - 1, static_cast<int>(distance / maxDistance * HISTOGRAM_BINS));
+        descriptor.m_values[bin] += 1.0f / samplePairs;
+    }
+
+    // Extents along the principal axes, largest first
+    QVector3D axes[3];
+    principalAxes(points, axes);
+
+    float extents[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        float low = std::numeric_limits<float>::max();
+        float high = std::numeric_limits<float>::lowest();
+        for (const QVector3D& point : points) {
+            float projection = QVector3D::dotProduct(point, axes[axis]);
+            low = qMin(low, projection);
+            high = qMax(high, projection);
+        }
+        extents[axis] = high - low;
+    }
+    std::sort(extents, extents + 3, [](float a, float b) { return a > b; });
+
+    if (extents[0] > 0.0f) {
+        descriptor.m_values[HISTOGRAM_BINS] = EXTENT_WEIGHT * extents[1] / extents[0];
+        descriptor.m_values[HISTOGRAM_BINS + 1] = EXTENT_WEIGHT * extents[2] / extents[0];
+    }
+
+    return descriptor;
+}
+
+bool ShapeDescriptor::isValid() const
+{
+    return m_values.size() == DIMENSIONS;
+}
+
+const QVector<float>& ShapeDescriptor::values() const
+{
+    return m_values;
+}
+
+float ShapeDescriptor::distance(const ShapeDescriptor& other) const
+{
+    if (!isValid() || !other.isValid()) {
+        return std::numeric_limits<float>::max();
+    }
+    return distance(m_values.constData(), other.m_values.constData());
+}
+
+float ShapeDescriptor::distance(const float* a, const float* b)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < DIMENSIONS; ++i) {
+        float difference = a[i] - b[i];
+        sum += difference * difference;
+    }
+    return std::sqrt(sum);
+}
+
+QByteArray ShapeDescriptor::toByteArray() const
+{
+    QByteArray data;
+    if (!isValid()) {
+        return data;
+    }
+
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    for (float value : m_values) {
+        out << value;
+    }
+    return data;
+}
+
+ShapeDescriptor ShapeDescriptor::fromByteArray(const QByteArray& data)
+{
+    ShapeDescriptor descriptor;
+    if (data.size() != DIMENSIONS * static_cast<int>(sizeof(float))) {
+        return descriptor;
+    }
+
+    QDataStream in(data);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    descriptor.m_values.resize(DIMENSIONS);
+    for (float& value : descriptor.m_values) {
+        in >> value;
+    }
+    return descriptor;
+}
+
+void ShapeDescriptor::principalAxes(const QVector<QVector3D>& points, QVector3D axes[3])
+{
+    QVector3D centroid;
+    for (const QVector3D& point : points) {
+        centroid += point;
+    }
+    centroid /= static_cast<float>(points.size());
+
+    double covariance[3][3] = {};
+    for (const QVector3D& point : points) {
+        QVector3D offset = point - centroid;
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 3; ++column) {
+                covariance[row][column] += offset[row] * offset[column];
+            }
+        }
+    }
+
+    // Cyclic Jacobi rotations diagonalise the covariance; the accumulated
+    // rotation's columns are its eigenvectors
+    double vectors[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        double offDiagonal = std::fabs(covariance[0][1]) + std::fabs(covariance[0][2]) + std::fabs(covariance[1][2]);
+        if (offDiagonal < 1e-12) {
+            break;
+        }
+
+        for (int p = 0; p < 2; ++p) {
+            for (int q = p + 1; q < 3; ++q) {
+                if (std::fabs(covariance[p][q]) < 1e-15) {
+                    continue;
+                }
+
+                double theta = (covariance[q][q] - covariance[p][p]) / (2.0 * covariance[p][q]);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0);
+                double s = t * c;
+
+                for (int k = 0; k < 3; ++k) {
+                    double kp = covariance[k][p];
+                    double kq = covariance[k][q];
+                    covariance[k][p] = c * kp - s * kq;
+                    covariance[k][q] = s * kp + c * kq;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    double pk = covariance[p][k];
+                    double qk = covariance[q][k];
+                    covariance[p][k] = c * pk - s * qk;
+                    covariance[q][k] = s * pk + c * qk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    double kp = vectors[k][p];
+                    double kq = vectors[k][q];
+                    vectors[k][p] = c * kp - s * kq;
+                    vectors[k][q] = s * kp + c * kq;
+                }
+            }
+        }
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        axes[axis] = QVector3D(static_cast<float>(vectors[0][axis]), static_cast<float>(vectors[1][axis]),
+                               static_cast<float>(vectors[2][axis])).normalized();
+    }
+}
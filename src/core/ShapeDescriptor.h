@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QVector>
+#include <QVector3D>
+#include <QByteArray>
+
+/**
+ * @brief Compact rotation- and scale-invariant signature of a mesh surface
+ *
+ * Points are sampled uniformly over the surface (triangles weighted by area)
+ * from a fixed seed, so the same mesh always gives the same descriptor. The
+ * first HISTOGRAM_BINS values are the D2 shape distribution: a histogram of
+ * distances between random point pairs, relative to the largest distance
+ * seen. The last two are the extents along the second and third principal
+ * axes relative to the first, which separate plates from bars from blocks
+ * that D2 alone confuses. Similar shapes are close in Euclidean distance.
+ */
+class ShapeDescriptor
+{
+public:
+    static const int HISTOGRAM_BINS = 32;
+    static const int DIMENSIONS = HISTOGRAM_BINS + 2;
+    static const int DEFAULT_SAMPLE_PAIRS = 8192;
+
+    ShapeDescriptor();
+
+    // positions indexed by triangle corners; an empty descriptor when the
+    // mesh has no area
+    static ShapeDescriptor fromMesh(const QVector<QVector3D>& positions, const QVector<unsigned int>& indices,
+                                    int samplePairs = DEFAULT_SAMPLE_PAIRS);
+
+    bool isValid() const;
+    const QVector<float>& values() const;
+
+    float distance(const ShapeDescriptor& other) const;
+    static float distance(const float* a, const float* b);
+
+    // DIMENSIONS little-endian floats; anything else reads back as invalid
+    QByteArray toByteArray() const;
+    static ShapeDescriptor fromByteArray(const QByteArray& data);
+
+    // Unit eigenvectors of the points' covariance, in no particular order
+    static void principalAxes(const QVector<QVector3D>& points, QVector3D axes[3]);
+
+private:
+    // Extent ratios weigh as much as a large shift in the histogram
+    static constexpr float EXTENT_WEIGHT = 0.25f;
+
+    QVector<float> m_values;
+};
@@ -8,6 +8,7 @@
 
 TagManager::TagManager(QObject* parent)
     : QObject(parent)
+    , m_tagCompletionsLoaded(false)
 {
     // Initialize system tags
     m_systemTags.insert("cnc");
@@ -24,6 +25,15 @@ TagManager::TagManager(QObject* parent)
     // Load tag hierarchy
     loadTagHierarchy();
 
+    // Tag edits made elsewhere change the usage counters too; completions are
+    // reloaded from them on next use
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent);
+    if (dbManager) {
+        connect(dbManager, &DatabaseManager::changesAvailable, this, [this]() {
+            m_tagCompletionsLoaded = false;
+        });
+    }
+
     qRegisterMetaType<QStringList>("QStringList");
 }
 
@@ -63,13 +73,33 @@ QStringList TagManager::suggestTags(const QString& context,
     // Extract keywords from context
     QStringList keywords = extractKeywords(context);
 
-    // Get all available tags
-    QStringList allTags = getAllTags();
+    // Candidates are the tags a context word completes plus the most used
+    // tags overall, instead of scoring every tag against every word
+    static const int CANDIDATES_PER_KEYWORD = 20;
+
+    ensureTagCompletions();
+
+    QSet<QString> candidates;
+    for (const QString& keyword : keywords) {
+        // Filenames join words with underscores, so each part is looked up too
+        QStringList prefixes = keyword.split('_', Qt::SkipEmptyParts);
+        prefixes.prepend(keyword);
+        prefixes.removeDuplicates();
+
+        for (const QString& prefix : prefixes) {
+            for (const QString& tag : m_tagCompletions.complete(prefix, CANDIDATES_PER_KEYWORD)) {
+                candidates.insert(tag);
+            }
+        }
+    }
+    for (const QString& tag : m_tagCompletions.complete(QString(), maxSuggestions)) {
+        candidates.insert(tag);
+    }
 
     // Score tags based on relevance
     QMap<QString, qreal> scoredTags;
 
-    for (const QString& tag : allTags) {
+    for (const QString& tag : candidates) {
         if (existingTags.contains(tag, Qt::CaseInsensitive)) {
             continue; // Skip already assigned tags
         }
@@ -84,7 +114,7 @@ QStringList TagManager::suggestTags(const QString& context,
         }
 
         // Boost score for popular tags
-        int usageCount = getTagUsageCounts()[tag];
+        int usageCount = m_tagCompletions.weight(tag);
         score += qMin(usageCount / 10.0, 2.0); // Cap the boost
 
         if (score > 0.1) {
@@ -180,6 +210,10 @@ bool TagManager::createTag(const QString& tag, const QString& parentTag)
         m_childToParent[sanitizedTag] = sanitizedParent;
     }
 
+    if (m_tagCompletionsLoaded && !m_tagCompletions.contains(sanitizedTag)) {
+        m_tagCompletions.insert(sanitizedTag, 0);
+    }
+
     saveTagHierarchy();
     emit tagCreated(sanitizedTag);
 
@@ -224,6 +258,13 @@ bool TagManager::renameTag(const QString& oldTag, const QString& newTag)
         m_tagHierarchy[parent] = children;
     }
 
+    // A rename onto an existing tag merges their usage
+    if (m_tagCompletionsLoaded) {
+        int usage = m_tagCompletions.weight(sanitizedOld) + m_tagCompletions.weight(sanitizedNew);
+        m_tagCompletions.remove(sanitizedOld);
+        m_tagCompletions.insert(sanitizedNew, usage);
+    }
+
     saveTagHierarchy();
     emit tagRenamed(sanitizedOld, sanitizedNew);
 
@@ -257,6 +298,7 @@ bool TagManager::deleteTag(const QString& tag)
 
     // Remove from child-to-parent mapping
     m_childToParent.remove(sanitizedTag);
+    m_tagCompletions.remove(sanitizedTag);
 
     saveTagHierarchy();
     emit tagDeleted(sanitizedTag);
@@ -376,28 +418,12 @@ QMap<QString, int> TagManager::getTagUsageCounts() const
 
 QStringList TagManager::getPopularTags(int maxTags) const
 {
-    QMap<QString, int> usageCounts = getTagUsageCounts();
-
-    // Sort by usage count
-    QList<QPair<QString, int>> sortedTags;
-    for (auto it = usageCounts.begin(); it != usageCounts.end(); ++it) {
-        sortedTags.append(QPair<QString, int>(it.key(), it.value()));
-    }
-
-    std::sort(sortedTags.begin(), sortedTags.end(),
-              [](const QPair<QString, int>& a, const QPair<QString, int>& b) {
-                  return a.second > b.second;
-              });
-
-    QStringList popular;
-    for (const QPair<QString, int>& pair : sortedTags) {
-        if (popular.count() >= maxTags) {
-            break;
-        }
-        popular.append(pair.first);
+    // Ranked straight off the usage counter index
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (dbManager) {
+        return dbManager->getPopularTags(maxTags);
     }
-
-    return popular;
+    return QStringList();
 }
 
 QStringList TagManager::getRecentTags(int maxTags) const
@@ -416,14 +442,13 @@ bool TagManager::addTagsToModels(const QStringList& tags, const QList<QUuid>& mo
 
     QStringList sanitizedTags = validateTags(tags);
 
-    for (const QUuid& modelId : modelIds) {
-        QStringList currentTags = dbManager->getModelTags(modelId);
-        QStringList newTags = currentTags + sanitizedTags;
-        newTags.removeDuplicates();
-
-        dbManager->insertModelTags(modelId, newTags);
+    // The writer applies the edit against the committed tag sets, so edits
+    // queued close together cannot overwrite one another
+    if (!dbManager->waitForCommit(dbManager->addModelTagsAsync(modelIds, sanitizedTags))) {
+        return false;
     }
 
+    refreshTagWeights(sanitizedTags);
     emit tagsChanged(QUuid(), "models"); // Broadcast signal
     return true;
 }
@@ -437,16 +462,11 @@ bool TagManager::removeTagsFromModels(const QStringList& tags, const QList<QUuid
 
     QStringList tagsToRemove = validateTags(tags);
 
-    for (const QUuid& modelId : modelIds) {
-        QStringList currentTags = dbManager->getModelTags(modelId);
-
-        for (const QString& tag : tagsToRemove) {
-            currentTags.removeAll(tag);
-        }
-
-        dbManager->insertModelTags(modelId, currentTags);
+    if (!dbManager->waitForCommit(dbManager->removeModelTagsAsync(modelIds, tagsToRemove))) {
+        return false;
     }
 
+    refreshTagWeights(tagsToRemove);
     emit tagsChanged(QUuid(), "models"); // Broadcast signal
     return true;
 }
@@ -655,6 +675,45 @@ QStringList TagManager::analyzeProjectContent(const ProjectData& project) const
     return suggestedTags;
 }
 
+void TagManager::ensureTagCompletions()
+{
+    if (m_tagCompletionsLoaded) {
+        return;
+    }
+
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (!dbManager) {
+        return;
+    }
+
+    m_tagCompletions.clear();
+    for (const QString& tag : dbManager->getAllTags()) {
+        m_tagCompletions.insert(tag, 0);
+    }
+
+    QMap<QString, int> usageCounts = dbManager->getTagUsageCounts();
+    for (auto it = usageCounts.constBegin(); it != usageCounts.constEnd(); ++it) {
+        m_tagCompletions.insert(it.key(), it.value());
+    }
+
+    m_tagCompletionsLoaded = true;
+}
+
+void TagManager::refreshTagWeights(const QStringList& tags)
+{
+    DatabaseManager* dbManager = qobject_cast<DatabaseManager*>(parent());
+    if (!m_tagCompletionsLoaded || !dbManager) {
+        return;
+    }
+
+    // Weights come from the trigger-maintained counters, which already
+    // reflect the committed edit
+    QMap<QString, int> usageCounts = dbManager->getTagUsageCounts();
+    for (const QString& tag : tags) {
+        m_tagCompletions.insert(tag, usageCounts.value(tag));
+    }
+}
+
 void TagManager::loadTagHierarchy()
 {
     // Load tag hierarchy from database or file
@@ -682,6 +741,8 @@ qint64 TagManager::calculateMemoryUsage() const
         }
     }
 
+    usage += m_tagCompletions.memoryUsage();
+
     // Estimate memory usage of child-to-parent mapping
     for (auto it = m_childToParent.begin(); it != m_childToParent.end(); ++it) {
         usage += it.key().size() * 2;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BaseTypes.h"
+#include "CompletionTrie.h"
 #include <QObject>
 #include <QString>
 #include <QStringList>
@@ -109,8 +110,19 @@ protected:
     virtual void loadTagHierarchy() = 0;
     virtual void saveTagHierarchy() = 0;
 
+    // Loads tag completions from the usage counters on first use after a change
+    void ensureTagCompletions();
+
+    // Re-reads the weights of the given tags from the usage counters
+    void refreshTagWeights(const QStringList& tags);
+
     // Tag hierarchy data
     QMap<QString, QStringList> m_tagHierarchy;  // parent -> children
     QMap<QString, QString> m_childToParent;     // child -> parent
     QSet<QString> m_systemTags;
+
+    // Tags weighted by usage; edits through this manager update them in place,
+    // any other committed change marks them for reloading
+    CompletionTrie m_tagCompletions;
+    bool m_tagCompletionsLoaded;
 };
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "TrigramIndex.h"
+#include <algorithm>
+
+TrigramIndex::TrigramIndex()
+{
+}
+
+void TrigramIndex::addTerm(const QString& term)
+{
+    if (term.isEmpty() || m_termIds.contains(term)) {
+        return;
+    }
+
+    // Ids only grow, so every postings vector stays sorted
+    quint32 termId = static_cast<quint32>(m_terms.size());
+    m_terms.append(term);
+    m_termIds.insert(term, termId);
+
+    QStringList grams = trigrams(term);
+    grams.removeDuplicates();
+    for (const QString& gram : grams) {
+        m_grams[gram].append(termId);
+    }
+}
+
+void TrigramIndex::clear()
+{
+    m_terms.clear();
+    m_termIds.clear();
+    m_grams.clear();
+}
+
+bool TrigramIndex::contains(const QString& term) const
+{
+    return m_termIds.contains(term);
+}
+
+int TrigramIndex::termCount() const
+{
+    return m_terms.size();
+}
+
+qint64 TrigramIndex::memoryUsage() const
+{
+    qint64 usage = 0;
+
+    for (const QString& term : m_terms) {
+        usage += term.size() * static_cast<qint64>(sizeof(QChar)) * 2;  // term list and id map
+    }
+    for (auto it = m_grams.constBegin(); it != m_grams.constEnd(); ++it) {
+        usage += it.key().size() * static_cast<qint64>(sizeof(QChar))
+               + it.value().capacity() * static_cast<qint64>(sizeof(quint32));
+    }
+
+    return usage;
+}
+
+QList<TrigramIndex::Match> TrigramIndex::similarTerms(const QString& word, int maxDistance, int maxMatches) const
+{
+    QList<Match> matches;
+    if (word.isEmpty() || maxMatches <= 0) {
+        return matches;
+    }
+
+    QStringList grams = trigrams(word);
+    grams.removeDuplicates();
+
+    // Count shared trigrams per term straight from the postings
+    QHash<quint32, int> shared;
+    for (const QString& gram : grams) {
+        auto it = m_grams.constFind(gram);
+        if (it == m_grams.constEnd()) {
+            continue;
+        }
+        for (quint32 termId : it.value()) {
+            shared[termId]++;
+        }
+    }
+
+    // Each edit destroys at most three trigrams, so closer terms must share at least this many
+    int minShared = qMax(1, static_cast<int>(grams.size()) - 3 * maxDistance);
+
+    for (auto it = shared.constBegin(); it != shared.constEnd(); ++it) {
+        const QString& term = m_terms[it.key()];
+
+        int distance = maxDistance + 1;
+        if (it.value() >= minShared && qAbs(term.size() - word.size()) <= maxDistance) {
+            distance = boundedDistance(word, term, maxDistance);
+        }
+
+        // Abbreviations rank behind every typo, closer ones first
+        if (distance > maxDistance && word.size() >= 3 && term.size() <= word.size() * 3
+            && isAbbreviation(word, term)) {
+            distance = maxDistance + static_cast<int>(term.size() - word.size());
+        } else if (distance > maxDistance) {
+            continue;
+        }
+
+        matches.append({term, distance});
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.term < b.term;
+    });
+
+    if (matches.size() > maxMatches) {
+        matches.erase(matches.begin() + maxMatches, matches.end());
+    }
+
+    return matches;
+}
+
+int TrigramIndex::defaultMaxDistance(const QString& word)
+{
+    if (word.size() <= 4) {
+        return 1;
+    }
+    return word.size() <= 8 ? 2 : 3;
+}
+
+int TrigramIndex::boundedDistance(const QString& a, const QString& b, int maxDistance)
+{
+    if (qAbs(a.size() - b.size()) > maxDistance) {
+        return maxDistance + 1;
+    }
+
+    QVector<int> previous(b.size() + 1);
+    QVector<int> current(b.size() + 1);
+    for (int j = 0; j <= b.size(); ++j) {
+        previous[j] = j;
+    }
+
+    for (int i = 1; i <= a.size(); ++i) {
+        current[0] = i;
+        int rowMinimum = i;
+
+        for (int j = 1; j <= b.size(); ++j) {
+            int substitution = previous[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+            current[j] = qMin(qMin(previous[j] + 1, current[j - 1] + 1), substitution);
+            rowMinimum = qMin(rowMinimum, current[j]);
+        }
+
+        // Distances never shrink further down the table
+        if (rowMinimum > maxDistance) {
+            return maxDistance + 1;
+        }
+
+        std::swap(previous, current);
+    }
+
+    return qMin(previous[b.size()], maxDistance + 1);
+}
+
+bool TrigramIndex::isAbbreviation(const QString& word, const QString& term)
+{
+    if (word.isEmpty() || word.size() >= term.size() || word[0] != term[0]) {
+        return false;
+    }
+
+    int position = 1;
+    for (int i = 1; i < term.size() && position < word.size(); ++i) {
+        if (term[i] == word[position]) {
+            position++;
+        }
+    }
+
+    return position == word.size();
+}
+
+QStringList TrigramIndex::trigrams(const QString& term)
+{
+    QString padded = "$$" + term + "$";
+
+    QStringList grams;
+    grams.reserve(padded.size() - 2);
+    for (int i = 0; i + 3 <= padded.size(); ++i) {
+        grams.append(padded.mid(i, 3));
+    }
+
+    return grams;
+}
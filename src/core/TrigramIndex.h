@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QList>
+
+/**
+ * @brief Trigram -> term postings for typo-tolerant term lookup
+ *
+ * Holds a vocabulary of words, each split into padded trigrams ("$$b",
+ * "$br", "bra", ... "et$"). A lookup counts shared trigrams through the
+ * postings and only candidates that share enough of them for the allowed
+ * edit distance are verified with a bounded Levenshtein distance. Words
+ * that read as an abbreviation of a term ("brkt" for "bracket") are also
+ * accepted, ranked behind genuine typos.
+ */
+class TrigramIndex
+{
+public:
+    struct Match {
+        QString term;
+        int distance;
+    };
+
+    TrigramIndex();
+
+    void addTerm(const QString& term);
+    void clear();
+
+    bool contains(const QString& term) const;
+    int termCount() const;
+    qint64 memoryUsage() const;
+
+    // Vocabulary terms within maxDistance edits of word, closest first; terms
+    // word abbreviates follow with maxDistance plus the letters it leaves out
+    QList<Match> similarTerms(const QString& word, int maxDistance, int maxMatches) const;
+
+    // Edit distance allowed for a word of this length: 1 up to 4 characters, 2 up to 8, then 3
+    static int defaultMaxDistance(const QString& word);
+
+    // Levenshtein distance, or maxDistance + 1 as soon as it must exceed maxDistance
+    static int boundedDistance(const QString& a, const QString& b, int maxDistance);
+
+    // True when word keeps the first letter of term and the rest in order
+    static bool isAbbreviation(const QString& word, const QString& term);
+
+    static QStringList trigrams(const QString& term);
+
+private:
+    QVector<QString> m_terms;                  // term id -> term
+    QHash<QString, quint32> m_termIds;         // term -> term id
+    QHash<QString, QVector<quint32>> m_grams;  // trigram -> ascending term ids
+};
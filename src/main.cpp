@@ -178,6 +178,11 @@ int main(int argc, char *argv[])
             logger->info(QString("Tag created: %1").arg(tag), "TagManager");
         });
 
+    // Keep search completions in step with tag edits
+    QObject::connect(tagManager, &TagManager::tagCreated, searchService, &SearchService::handleTagCreated);
+    QObject::connect(tagManager, &TagManager::tagRenamed, searchService, &SearchService::handleTagRenamed);
+    QObject::connect(tagManager, &TagManager::tagDeleted, searchService, &SearchService::handleTagDeleted);
+
     // Connect canvas error events (window not created yet, will be connected after creation)
 
     // Process command line arguments
@@ -1,6 +1,7 @@
 #include "ThumbnailGenerator.h"
 #include "../core/ModelService.h"
 #include "../core/CacheManager.h"
+#include "../core/DuplicateClusterer.h"
 #include <QPixmap>
 #include <QPainter>
 #include <QBrush>
@@ -99,6 +100,10 @@ QPixmap ThumbnailGenerator::generateThumbnail(const QString& modelId, const Thum
             emit thumbnailGenerated(modelId, cachePath);
         }
 
+        // Perceptual hash for near-duplicate detection; written behind, so a
+        // batch of thumbnails shares the writer's group commits
+        modelService->setThumbnailHashAsync(metadata.id, DuplicateClusterer::thumbnailHash(thumbnail.toImage()));
+
         // Update performance metrics
         qint64 elapsed = timer.elapsed();
         m_totalGenerationTime += elapsed;
@@ -149,14 +154,16 @@ void ThumbnailGenerator::regenerateAllThumbnails()
         return;
     }
 
-    QList<ModelMetadata> models = modelService->getAllModels();
-    QStringList modelIds;
+    // Stream ids a page at a time rather than loading every model's metadata
+    ModelCursor cursor = modelService->openModelCursor(ModelCursor::IdOnly);
+    for (QList<ModelMetadata> page = cursor.nextPage(); !page.isEmpty(); page = cursor.nextPage()) {
+        QStringList modelIds;
+        for (const ModelMetadata& model : page) {
+            modelIds.append(model.id.toString());
+        }
 
-    for (const ModelMetadata& model : models) {
-        modelIds.append(model.id.toString());
+        generateThumbnailsForModels(modelIds, m_defaultConfig);
     }
-
-    generateThumbnailsForModels(modelIds, m_defaultConfig);
 }
 
 void ThumbnailGenerator::regenerateThumbnailsForQuery(const QString& query)
@@ -1105,8 +1105,10 @@ void CutListCanvas::onAddPartClicked()
 
     ModelService* modelService = qobject_cast<ModelService*>(parent());
     if (modelService) {
-        QList<ModelMetadata> models = modelService->getAllModels();
-        for (const ModelMetadata& model : models) {
+        // Only the filename is needed for the picker
+        ModelCursor cursor = modelService->openModelCursor(ModelCursor::Filename);
+        while (cursor.next()) {
+            const ModelMetadata& model = cursor.current();
             availableModels.append(QString("%1 (%2)")
                                    .arg(QFileInfo(model.filename).baseName())
                                    .arg(model.id.toString()));
@@ -412,6 +412,11 @@ bool MainWindow::initialize()
     SearchService* searchService = new SearchService(this);
     TagManager* tagManager = new TagManager(this);
 
+    // Keep search completions in step with tag edits
+    connect(tagManager, &TagManager::tagCreated, searchService, &SearchService::handleTagCreated);
+    connect(tagManager, &TagManager::tagRenamed, searchService, &SearchService::handleTagRenamed);
+    connect(tagManager, &TagManager::tagDeleted, searchService, &SearchService::handleTagDeleted);
+
     // Initialize database
     QString databasePath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/models.db";
     if (!dbManager->initialize(databasePath)) {
@@ -420,8 +425,11 @@ bool MainWindow::initialize()
         return false;
     }
 
-    // Rebuild search index
-    searchService->rebuildIndex();
+    // Start from the saved search index when it can be caught up, otherwise rebuild
+    QString searchIndexPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/search.idx";
+    if (!searchService->loadIndex(searchIndexPath)) {
+        searchService->rebuildIndex();
+    }
 
     m_isInitialized = true;
     statusBar()->showMessage("Ready", 2000);
@@ -441,6 +449,12 @@ void MainWindow::shutdown()
     saveWindowState();
     saveApplicationSettings();
 
+    // Save the search index so the next launch only replays newer changes
+    SearchService* searchService = findChild<SearchService*>();
+    if (searchService) {
+        searchService->saveIndex(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/search.idx");
+    }
+
     // Close database connections
     // This is handled automatically by Qt's parent-child system
 }
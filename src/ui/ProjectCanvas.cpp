@@ -821,7 +821,7 @@ void ProjectCanvas::onSearchCompleted(const QString& query, const QList<SearchRe
     for (const SearchResult& result : results) {
         QListWidgetItem* item = new QListWidgetItem(m_modelGrid);
         item->setText(result.name);
-        item->setIcon(QIcon(":/icons/model_placeholder.png"));
+        item->setIcon(QIcon(result.thumbnailPath.isEmpty() ? ":/icons/model_placeholder.png" : result.thumbnailPath));
         item->setData(Qt::UserRole, result.id.toString());
     }
 
@@ -1,4 +1,6 @@
 #include "SettingsCanvas.h"
+#include "../core/DatabaseBackup.h"
+#include "../core/DatabaseManager.h"
 #include <QApplication>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -21,6 +23,8 @@
 #include <QJsonArray>
 #include <QStandardPaths>
 #include <QDir>
+#include <QDateTime>
+#include <QTimer>
 #include <QDebug>
 
 SettingsCanvas::SettingsCanvas(QWidget* parent)
@@ -32,6 +36,8 @@ SettingsCanvas::SettingsCanvas(QWidget* parent)
     , m_cncWidget(nullptr)
     , m_uiWidget(nullptr)
     , m_advancedWidget(nullptr)
+    , m_activeBackup(nullptr)
+    , m_backupTimer(new QTimer(this))
 {
     setCanvasName("SettingsCanvas");
     setupDefaultLayout();
@@ -39,6 +45,12 @@ SettingsCanvas::SettingsCanvas(QWidget* parent)
     // Load current settings
     loadSettingsFromStorage();
 
+    // A long-running session still gets its daily backup
+    m_backupTimer->setInterval(60 * 60 * 1000);
+    connect(m_backupTimer, &QTimer::timeout, this, &SettingsCanvas::checkAutomaticBackup);
+    m_backupTimer->start();
+    checkAutomaticBackup();
+
     // Load default layout
     restoreLayout("settings_default");
 }
@@ -153,6 +165,13 @@ void SettingsCanvas::createGeneralSettings()
     addSettingRow(backupLayout, "", m_backupCheck, "Create backup files");
     connect(m_backupCheck, &QCheckBox::toggled, this, &SettingsCanvas::onBackupSettingsChanged);
 
+    m_backupNowButton = new QPushButton("Back Up Now", backupGroup);
+    addSettingRow(backupLayout, "", m_backupNowButton, "Copy the model database while the application keeps running");
+    connect(m_backupNowButton, &QPushButton::clicked, this, &SettingsCanvas::onBackupNowClicked);
+
+    m_backupStatusLabel = new QLabel(backupGroup);
+    backupLayout->addRow("Status:", m_backupStatusLabel);
+
     layout->addWidget(backupGroup);
 
     layout->addStretch();
@@ -840,6 +859,74 @@ void SettingsCanvas::onAutoSaveChanged(bool enabled)
 void SettingsCanvas::onBackupSettingsChanged(bool enabled)
 {
     setSetting("general", "backup_enabled", enabled);
+    checkAutomaticBackup();
+}
+
+void SettingsCanvas::checkAutomaticBackup()
+{
+    // Automatic backups run at most once a day
+    if (!getSetting("general", "backup_enabled").toBool()) {
+        return;
+    }
+
+    QDateTime lastBackup = QDateTime::fromString(getSetting("general", "last_backup").toString(), Qt::ISODate);
+    if (!lastBackup.isValid() || lastBackup.secsTo(QDateTime::currentDateTimeUtc()) > 24 * 60 * 60) {
+        startDatabaseBackup();
+    }
+}
+
+void SettingsCanvas::onBackupNowClicked()
+{
+    startDatabaseBackup();
+}
+
+void SettingsCanvas::startDatabaseBackup()
+{
+    if (m_activeBackup) {
+        return;  // One backup at a time
+    }
+
+    DatabaseManager* dbManager = window()->findChild<DatabaseManager*>();
+    if (!dbManager) {
+        m_backupStatusLabel->setText("Backup failed: no database is open");
+        return;
+    }
+
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QString backupPath = QString("%1/backups/models_backup_%2.db")
+                         .arg(dataDir, QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss"));
+
+    // The database flushes queued writes and copies on a low-priority thread,
+    // which keeps the UI and the database writer responsive
+    m_activeBackup = dbManager->startBackup(backupPath);
+    if (!m_activeBackup) {
+        m_backupStatusLabel->setText("Backup failed: database not initialized");
+        return;
+    }
+    m_backupNowButton->setEnabled(false);
+
+    connect(m_activeBackup, &DatabaseBackup::progress, this, [this](int copied, int total) {
+        int percent = total > 0 ? copied * 100 / total : 100;
+        m_backupStatusLabel->setText(QString("Backing up... %1%").arg(percent));
+    });
+
+    // Completion is relayed by the manager, which connected before the copy
+    // started; the connection goes away with the job once its thread finishes
+    connect(dbManager, &DatabaseManager::backupCompleted, m_activeBackup,
+        [this, backupPath](const QString& path, bool success, const QString& error) {
+            if (path != backupPath) {
+                return;
+            }
+
+            if (success) {
+                setSetting("general", "last_backup", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+                m_backupStatusLabel->setText(QString("Last backup: %1").arg(backupPath));
+            } else {
+                m_backupStatusLabel->setText(QString("Backup failed: %1").arg(error));
+            }
+            m_activeBackup = nullptr;
+            m_backupNowButton->setEnabled(true);
+        });
 }
 
 void SettingsCanvas::onBackgroundColorChanged()
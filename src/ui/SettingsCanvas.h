@@ -20,6 +20,9 @@
 #include <QFileDialog>
 #include <QJsonObject>
 
+class DatabaseBackup;
+class QTimer;
+
 /**
  * @brief Settings Canvas - Comprehensive application configuration
  *
@@ -84,6 +87,10 @@ protected:
     void saveSettingsToStorage();
     void validateSettings();
 
+    // Online database backup into the application data directory
+    void startDatabaseBackup();
+    void checkAutomaticBackup();
+
     // UI helpers
     void addSettingRow(QFormLayout* layout, const QString& label, QWidget* widget, const QString& tooltip = QString());
     void addSectionHeader(QVBoxLayout* layout, const QString& title, const QString& description = QString());
@@ -94,6 +101,7 @@ private slots:
     void onLanguageChanged(const QString& language);
     void onAutoSaveChanged(bool enabled);
     void onBackupSettingsChanged(bool enabled);
+    void onBackupNowClicked();
 
     // Visualization settings
     void onBackgroundColorChanged();
@@ -152,6 +160,10 @@ private:
     QCheckBox* m_autoSaveCheck;
     QCheckBox* m_backupCheck;
     QSpinBox* m_autoSaveIntervalSpin;
+    QPushButton* m_backupNowButton;
+    QLabel* m_backupStatusLabel;
+    DatabaseBackup* m_activeBackup;
+    QTimer* m_backupTimer;
 
     // Visualization settings
     QPushButton* m_backgroundColorButton;
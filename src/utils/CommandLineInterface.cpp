@@ -1,5 +1,6 @@
 #include "CommandLineInterface.h"
 #include "../core/DatabaseManager.h"
+#include "../core/DatabaseBackup.h"
 #include "../core/ModelService.h"
 #include "../core/SearchService.h"
 #include "../core/TagManager.h"
@@ -222,15 +223,28 @@ bool CommandLineInterface::executeDatabaseBackup(const QString& path)
         return false;
     }
 
-    // Copy database file
+    // Online snapshot copy: safe while the application is writing, and
+    // never picks up a torn WAL
     QString dbPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/models.db";
-    bool success = QFile::copy(dbPath, backupPath);
+    DatabaseBackup backup(dbPath, backupPath);
+
+    int lastPercent = -1;
+    connect(&backup, &DatabaseBackup::progress, this, [&lastPercent](int copied, int total) {
+        int percent = total > 0 ? copied * 100 / total : 100;
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            std::cout << "\rBackup progress: " << percent << "%" << std::flush;
+        }
+    });
+
+    bool success = backup.execute();
+    std::cout << std::endl;
 
     if (success) {
         logOperation("Database Backup", "Backup completed: " + backupPath);
         std::cout << "Database backup completed: " << backupPath.toStdString() << std::endl;
     } else {
-        logError("Database Backup", "Failed to create backup");
+        logError("Database Backup", "Failed to create backup: " + backup.errorString());
     }
 
     return success;
@@ -248,15 +262,17 @@ bool CommandLineInterface::executeDatabaseRestore(const QString& path)
     // Create backup of current database
     executeDatabaseBackup(generateTimestampedFilename("models_pre_restore", "db"));
 
-    // Restore from backup
+    // Restore from backup, replacing the contents of the existing database in one transaction
     QString dbPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/models.db";
-    bool success = QFile::copy(path, dbPath);
+    DatabaseBackup restore(path, dbPath);
+    restore.setWriteInPlace(true);
+    bool success = restore.execute();
 
     if (success) {
         logOperation("Database Restore", "Restore completed from: " + path);
         std::cout << "Database restore completed from: " << path.toStdString() << std::endl;
     } else {
-        logError("Database Restore", "Failed to restore database");
+        logError("Database Restore", "Failed to restore database: " + restore.errorString());
     }
 
     return success;
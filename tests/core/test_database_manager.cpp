@@ -0,0 +1,350 @@
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include "../../src/core/DatabaseManager.h"
+#include "../../src/core/ModelCursor.h"
+
+class TestDatabaseManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testMigrationFromTextKeys();
+    void testMigrationResumesAfterInterruptedStep();
+    void testBackupAndRestore();
+    void testCloseReleasesWorkerConnections();
+
+private:
+    static QString schemaVersion(const QString& path);
+    static int pooledConnectionCount();
+    void createVersion100Database(const QString& path, const QUuid& bracketId, const QUuid& gearId,
+                                  const QUuid& projectId);
+};
+
+void TestDatabaseManager::createVersion100Database(const QString& path, const QUuid& bracketId,
+                                                   const QUuid& gearId, const QUuid& projectId)
+{
+    // The 1.0.0 schema: text UUID keys and no derived columns
+    QSqlDatabase legacy = QSqlDatabase::addDatabase("QSQLITE", "legacy_schema");
+    legacy.setDatabaseName(path);
+    QVERIFY(legacy.open());
+
+    QStringList statements = {
+        "CREATE TABLE models (id TEXT PRIMARY KEY, filename TEXT NOT NULL, file_size INTEGER NOT NULL,"
+        "import_date TEXT NOT NULL, thumbnail_path TEXT, mesh_stats TEXT,"
+        "created_date TEXT DEFAULT CURRENT_TIMESTAMP, modified_date TEXT DEFAULT CURRENT_TIMESTAMP)",
+        "CREATE TABLE projects (id TEXT PRIMARY KEY, name TEXT NOT NULL, description TEXT,"
+        "created_date TEXT NOT NULL, metadata TEXT, modified_date TEXT DEFAULT CURRENT_TIMESTAMP)",
+        "CREATE TABLE project_models (project_id TEXT NOT NULL, model_id TEXT NOT NULL,"
+        "added_date TEXT DEFAULT CURRENT_TIMESTAMP, PRIMARY KEY (project_id, model_id))",
+        "CREATE TABLE tags (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT UNIQUE NOT NULL,"
+        "category TEXT, color TEXT, created_date TEXT DEFAULT CURRENT_TIMESTAMP)",
+        "CREATE TABLE model_tags (model_id TEXT NOT NULL, tag_id INTEGER NOT NULL,"
+        "assigned_date TEXT DEFAULT CURRENT_TIMESTAMP, PRIMARY KEY (model_id, tag_id))",
+        "CREATE TABLE project_tags (project_id TEXT NOT NULL, tag_id INTEGER NOT NULL,"
+        "assigned_date TEXT DEFAULT CURRENT_TIMESTAMP, PRIMARY KEY (project_id, tag_id))",
+        "CREATE TABLE settings (key TEXT PRIMARY KEY, value TEXT NOT NULL,"
+        "created_date TEXT DEFAULT CURRENT_TIMESTAMP, modified_date TEXT DEFAULT CURRENT_TIMESTAMP)",
+        "CREATE TABLE schema_version (version TEXT PRIMARY KEY, applied_date TEXT DEFAULT CURRENT_TIMESTAMP)",
+        "INSERT INTO schema_version (version) VALUES ('1.0.0')",
+        "INSERT INTO tags (name) VALUES ('steel'), ('fixture')"
+    };
+
+    QSqlQuery query(legacy);
+    for (const QString& statement : statements) {
+        QVERIFY2(query.exec(statement), qPrintable(statement));
+    }
+
+    // Two tagged models, one of them in a project
+    query.prepare("INSERT INTO models (id, filename, file_size, import_date, mesh_stats) VALUES (?, ?, ?, ?, ?)");
+    query.addBindValue(QVariantList() << bracketId.toString() << gearId.toString());
+    query.addBindValue(QVariantList() << "bracket.stl" << "gear.obj");
+    query.addBindValue(QVariantList() << 1000 << 2000);
+    query.addBindValue(QVariantList() << "2024-01-01T00:00:00Z" << "2024-02-01T00:00:00Z");
+    query.addBindValue(QVariantList()
+                       << "{\"vertex_count\":8,\"triangle_count\":12,\"bounds\":{\"x\":1,\"y\":2,\"z\":3}}"
+                       << "{\"vertex_count\":500,\"triangle_count\":900}");
+    QVERIFY(query.execBatch());
+
+    query.prepare("INSERT INTO model_tags (model_id, tag_id) SELECT ?, id FROM tags WHERE name = ?");
+    query.addBindValue(QVariantList() << bracketId.toString() << bracketId.toString() << gearId.toString());
+    query.addBindValue(QVariantList() << "steel" << "fixture" << "steel");
+    QVERIFY(query.execBatch());
+
+    query.prepare("INSERT INTO projects (id, name, created_date) VALUES (?, 'Jig', '2024-03-01T00:00:00Z')");
+    query.addBindValue(projectId.toString());
+    QVERIFY(query.exec());
+
+    query.prepare("INSERT INTO project_models (project_id, model_id) VALUES (?, ?)");
+    query.addBindValue(projectId.toString());
+    query.addBindValue(bracketId.toString());
+    QVERIFY(query.exec());
+
+    query.finish();
+    legacy.close();
+}
+
+void TestDatabaseManager::testMigrationFromTextKeys()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("legacy.db");
+
+    QUuid bracketId = QUuid::createUuid();
+    QUuid gearId = QUuid::createUuid();
+    QUuid projectId = QUuid::createUuid();
+    createVersion100Database(path, bracketId, gearId, projectId);
+    QSqlDatabase::removeDatabase("legacy_schema");
+
+    DatabaseManager* dbManager = new DatabaseManager(this);
+    QVERIFY(dbManager->initialize(path));
+
+    // Models and their tags
+    QHash<QUuid, ModelMetadata> models;
+    ModelCursor cursor = dbManager->openModelCursor({bracketId, gearId}, ModelCursor::Filename | ModelCursor::Tags);
+    while (cursor.next()) {
+        models.insert(cursor.current().id, cursor.current());
+    }
+    QCOMPARE(models.size(), 2);
+    QCOMPARE(models[bracketId].filename, QString("bracket.stl"));
+    QStringList bracketTags = models[bracketId].tags;
+    bracketTags.sort();
+    QCOMPARE(bracketTags, QStringList({"fixture", "steel"}));
+    QCOMPARE(models[gearId].tags, QStringList({"steel"}));
+
+    // Counters seeded from the migrated rows
+    QMap<QString, int> usage = dbManager->getTagUsageCounts();
+    QCOMPARE(usage.value("steel"), 2);
+    QCOMPARE(usage.value("fixture"), 1);
+
+    QVariantMap stats = dbManager->getModelStatistics();
+    QCOMPARE(stats["total_models"].toLongLong(), 2LL);
+    QCOMPARE(stats["total_size"].toLongLong(), 3000LL);
+    QCOMPARE(stats["format_distribution"].toMap().value("stl").toLongLong(), 1LL);
+
+    // Full-text index rebuilt over the new keys, tags included
+    QCOMPARE(dbManager->fullTextSearch("bracket"), QList<QUuid>({bracketId}));
+    QCOMPARE(dbManager->fullTextSearch("fixture"), QList<QUuid>({bracketId}));
+
+    // Mesh statistics moved into their typed columns
+    QVariantMap ranges;
+    ranges["vertex_count"] = QVariantMap{{"min", 8}, {"max", 8}};
+    QCOMPARE(dbManager->findModelsInRanges(ranges), QList<QUuid>({bracketId}));
+
+    // Project membership joined through the new integer ids
+    {
+        QSqlDatabase check = QSqlDatabase::addDatabase("QSQLITE", "migration_check");
+        check.setDatabaseName(path);
+        QVERIFY(check.open());
+        QSqlQuery query(check);
+
+        query.prepare("SELECT COUNT(*) FROM project_models "
+                      "JOIN projects ON projects.id = project_models.project_id "
+                      "JOIN models ON models.id = project_models.model_id "
+                      "WHERE projects.uuid = ? AND models.uuid = ?");
+        query.addBindValue(projectId.toRfc4122());
+        query.addBindValue(bracketId.toRfc4122());
+        QVERIFY(query.exec() && query.next());
+        QCOMPARE(query.value(0).toInt(), 1);
+
+        QVERIFY(query.exec("SELECT COUNT(*) FROM sqlite_master WHERE name LIKE '%\\_v1' ESCAPE '\\'"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toInt(), 0);
+
+        QVERIFY(query.exec("SELECT version FROM schema_version"));
+        QVERIFY(query.next());
+        QVERIFY(query.value(0).toString() != "1.0.0");
+
+        query.finish();
+        check.close();
+    }
+    QSqlDatabase::removeDatabase("migration_check");
+
+    dbManager->close();
+    delete dbManager;
+}
+
+QString TestDatabaseManager::schemaVersion(const QString& path)
+{
+    QString version;
+    {
+        QSqlDatabase check = QSqlDatabase::addDatabase("QSQLITE", "version_check");
+        check.setDatabaseName(path);
+        if (check.open()) {
+            QSqlQuery query("SELECT version FROM schema_version", check);
+            if (query.next()) {
+                version = query.value(0).toString();
+            }
+        }
+        check.close();
+    }
+    QSqlDatabase::removeDatabase("version_check");
+    return version;
+}
+
+void TestDatabaseManager::testMigrationResumesAfterInterruptedStep()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("interrupted.db");
+
+    QUuid bracketId = QUuid::createUuid();
+    QUuid gearId = QUuid::createUuid();
+    QUuid projectId = QUuid::createUuid();
+    createVersion100Database(path, bracketId, gearId, projectId);
+    QSqlDatabase::removeDatabase("legacy_schema");
+
+    // Make the 1.3.0 counter seeding fail, after the 1.2.0 rekeying has committed
+    {
+        QSqlDatabase legacy = QSqlDatabase::addDatabase("QSQLITE", "interrupt");
+        legacy.setDatabaseName(path);
+        QVERIFY(legacy.open());
+        QSqlQuery query(legacy);
+        QVERIFY(query.exec("CREATE TABLE tag_usage (tag_id INTEGER PRIMARY KEY,"
+                           "usage_count INTEGER NOT NULL DEFAULT 0)"));
+        QVERIFY(query.exec("CREATE TRIGGER interrupt_seed BEFORE INSERT ON tag_usage BEGIN "
+                           "SELECT RAISE(ABORT, 'interrupted'); END"));
+        legacy.close();
+    }
+    QSqlDatabase::removeDatabase("interrupt");
+
+    DatabaseManager* dbManager = new DatabaseManager(this);
+    QVERIFY(!dbManager->initialize(path));
+    delete dbManager;
+
+    // The finished steps are recorded
+    QCOMPARE(schemaVersion(path), QString("1.2.0"));
+
+    // Forget that too, as a crash between the rekeying commit and its
+    // version update would, and let the next launch run everything again
+    {
+        QSqlDatabase legacy = QSqlDatabase::addDatabase("QSQLITE", "interrupt");
+        legacy.setDatabaseName(path);
+        QVERIFY(legacy.open());
+        QSqlQuery query(legacy);
+        QVERIFY(query.exec("DROP TRIGGER interrupt_seed"));
+        QVERIFY(query.exec("UPDATE schema_version SET version = '1.0.0'"));
+        legacy.close();
+    }
+    QSqlDatabase::removeDatabase("interrupt");
+
+    dbManager = new DatabaseManager(this);
+    QVERIFY(dbManager->initialize(path));
+
+    QHash<QUuid, ModelMetadata> models;
+    ModelCursor cursor = dbManager->openModelCursor({bracketId, gearId}, ModelCursor::Filename | ModelCursor::Tags);
+    while (cursor.next()) {
+        models.insert(cursor.current().id, cursor.current());
+    }
+    QCOMPARE(models.size(), 2);
+    QCOMPARE(models[gearId].filename, QString("gear.obj"));
+    QCOMPARE(models[gearId].tags, QStringList({"steel"}));
+
+    QMap<QString, int> usage = dbManager->getTagUsageCounts();
+    QCOMPARE(usage.value("steel"), 2);
+    QCOMPARE(usage.value("fixture"), 1);
+    QCOMPARE(dbManager->fullTextSearch("fixture"), QList<QUuid>({bracketId}));
+
+    dbManager->close();
+    delete dbManager;
+
+    QCOMPARE(schemaVersion(path), QString("1.9.0"));
+}
+
+void TestDatabaseManager::testBackupAndRestore()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString backupPath = dir.filePath("backups/models_backup.db");
+
+    DatabaseManager* dbManager = new DatabaseManager(this);
+    QVERIFY(dbManager->initialize(dir.filePath("models.db")));
+
+    ModelMetadata bracket(QUuid::createUuid());
+    bracket.filename = "bracket.stl";
+    bracket.fileSize = 1000;
+    bracket.importDate = "2024-01-01T00:00:00Z";
+    bracket.tags = QStringList({"steel", "fixture"});
+    QVERIFY(dbManager->insertModel(bracket));
+
+    QVERIFY(dbManager->backup(backupPath));
+    QVERIFY(QFileInfo::exists(backupPath));
+    QVERIFY(!QFileInfo::exists(backupPath + ".partial"));
+
+    // Changes after the backup are undone by restoring it
+    ModelMetadata gear(QUuid::createUuid());
+    gear.filename = "gear.obj";
+    gear.fileSize = 2000;
+    gear.importDate = "2024-02-01T00:00:00Z";
+    gear.tags = QStringList({"steel"});
+    QVERIFY(dbManager->insertModel(gear));
+    QCOMPARE(dbManager->getTagUsageCounts().value("steel"), 2);
+
+    auto isStored = [dbManager](const QUuid& id) {
+        ModelCursor cursor = dbManager->openModelCursor({id}, ModelCursor::Filename);
+        return cursor.next();
+    };
+
+    QVERIFY(dbManager->restore(backupPath));
+
+    QVERIFY(isStored(bracket.id));
+    QVERIFY(!isStored(gear.id));
+    QCOMPARE(dbManager->getTagUsageCounts().value("steel"), 1);
+    QCOMPARE(dbManager->fullTextSearch("fixture"), QList<QUuid>({bracket.id}));
+    QVERIFY(dbManager->fullTextSearch("gear").isEmpty());
+
+    // The restored database takes writes, and its triggers still run
+    QVERIFY(dbManager->insertModel(gear));
+    QCOMPARE(dbManager->getTagUsageCounts().value("steel"), 2);
+    QCOMPARE(dbManager->fullTextSearch("gear"), QList<QUuid>({gear.id}));
+
+    // A file that is not a database leaves the contents alone
+    QFile garbage(dir.filePath("garbage.db"));
+    QVERIFY(garbage.open(QIODevice::WriteOnly));
+    garbage.write(QByteArray(8192, 'x'));
+    garbage.close();
+    QVERIFY(!dbManager->restore(garbage.fileName()));
+    QVERIFY(isStored(gear.id));
+
+    dbManager->close();
+    delete dbManager;
+}
+
+int TestDatabaseManager::pooledConnectionCount()
+{
+    int count = 0;
+    for (const QString& name : QSqlDatabase::connectionNames()) {
+        if (name.startsWith("pool_")) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void TestDatabaseManager::testCloseReleasesWorkerConnections()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    int pooledBefore = pooledConnectionCount();
+
+    DatabaseManager* dbManager = new DatabaseManager(this);
+    QVERIFY(dbManager->initialize(dir.filePath("models.db")));
+
+    // A worker that stays alive and idle after reading, as pool threads do
+    QThreadPool workers;
+    workers.setExpiryTimeout(-1);
+    QtConcurrent::run(&workers, [dbManager]() {
+        return dbManager->getTagUsageCounts();
+    }).waitForFinished();
+    QVERIFY(pooledConnectionCount() > pooledBefore);
+
+    dbManager->close();
+    QCOMPARE(pooledConnectionCount(), pooledBefore);
+    delete dbManager;
+}
+
+QTEST_MAIN(TestDatabaseManager)
+#include "test_database_manager.moc"
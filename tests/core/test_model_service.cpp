@@ -17,6 +17,7 @@ private slots:
     void testModelMetadata();
     void testModelSearch();
     void testBatchOperations();
+    void testReimportDeduplication();
     void testModelValidation();
     void testPerformanceMetrics();
 
@@ -140,6 +141,43 @@ void TestModelService::testBatchOperations()
     }
 }
 
+void TestModelService::testReimportDeduplication()
+{
+    // The service finds the database through its parent
+    ModelService* service = new ModelService(m_databaseManager);
+    QSignalSpy alreadyImported(service, &ModelService::modelAlreadyImported);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QByteArray content = "solid dedup\nendsolid dedup\n";
+    QByteArray sameSize = "solid dedux\nendsolid dedux\n";
+    auto writeFile = [&dir](const QString& name, const QByteArray& bytes) {
+        QFile file(dir.filePath(name));
+        file.open(QIODevice::WriteOnly);
+        file.write(bytes);
+        return file.fileName();
+    };
+
+    ModelMetadata first = service->loadModelAsync(writeFile("original.stl", content)).result();
+    QVERIFY(!first.id.isNull());
+    QVERIFY(!first.contentHash.isEmpty());
+    QCOMPARE(alreadyImported.count(), 0);
+
+    // The same bytes under another name resolve to the stored model
+    ModelMetadata again = service->loadModelAsync(writeFile("renamed.stl", content)).result();
+    QCOMPARE(again.id, first.id);
+    QCOMPARE(alreadyImported.count(), 1);
+
+    // Equal size alone is not a match
+    ModelMetadata other = service->loadModelAsync(writeFile("other.stl", sameSize)).result();
+    QVERIFY(!other.id.isNull());
+    QVERIFY(other.id != first.id);
+    QVERIFY(other.contentHash != first.contentHash);
+    QCOMPARE(alreadyImported.count(), 1);
+
+    delete service;
+}
+
 void TestModelService::testModelValidation()
 {
     // Test file validation
@@ -0,0 +1,149 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QSet>
+#include <algorithm>
+#include <iterator>
+#include "../../src/core/RoaringBitmap.h"
+
+class TestRoaringBitmap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testArrayBitmapThreshold();
+    void testRandomOperationsAgainstSet();
+
+private:
+    static QVector<quint32> sorted(const QSet<quint32>& values);
+    static void fill(QRandomGenerator& random, RoaringBitmap& bitmap, QSet<quint32>& reference);
+};
+
+QVector<quint32> TestRoaringBitmap::sorted(const QSet<quint32>& values)
+{
+    QVector<quint32> result(values.begin(), values.end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void TestRoaringBitmap::fill(QRandomGenerator& random, RoaringBitmap& bitmap, QSet<quint32>& reference)
+{
+    // Group sizes straddle the array limit so both layouts, and the
+    // conversions between them, meet in every operation
+    static const int GROUP_SIZES[] = {0, 1, 100, RoaringBitmap::ARRAY_LIMIT - 1, RoaringBitmap::ARRAY_LIMIT,
+                                      RoaringBitmap::ARRAY_LIMIT + 1, 20000, 65536};
+
+    for (quint32 high = 0; high < 4; ++high) {
+        int target = GROUP_SIZES[random.bounded(static_cast<int>(std::size(GROUP_SIZES)))];
+        QSet<quint32> group;
+        while (group.size() < target) {
+            group.insert((high << 16) | random.bounded(65536));
+        }
+        for (quint32 value : group) {
+            bitmap.add(value);
+            reference.insert(value);
+        }
+    }
+}
+
+void TestRoaringBitmap::testArrayBitmapThreshold()
+{
+    // Step one group across the array limit and back, in both directions
+    RoaringBitmap bitmap;
+    QSet<quint32> reference;
+    for (quint32 value = 0; value < RoaringBitmap::ARRAY_LIMIT; ++value) {
+        bitmap.add(value * 2);
+        reference.insert(value * 2);
+    }
+    QCOMPARE(bitmap.toVector(), sorted(reference));
+
+    for (quint32 value = 1; value < 8; value += 2) {
+        bitmap.add(value);
+        reference.insert(value);
+        QCOMPARE(bitmap.cardinality(), qint64(reference.size()));
+        QVERIFY(bitmap.contains(value) && !bitmap.contains(value + 8 * RoaringBitmap::ARRAY_LIMIT));
+    }
+    QCOMPARE(bitmap.toVector(), sorted(reference));
+
+    for (quint32 value = 0; value < 16; ++value) {
+        bitmap.remove(value);
+        reference.remove(value);
+        QCOMPARE(bitmap.cardinality(), qint64(reference.size()));
+        QVERIFY(!bitmap.contains(value));
+    }
+    QCOMPARE(bitmap.toVector(), sorted(reference));
+
+    // Operation results landing on either side of the limit
+    RoaringBitmap low;
+    RoaringBitmap high;
+    for (quint32 value = 0; value <= 2 * RoaringBitmap::ARRAY_LIMIT; ++value) {
+        if (value <= RoaringBitmap::ARRAY_LIMIT + 1) {
+            low.add(value);
+        }
+        if (value >= RoaringBitmap::ARRAY_LIMIT - 1) {
+            high.add(value);
+        }
+    }
+    QCOMPARE((low & high).toVector(), QVector<quint32>({RoaringBitmap::ARRAY_LIMIT - 1, RoaringBitmap::ARRAY_LIMIT,
+                                                         RoaringBitmap::ARRAY_LIMIT + 1}));
+    QCOMPARE((low | high).cardinality(), qint64(2 * RoaringBitmap::ARRAY_LIMIT + 1));
+    QCOMPARE((low - high).cardinality(), qint64(RoaringBitmap::ARRAY_LIMIT - 1));
+    QCOMPARE((high - low).cardinality(), qint64(RoaringBitmap::ARRAY_LIMIT - 1));
+    QVERIFY(((low | high) - low - high).isEmpty());
+}
+
+void TestRoaringBitmap::testRandomOperationsAgainstSet()
+{
+    QRandomGenerator random(20250214);
+
+    for (int round = 0; round < 40; ++round) {
+        RoaringBitmap a;
+        RoaringBitmap b;
+        QSet<quint32> setA;
+        QSet<quint32> setB;
+        fill(random, a, setA);
+        fill(random, b, setB);
+
+        QCOMPARE(a.toVector(), sorted(setA));
+        QCOMPARE(a.cardinality(), qint64(setA.size()));
+        QCOMPARE(a.isEmpty(), setA.isEmpty());
+
+        QCOMPARE((a & b).toVector(), sorted(setA & setB));
+        QCOMPARE((a | b).toVector(), sorted(setA | setB));
+        QCOMPARE((a - b).toVector(), sorted(setA - setB));
+        QCOMPARE((b - a).toVector(), sorted(setB - setA));
+        QCOMPARE((a & b).cardinality(), qint64((setA & setB).size()));
+
+        RoaringBitmap inPlace = a;
+        inPlace &= b;
+        QCOMPARE(inPlace.toVector(), sorted(setA & setB));
+        inPlace = a;
+        inPlace |= b;
+        QCOMPARE(inPlace.toVector(), sorted(setA | setB));
+        inPlace = a;
+        inPlace -= b;
+        QCOMPARE(inPlace.toVector(), sorted(setA - setB));
+
+        // Removals walk containers back down through the limit
+        QVector<quint32> values = sorted(setA);
+        int removals = values.size() / 2;
+        for (int i = 0; i < removals; ++i) {
+            quint32 value = values[random.bounded(static_cast<int>(values.size()))];
+            a.remove(value);
+            setA.remove(value);
+        }
+        a.remove(0xFFFFFFFF);
+        QCOMPARE(a.toVector(), sorted(setA));
+        QCOMPARE(a.cardinality(), qint64(setA.size()));
+
+        for (int probe = 0; probe < 1000; ++probe) {
+            quint32 value = random.bounded(4u << 16);
+            QCOMPARE(a.contains(value), setA.contains(value));
+        }
+
+        QCOMPARE((a | b).toVector(), sorted(setA | setB));
+        QCOMPARE((a & b).toVector(), sorted(setA & setB));
+    }
+}
+
+QTEST_MAIN(TestRoaringBitmap)
+#include "test_roaring_bitmap.moc"
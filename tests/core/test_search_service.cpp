@@ -0,0 +1,183 @@
+#include <QtTest>
+#include "../../src/core/SearchQuery.h"
+
+class TestSearchService : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testQueryRanges();
+    void testQueryUnitSuffixes();
+    void testQueryOpenBounds();
+    void testQueryDates();
+    void testQueryNegation();
+    void testQueryQuoting();
+    void testQueryErrors();
+    void testQueryApplyTo();
+
+private:
+    static SearchService::SearchFilters filtersFor(const QString& query);
+};
+
+SearchService::SearchFilters TestSearchService::filtersFor(const QString& query)
+{
+    return SearchQuery(query).applyTo(SearchService::SearchFilters());
+}
+
+void TestSearchService::testQueryRanges()
+{
+    // Exclusive bounds move by one, since sizes and counts are whole numbers
+    SearchService::SearchFilters filters = filtersFor("size:>50MB tris:<200k verts:1k..2k gear");
+    QCOMPARE(filters.sizeRange.value("min").toLongLong(), 50LL * 1048576 + 1);
+    QVERIFY(!filters.sizeRange.contains("max"));
+    QCOMPARE(filters.customFilters.value("triangle_count").toMap().value("max").toLongLong(), 199999LL);
+    QVariantMap vertices = filters.customFilters.value("vertex_count").toMap();
+    QCOMPARE(vertices.value("min").toLongLong(), 1000LL);
+    QCOMPARE(vertices.value("max").toLongLong(), 2000LL);
+
+    // A bare value is both bounds
+    filters = filtersFor("triangles:>=12 size:<=4096");
+    QCOMPARE(filters.customFilters.value("triangle_count").toMap().value("min").toLongLong(), 12LL);
+    QCOMPARE(filters.sizeRange.value("max").toLongLong(), 4096LL);
+
+    filters = filtersFor("vertices:500");
+    vertices = filters.customFilters.value("vertex_count").toMap();
+    QCOMPARE(vertices.value("min").toLongLong(), 500LL);
+    QCOMPARE(vertices.value("max").toLongLong(), 500LL);
+
+    QCOMPARE(SearchQuery("size:>50MB gear").text(), QString("gear"));
+}
+
+void TestSearchService::testQueryUnitSuffixes()
+{
+    // Sizes are binary and case-insensitive; counts are decimal
+    QCOMPARE(filtersFor("size:10KB").sizeRange.value("min").toLongLong(), 10LL * 1024);
+    QCOMPARE(filtersFor("size:2m").sizeRange.value("min").toLongLong(), 2LL * 1048576);
+    QCOMPARE(filtersFor("size:1.5GB").sizeRange.value("min").toLongLong(), 3LL * 536870912);
+    QCOMPARE(filtersFor("size:1tb").sizeRange.value("min").toLongLong(), 1099511627776LL);
+    QCOMPARE(filtersFor("size:100").sizeRange.value("min").toLongLong(), 100LL);
+    QCOMPARE(filtersFor("size:100b").sizeRange.value("min").toLongLong(), 100LL);
+
+    QCOMPARE(filtersFor("tris:1.5m").customFilters.value("triangle_count").toMap().value("min").toLongLong(),
+             1500000LL);
+    QCOMPARE(filtersFor("verts:3K").customFilters.value("vertex_count").toMap().value("min").toLongLong(), 3000LL);
+}
+
+void TestSearchService::testQueryOpenBounds()
+{
+    SearchService::SearchFilters filters = filtersFor("size:..1MB");
+    QVERIFY(!filters.sizeRange.contains("min"));
+    QCOMPARE(filters.sizeRange.value("max").toLongLong(), 1048576LL);
+
+    filters = filtersFor("tris:10k..");
+    QVariantMap triangles = filters.customFilters.value("triangle_count").toMap();
+    QCOMPARE(triangles.value("min").toLongLong(), 10000LL);
+    QVERIFY(!triangles.contains("max"));
+
+    // Both ends open says nothing
+    SearchQuery query("size:..");
+    QCOMPARE(query.errors(), QStringList({"size:.."}));
+    QVERIFY(query.applyTo(SearchService::SearchFilters()).sizeRange.isEmpty());
+}
+
+void TestSearchService::testQueryDates()
+{
+    // A period covers every day in it; the upper bound includes the whole last day
+    SearchService::SearchFilters filters = filtersFor("date:2025");
+    QCOMPARE(filters.dateRange.value("min").toString(), QString("2025-01-01"));
+    QCOMPARE(filters.dateRange.value("max").toString(), QString("2025-12-31T23:59:59Z"));
+
+    filters = filtersFor("date:2024-02");
+    QCOMPARE(filters.dateRange.value("min").toString(), QString("2024-02-01"));
+    QCOMPARE(filters.dateRange.value("max").toString(), QString("2024-02-29T23:59:59Z"));
+
+    filters = filtersFor("date:2024-06-15");
+    QCOMPARE(filters.dateRange.value("min").toString(), QString("2024-06-15"));
+    QCOMPARE(filters.dateRange.value("max").toString(), QString("2024-06-15T23:59:59Z"));
+
+    // Exclusive bounds skip the whole period
+    filters = filtersFor("date:>2024-06");
+    QCOMPARE(filters.dateRange.value("min").toString(), QString("2024-07-01"));
+    QVERIFY(!filters.dateRange.contains("max"));
+
+    filters = filtersFor("date:<2024");
+    QVERIFY(!filters.dateRange.contains("min"));
+    QCOMPARE(filters.dateRange.value("max").toString(), QString("2023-12-31T23:59:59Z"));
+
+    filters = filtersFor("date:2024-01..2024-03");
+    QCOMPARE(filters.dateRange.value("min").toString(), QString("2024-01-01"));
+    QCOMPARE(filters.dateRange.value("max").toString(), QString("2024-03-31T23:59:59Z"));
+
+    filters = filtersFor("date:2025..");
+    QCOMPARE(filters.dateRange.value("min").toString(), QString("2025-01-01"));
+    QVERIFY(!filters.dateRange.contains("max"));
+}
+
+void TestSearchService::testQueryNegation()
+{
+    SearchService::SearchFilters filters = filtersFor("tag:bracket -tag:obsolete -TAG:draft");
+    QCOMPARE(filters.tags, QStringList({"bracket"}));
+    QCOMPARE(filters.excludeTags, QStringList({"obsolete", "draft"}));
+
+    // Only tags can be excluded; a negated plain word stays free text
+    SearchQuery query("-ext:stl -gear");
+    QCOMPARE(query.errors(), QStringList({"-ext:stl"}));
+    QVERIFY(query.applyTo(SearchService::SearchFilters()).fileTypes.isEmpty());
+    QCOMPARE(query.text(), QString("-gear"));
+}
+
+void TestSearchService::testQueryQuoting()
+{
+    // Quotes keep spaces inside a value and are dropped
+    SearchQuery query("tag:\"spur gear\" ext:.STL bolt");
+    SearchService::SearchFilters filters = query.applyTo(SearchService::SearchFilters());
+    QCOMPARE(filters.tags, QStringList({"spur gear"}));
+    QCOMPARE(filters.fileTypes, QStringList({"stl"}));
+    QCOMPARE(query.text(), QString("bolt"));
+
+    QCOMPARE(SearchQuery("\"m3 bolt\" nut").text(), QString("m3 bolt nut"));
+    QCOMPARE(filtersFor("size:\">1MB\"").sizeRange.value("min").toLongLong(), 1048577LL);
+
+    // A finished last word, or a trailing field term, ends the prefix
+    QCOMPARE(SearchQuery("gear ").text(), QString("gear "));
+    QCOMPARE(SearchQuery("gear tag:steel").text(), QString("gear "));
+}
+
+void TestSearchService::testQueryErrors()
+{
+    SearchQuery query("size:big tris:-5 date:yesterday is:folder project:nope tag: m3:bolt");
+    QCOMPARE(query.errors(), QStringList({"size:big", "tris:-5", "date:yesterday", "is:folder",
+                                          "project:nope", "tag:"}));
+    QVERIFY(query.hasFieldTerms());
+    QCOMPARE(query.text(), QString("m3:bolt"));
+
+    SearchService::SearchFilters filters = query.applyTo(SearchService::SearchFilters());
+    QVERIFY(filters.sizeRange.isEmpty());
+    QVERIFY(filters.dateRange.isEmpty());
+    QVERIFY(filters.customFilters.isEmpty());
+    QVERIFY(filters.contentTypes.isEmpty());
+
+    QVERIFY(!SearchQuery("plain words").hasFieldTerms());
+}
+
+void TestSearchService::testQueryApplyTo()
+{
+    SearchService::SearchFilters base;
+    base.tags = {"steel"};
+    base.fileTypes = {"stl"};
+    base.sizeRange["min"] = 1;
+    base.sizeRange["max"] = 10;
+    base.maxResults = 25;
+
+    // Lists are merged; a range bound in the query replaces the same bound in base
+    SearchService::SearchFilters filters = SearchQuery("tag:steel tag:gear size:>=5 is:model").applyTo(base);
+    QCOMPARE(filters.tags, QStringList({"steel", "gear"}));
+    QCOMPARE(filters.fileTypes, QStringList({"stl"}));
+    QCOMPARE(filters.contentTypes, QStringList({"model"}));
+    QCOMPARE(filters.sizeRange.value("min").toLongLong(), 5LL);
+    QCOMPARE(filters.sizeRange.value("max").toLongLong(), 10LL);
+    QCOMPARE(filters.maxResults, 25);
+}
+
+QTEST_MAIN(TestSearchService)
+#include "test_search_service.moc"
@@ -0,0 +1,583 @@
+#include <QtTest>
+#include <QThreadPool>
+#include <QTemporaryDir>
+#include <QBuffer>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QMatrix4x4>
+#include "../../src/core/DatabaseManager.h"
+#include "../../src/core/InvertedIndex.h"
+#include "../../src/core/TrigramIndex.h"
+#include "../../src/core/CompletionTrie.h"
+#include "../../src/core/HnswIndex.h"
+#include "../../src/core/ShapeDescriptor.h"
+#include "../../src/core/ContentHash.h"
+#include "../../src/core/MeshFingerprint.h"
+#include "../../src/core/DuplicateClusterer.h"
+#include "../test_main.h"
+#include <algorithm>
+#include <cmath>
+
+class TestPerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkBulkInsert_data();
+    void benchmarkBulkInsert();
+    void benchmarkInvertedIndexQuery();
+    void benchmarkTypoTolerantLookup();
+    void benchmarkCompletion();
+    void benchmarkShardedSearch();
+    void benchmarkIndexPersistence();
+    void benchmarkShapeSimilarity();
+    void benchmarkContentHash();
+    void benchmarkNearDuplicateClustering();
+
+private:
+    QList<ModelMetadata> createTestModels(int count) const;
+    void populateIndex(InvertedIndex& index, int documentCount) const;
+};
+
+void TestPerformance::initTestCase()
+{
+    qInfo() << "Performance benchmarks run against the WAL configuration from DatabaseManager::initialize()";
+}
+
+void TestPerformance::cleanupTestCase()
+{
+    TestUtils::cleanupTestData();
+}
+
+QList<ModelMetadata> TestPerformance::createTestModels(int count) const
+{
+    QList<ModelMetadata> models;
+    models.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        ModelMetadata model = TestUtils::createTestModel(QString("bulk_model_%1.stl").arg(i));
+        model.tags << "bulk" << QString("group_%1").arg(i % 50);
+        model.meshStats["vertex_count"] = 1000 + i;
+        model.meshStats["triangle_count"] = 2000 + i;
+        models.append(model);
+    }
+
+    return models;
+}
+
+void TestPerformance::populateIndex(InvertedIndex& index, int documentCount) const
+{
+    const QStringList parts = {"bracket", "hinge", "gear", "mount", "clip", "spacer", "housing", "knob",
+                               "lid", "base", "adapter", "holder", "cover", "plate", "shelf", "hook"};
+    const QStringList materials = {"pla", "petg", "abs", "resin", "nylon"};
+
+    for (int i = 0; i < documentCount; ++i) {
+        index.addDocument(QString::number(i),
+                          QString("%1_%2_v%3.stl %4 group_%5")
+                          .arg(parts[i % parts.size()], parts[(i / 7) % parts.size()])
+                          .arg(i % 97)
+                          .arg(materials[i % materials.size()])
+                          .arg(i % 50));
+    }
+}
+
+void TestPerformance::benchmarkBulkInsert_data()
+{
+    QTest::addColumn<int>("modelCount");
+
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void TestPerformance::benchmarkBulkInsert()
+{
+    QFETCH(int, modelCount);
+
+    // Fresh database per row so each run starts from an empty WAL
+    DatabaseManager* databaseManager = new DatabaseManager(this);
+    QString testDbPath = TestUtils::createTestFile("", "db");
+    QVERIFY(databaseManager->initialize(testDbPath));
+
+    QList<ModelMetadata> models = createTestModels(modelCount);
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(databaseManager->insertModels(models));
+    qint64 insertTime = qMax<qint64>(1, timer.elapsed());
+
+    // Re-applying the same batch exercises the conflict path and tag set replacement
+    timer.restart();
+    QVERIFY(databaseManager->upsertModels(models));
+    qint64 upsertTime = qMax<qint64>(1, timer.elapsed());
+
+    qInfo() << QString("Bulk insert %1 models: %2ms (%3 rows/sec), upsert: %4ms (%5 rows/sec)")
+               .arg(modelCount)
+               .arg(insertTime).arg(modelCount * 1000 / insertTime)
+               .arg(upsertTime).arg(modelCount * 1000 / upsertTime);
+
+    QVERIFY(databaseManager->getAllModels().size() == modelCount);
+
+    databaseManager->close();
+    delete databaseManager;
+}
+
+void TestPerformance::benchmarkInvertedIndexQuery()
+{
+    static const int documentCount = 500000;
+
+    InvertedIndex index;
+
+    QElapsedTimer timer;
+    timer.start();
+    populateIndex(index, documentCount);
+    qint64 buildTime = timer.elapsed();
+    QCOMPARE(index.documentCount(), documentCount);
+
+    // Type-ahead sequence: each keystroke re-queries with the last term as a prefix
+    const QStringList keystrokes = {"br", "bra", "brac", "bracket", "bracket hi", "bracket hinge",
+                                    "bracket hinge pe", "bracket hinge petg"};
+
+    qint64 slowest = 0;
+    qint64 slowestRefined = 0;
+    InvertedIndex::Matches previous;
+    for (const QString& query : keystrokes) {
+        QStringList terms = InvertedIndex::tokenize(query);
+
+        timer.restart();
+        InvertedIndex::Matches matches;
+        QList<InvertedIndex::Hit> hits = index.search(terms, 100, true, InvertedIndex::Filter(), &matches);
+        slowest = qMax(slowest, timer.elapsed());
+        QVERIFY(!hits.isEmpty());
+
+        // Each keystroke narrows the last one, so its matches can be re-scored instead
+        if (!previous.docs.isEmpty()) {
+            timer.restart();
+            InvertedIndex::Matches refinedMatches;
+            QList<InvertedIndex::Hit> refined = index.refine(previous.docs, terms, 100, true,
+                                                             InvertedIndex::Filter(), &refinedMatches);
+            slowestRefined = qMax(slowestRefined, timer.elapsed());
+
+            QCOMPARE(refinedMatches.docs, matches.docs);
+            QCOMPARE(refined.size(), hits.size());
+            QCOMPARE(refined.first().key, hits.first().key);
+        }
+        previous = matches;
+    }
+
+    qInfo() << QString("Inverted index: %1 documents built in %2ms, slowest type-ahead query %3ms (%4ms refined)")
+               .arg(documentCount).arg(buildTime).arg(slowest).arg(slowestRefined);
+
+    QVERIFY(slowest < 100);
+}
+
+void TestPerformance::benchmarkTypoTolerantLookup()
+{
+    // A large vocabulary of generated words around the real ones
+    TrigramIndex index;
+    const QStringList words = {"bracket", "hinge", "gear", "mount", "housing", "adapter", "spacer", "holder"};
+    for (const QString& word : words) {
+        index.addTerm(word);
+        for (int i = 0; i < 20000; ++i) {
+            index.addTerm(word + QString::number(i));
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<TrigramIndex::Match> abbreviated = index.similarTerms("brkt", TrigramIndex::defaultMaxDistance("brkt"), 10);
+    QList<TrigramIndex::Match> misspelled = index.similarTerms("housnig", TrigramIndex::defaultMaxDistance("housnig"), 10);
+    qint64 lookupTime = timer.elapsed();
+
+    QVERIFY(!abbreviated.isEmpty());
+    QCOMPARE(abbreviated.first().term, QString("bracket"));
+    QVERIFY(!misspelled.isEmpty());
+    QCOMPARE(misspelled.first().term, QString("housing"));
+
+    qInfo() << QString("Trigram lookup over %1 terms: %2ms").arg(index.termCount()).arg(lookupTime);
+    QVERIFY(lookupTime < 100);
+}
+
+void TestPerformance::benchmarkCompletion()
+{
+    CompletionTrie completions;
+    for (int i = 0; i < 200000; ++i) {
+        completions.insert(QString("part_%1_bracket").arg(i), i % 1000);
+    }
+    completions.insert("bracket", 5000);
+
+    QElapsedTimer timer;
+    timer.start();
+    QStringList top;
+    for (int i = 0; i < 1000; ++i) {
+        top = completions.complete("bra", 10);
+    }
+    qint64 totalNs = timer.nsecsElapsed();
+
+    // Later words complete too, and the heaviest value comes first
+    QCOMPARE(top.size(), 10);
+    QCOMPARE(top.first(), QString("bracket"));
+
+    qInfo() << QString("Top-10 completion over %1 values: %2us per lookup")
+               .arg(completions.size()).arg(totalNs / 1000 / 1000);
+
+    // Renaming through remove/insert keeps the maxima consistent
+    completions.remove("bracket");
+    QVERIFY(completions.complete("bra", 1).first() != QString("bracket"));
+}
+
+void TestPerformance::benchmarkShardedSearch()
+{
+    static const int documentCount = 500000;
+
+    InvertedIndex index;
+    populateIndex(index, documentCount);
+
+    // Broad queries: a short prefix and a term carried by every document
+    const QList<QStringList> queries = {{"group", "h"}, {"pla", "b"}, {"group"}};
+
+    // Let the pool run one shard per thread even on smaller machines
+    QThreadPool* pool = QThreadPool::globalInstance();
+    int defaultThreads = pool->maxThreadCount();
+    pool->setMaxThreadCount(16);
+
+    QList<QList<InvertedIndex::Hit>> baseline;
+    qint64 baselineTime = 0;
+    for (int shards : {1, 2, 4, 8, 16}) {
+        index.setShardCount(shards);
+
+        QElapsedTimer timer;
+        timer.start();
+        QList<QList<InvertedIndex::Hit>> results;
+        for (int round = 0; round < 5; ++round) {
+            results.clear();
+            for (const QStringList& terms : queries) {
+                results.append(index.search(terms, 100));
+            }
+        }
+        qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+
+        if (shards == 1) {
+            baseline = results;
+            baselineTime = elapsed;
+        }
+
+        // Rankings must not depend on how the documents were split
+        for (int q = 0; q < queries.size(); ++q) {
+            QCOMPARE(results[q].size(), baseline[q].size());
+            for (int i = 0; i < results[q].size(); ++i) {
+                QCOMPARE(results[q][i].key, baseline[q][i].key);
+                QCOMPARE(results[q][i].score, baseline[q][i].score);
+            }
+        }
+
+        qInfo() << QString("Sharded search: %1 shards, %2ms for %3 broad queries (%4x)")
+                   .arg(shards).arg(elapsed).arg(queries.size() * 5)
+                   .arg(static_cast<double>(baselineTime) / elapsed, 0, 'f', 2);
+    }
+
+    pool->setMaxThreadCount(defaultThreads);
+}
+
+void TestPerformance::benchmarkIndexPersistence()
+{
+    static const int documentCount = 500000;
+
+    InvertedIndex index;
+    QElapsedTimer timer;
+    timer.start();
+    populateIndex(index, documentCount);
+    qint64 buildTime = timer.elapsed();
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString path = dir.filePath("search.idx");
+
+    QFile out(path);
+    QVERIFY(out.open(QIODevice::WriteOnly));
+    QDataStream stream(&out);
+    index.save(stream);
+    out.close();
+
+    // Loading maps the file and refers to the postings in place
+    timer.restart();
+    QSharedPointer<QFile> file(new QFile(path));
+    QVERIFY(file->open(QIODevice::ReadOnly));
+    const char* data = reinterpret_cast<const char*>(file->map(0, file->size()));
+    QVERIFY(data);
+
+    QByteArray mapping = QByteArray::fromRawData(data, file->size());
+    QBuffer buffer(&mapping);
+    buffer.open(QIODevice::ReadOnly);
+    QDataStream in(&buffer);
+
+    InvertedIndex loaded;
+    QVERIFY(loaded.load(in, mapping, file));
+    qint64 loadTime = timer.elapsed();
+
+    QCOMPARE(loaded.documentCount(), index.documentCount());
+    for (const QString& query : {QString("bracket hinge"), QString("group pe"), QString("knob")}) {
+        QList<InvertedIndex::Hit> expected = index.search(InvertedIndex::tokenize(query), 50);
+        QList<InvertedIndex::Hit> actual = loaded.search(InvertedIndex::tokenize(query), 50);
+        QCOMPARE(actual.size(), expected.size());
+        for (int i = 0; i < actual.size(); ++i) {
+            QCOMPARE(actual[i].key, expected[i].key);
+        }
+    }
+
+    // Appending after a load copies the mapped postings it touches
+    loaded.addDocument("extra", "bracket knob");
+    QVERIFY(loaded.contains("extra"));
+
+    qInfo() << QString("Index persistence: %1 documents built in %2ms, loaded from %3 bytes in %4ms")
+               .arg(documentCount).arg(buildTime).arg(QFileInfo(path).size()).arg(loadTime);
+
+    QVERIFY(loadTime < buildTime);
+}
+
+static void addBox(QVector<QVector3D>& positions, QVector<unsigned int>& indices, const QMatrix4x4& transform,
+                   const QVector3D& size)
+{
+    unsigned int base = static_cast<unsigned int>(positions.size());
+    for (int corner = 0; corner < 8; ++corner) {
+        positions.append(transform.map(QVector3D(corner & 1 ? size.x() : 0.0f, corner & 2 ? size.y() : 0.0f,
+                                                 corner & 4 ? size.z() : 0.0f)));
+    }
+
+    const unsigned int faces[12][3] = {{0, 1, 3}, {0, 3, 2}, {4, 6, 7}, {4, 7, 5}, {0, 4, 5}, {0, 5, 1},
+                                       {2, 3, 7}, {2, 7, 6}, {0, 2, 6}, {0, 6, 4}, {1, 5, 7}, {1, 7, 3}};
+    for (const auto& face : faces) {
+        indices << base + face[0] << base + face[1] << base + face[2];
+    }
+}
+
+void TestPerformance::benchmarkShapeSimilarity()
+{
+    // Descriptors ignore rotation and scale but tell bars from plates
+    QVector<QVector3D> barPositions, turnedPositions, platePositions;
+    QVector<unsigned int> barIndices, turnedIndices, plateIndices;
+    QMatrix4x4 turned;
+    turned.rotate(37.0f, QVector3D(1, 2, 3).normalized());
+    turned.scale(3.0f);
+    addBox(barPositions, barIndices, QMatrix4x4(), QVector3D(10, 1, 1));
+    addBox(turnedPositions, turnedIndices, turned, QVector3D(10, 1, 1));
+    addBox(platePositions, plateIndices, QMatrix4x4(), QVector3D(10, 10, 1));
+
+    ShapeDescriptor bar = ShapeDescriptor::fromMesh(barPositions, barIndices);
+    ShapeDescriptor turnedBar = ShapeDescriptor::fromMesh(turnedPositions, turnedIndices);
+    ShapeDescriptor plate = ShapeDescriptor::fromMesh(platePositions, plateIndices);
+    QVERIFY(bar.isValid() && turnedBar.isValid() && plate.isValid());
+    QVERIFY(bar.distance(turnedBar) * 4 < bar.distance(plate));
+    QCOMPARE(ShapeDescriptor::fromByteArray(bar.toByteArray()).values(), bar.values());
+
+    // Clustered vectors, as a catalogue holds families of similar parts
+    static const int vectorCount = 20000;
+    static const int dimensions = ShapeDescriptor::DIMENSIONS;
+    QRandomGenerator random(42);
+    QVector<QVector<float>> centres(200);
+    for (QVector<float>& centre : centres) {
+        for (int i = 0; i < dimensions; ++i) {
+            centre.append(static_cast<float>(random.generateDouble()));
+        }
+    }
+
+    QVector<QVector<float>> vectors;
+    for (int v = 0; v < vectorCount; ++v) {
+        QVector<float> vector = centres[v % centres.size()];
+        for (float& value : vector) {
+            value += static_cast<float>(random.generateDouble() - 0.5) * 0.1f;
+        }
+        vectors.append(vector);
+    }
+
+    HnswIndex index(dimensions);
+    QElapsedTimer timer;
+    timer.start();
+    for (int v = 0; v < vectorCount; ++v) {
+        index.add(QString::number(v), vectors[v]);
+    }
+    qint64 buildTime = timer.elapsed();
+
+    // Recall of the 10 nearest against an exhaustive scan
+    static const int queryCount = 200;
+    static const int k = 10;
+    int found = 0;
+    qint64 graphNs = 0;
+    qint64 scanNs = 0;
+    for (int q = 0; q < queryCount; ++q) {
+        const QVector<float>& query = vectors[(q * 97) % vectorCount];
+
+        timer.restart();
+        QList<HnswIndex::Neighbour> neighbours = index.search(query, k);
+        graphNs += timer.nsecsElapsed();
+
+        timer.restart();
+        QVector<QPair<float, int>> distances;
+        distances.reserve(vectorCount);
+        for (int v = 0; v < vectorCount; ++v) {
+            distances.append({ShapeDescriptor::distance(query.constData(), vectors[v].constData()), v});
+        }
+        std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+        scanNs += timer.nsecsElapsed();
+
+        QSet<QString> exact;
+        for (int i = 0; i < k; ++i) {
+            exact.insert(QString::number(distances[i].second));
+        }
+        for (const HnswIndex::Neighbour& neighbour : neighbours) {
+            found += exact.contains(neighbour.key) ? 1 : 0;
+        }
+    }
+    double recall = static_cast<double>(found) / (queryCount * k);
+
+    // Replacing and removing keys keeps lookups consistent
+    index.add("0", vectors[1]);
+    QCOMPARE(index.size(), vectorCount);
+    index.remove("1");
+    QVERIFY(!index.contains("1"));
+    for (const HnswIndex::Neighbour& neighbour : index.search(vectors[1], k)) {
+        QVERIFY(neighbour.key != "1");
+    }
+
+    QByteArray saved;
+    QDataStream out(&saved, QIODevice::WriteOnly);
+    index.save(out);
+    HnswIndex loaded(dimensions);
+    QDataStream in(saved);
+    QVERIFY(loaded.load(in));
+    QCOMPARE(loaded.size(), index.size());
+    QCOMPARE(loaded.search(vectors[5], k).first().key, index.search(vectors[5], k).first().key);
+
+    qInfo() << QString("Shape similarity over %1 vectors: built in %2ms, recall@%3 %4, %5us per query vs %6us scanning")
+               .arg(vectorCount).arg(buildTime).arg(k).arg(recall, 0, 'f', 3)
+               .arg(graphNs / queryCount / 1000).arg(scanNs / queryCount / 1000);
+
+    QVERIFY(recall >= 0.9);
+    QVERIFY(graphNs * 5 < scanNs);
+}
+
+void TestPerformance::benchmarkContentHash()
+{
+    static const int fileSize = 64 * 1024 * 1024;
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString source = dir.filePath("part.stl");
+
+    QFile file(source);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QByteArray block(ContentHash::BLOCK_SIZE, Qt::Uninitialized);
+    QRandomGenerator random(7);
+    for (int written = 0; written < fileSize; written += block.size()) {
+        random.fillRange(reinterpret_cast<quint32*>(block.data()), block.size() / 4);
+        QVERIFY(file.write(block) == block.size());
+    }
+    file.close();
+
+    // Copying hashes the same bytes a plain read would
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray copied = ContentHash::copyFile(source, dir.filePath("stored.stl"));
+    qint64 copyTime = qMax<qint64>(1, timer.elapsed());
+
+    timer.restart();
+    QByteArray read = ContentHash::ofFile(source);
+    qint64 readTime = qMax<qint64>(1, timer.elapsed());
+
+    QVERIFY(!copied.isEmpty());
+    QCOMPARE(copied, read);
+    QCOMPARE(ContentHash::ofFile(dir.filePath("stored.stl")), read);
+    QCOMPARE(QFileInfo(dir.filePath("stored.stl")).size(), qint64(fileSize));
+
+    // A failed copy leaves no partial file behind
+    QVERIFY(ContentHash::copyFile(dir.filePath("missing.stl"), dir.filePath("partial.stl")).isEmpty());
+    QVERIFY(!QFileInfo::exists(dir.filePath("partial.stl")));
+
+    qInfo() << QString("Content hash of %1 MB: copy and hash %2 MB/s, hash only %3 MB/s")
+               .arg(fileSize >> 20).arg((fileSize >> 20) * 1000 / copyTime).arg((fileSize >> 20) * 1000 / readTime);
+}
+
+void TestPerformance::benchmarkNearDuplicateClustering()
+{
+    // A re-export reorders triangles, moves and turns the part and adds float noise
+    QVector<QVector3D> originalPositions, exportedPositions, scaledPositions;
+    QVector<unsigned int> originalIndices, exportedIndices, scaledIndices;
+    QMatrix4x4 moved;
+    moved.translate(40, -3, 12);
+    moved.rotate(90.0f, QVector3D(0, 0, 1));
+    QMatrix4x4 scaled;
+    scaled.scale(1.1f);
+    addBox(originalPositions, originalIndices, QMatrix4x4(), QVector3D(30, 12, 4));
+    addBox(exportedPositions, exportedIndices, moved, QVector3D(30, 12, 4));
+    addBox(scaledPositions, scaledIndices, scaled, QVector3D(30, 12, 4));
+    std::reverse(exportedIndices.begin(), exportedIndices.end());
+    for (QVector3D& position : exportedPositions) {
+        position += QVector3D(1e-5f, -1e-5f, 1e-5f);
+    }
+
+    MeshFingerprint original = MeshFingerprint::fromMesh(originalPositions, originalIndices);
+    MeshFingerprint exported = MeshFingerprint::fromMesh(exportedPositions, exportedIndices);
+    MeshFingerprint larger = MeshFingerprint::fromMesh(scaledPositions, scaledIndices);
+    QVERIFY(original.isValid());
+    QVERIFY(original.matches(exported));
+    QVERIFY(!original.matches(larger));
+    QVERIFY(MeshFingerprint::fromByteArray(original.toByteArray()).matches(original, 1e-6));
+
+    // Thumbnails of one part hash close together whatever their resolution
+    QImage thumbnail(256, 256, QImage::Format_RGB32);
+    for (int y = 0; y < thumbnail.height(); ++y) {
+        for (int x = 0; x < thumbnail.width(); ++x) {
+            thumbnail.setPixel(x, y, qRgb(128 + static_cast<int>(100 * std::sin(x / 20.0)),
+                                          128 + static_cast<int>(100 * std::cos(y / 30.0)), (x + y) / 2));
+        }
+    }
+    quint64 fullHash = DuplicateClusterer::thumbnailHash(thumbnail);
+    quint64 smallHash = DuplicateClusterer::thumbnailHash(thumbnail.scaled(128, 128));
+    QVERIFY(fullHash != 0);
+    QVERIFY(DuplicateClusterer::hammingDistance(fullHash, smallHash) < DuplicateClusterer::THUMBNAIL_BANDS);
+
+    // A catalogue of distinct parts, one in ten with a few re-exported copies;
+    // a tight tolerance keeps chance matches between random sizes rare
+    static const int partCount = 100000;
+    QRandomGenerator random(11);
+    DuplicateClusterer clusterer(0.005);
+    int expectedGroups = 0;
+    for (int part = 0; part < partCount; ++part) {
+        QVector<QVector3D> positions;
+        QVector<unsigned int> indices;
+        QVector3D size(static_cast<float>(10 + random.bounded(500.0)), static_cast<float>(10 + random.bounded(200.0)),
+                       static_cast<float>(1 + random.bounded(50.0)));
+        addBox(positions, indices, QMatrix4x4(), size);
+
+        int copies = part % 10 == 0 ? 3 : 1;
+        expectedGroups += copies > 1 ? 1 : 0;
+        for (int copy = 0; copy < copies; ++copy) {
+            QVector<QVector3D> noisy = positions;
+            for (QVector3D& position : noisy) {
+                position *= 1.0f + static_cast<float>(random.bounded(1e-4));
+            }
+            clusterer.add(QUuid::createUuid(), MeshFingerprint::fromMesh(noisy, indices), 0);
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<QList<QUuid>> clusters = clusterer.clusters();
+    qint64 clusterTime = timer.elapsed();
+
+    // Random sizes can collide by chance, so allow a few unplanned groups
+    QVERIFY(clusters.size() >= expectedGroups);
+    QVERIFY(clusters.size() < expectedGroups * 11 / 10);
+
+    qInfo() << QString("Near-duplicate clustering of %1 models: %2 groups in %3ms")
+               .arg(clusterer.size()).arg(clusters.size()).arg(clusterTime);
+
+    QVERIFY(clusterTime < 5000);
+}
+
+// Test runner
+QTEST_MAIN(TestPerformance)
+#include "test_performance.moc"